@@ -6,6 +6,9 @@
  *    @li 01-15-2008 JRR Original (somewhat useful) file
  *    @li 10-11-2012 JRR Less original, more useful file with FreeRTOS mutex added
  *    @li 10-12-2012 JRR There was a bug in the mutex code, and it has been fixed
+ *    @li 10-17-2026 Added an interrupt-driven background scan of a list of channels
+ *    @li 10-17-2026 Oversampling changed to accumulate-and-shift decimation
+ *    @li 10-17-2026 Debugging messages are logged in binary rather than printed
  *
  *  License:
  *    This file is copyright 2015 by JR Ridgely and released under the Lesser GNU 
@@ -25,9 +28,80 @@
 
 #include <stdlib.h>                         // Include standard library header files
 #include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>                    // Macros for interrupt-safe blocks
 
 #include "rs232int.h"                       // Include header for serial port class
 #include "adc.h"                            // Include header for the A/D class
+#include "log.h"                            // Binary log messages
+
+
+/// This value in @c scan_slot[] means that a channel isn't in the scan list
+#define ADC_NOT_SCANNED     0xFF
+
+/// Prescaler bits for the A/D clock at F_CPU / 32, used for one-shot conversions
+#define ADC_PRESCALE_32     ((1 << ADPS2) | (1 << ADPS0))
+
+/// Prescaler bits for the A/D clock at F_CPU / 128, used for background scans. At
+/// 16 MHz that's a 125 kHz A/D clock, within the 50-200 kHz range needed for a full
+/// 10 bits, and a conversion every 104 us keeps the ISR's share of the CPU small
+#define ADC_PRESCALE_128    ((1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0))
+
+/// The list of channels converted, in order, by a background scan
+static uint8_t scan_channels[ADC_MAX_SCAN];
+
+/// The place in each scan of each of the 8 channels, or ADC_NOT_SCANNED
+static uint8_t scan_slot[8] = { ADC_NOT_SCANNED, ADC_NOT_SCANNED, ADC_NOT_SCANNED,
+	ADC_NOT_SCANNED, ADC_NOT_SCANNED, ADC_NOT_SCANNED, ADC_NOT_SCANNED, ADC_NOT_SCANNED };
+
+/// The number of channels in the scan list, or zero if no scan is running
+static volatile uint8_t scan_length = 0;
+
+/// The place in the scan list of the conversion which is in progress
+static volatile uint8_t scan_index = 0;
+
+/// Two buffers of results. The ISR fills one while tasks read the other
+static volatile uint16_t scan_buffer[2][ADC_MAX_SCAN];
+
+/// Which of the two buffers holds the most recent complete scan
+static volatile uint8_t scan_ready = 0;
+
+/// The number of complete scans, so a task can tell whether it has new data
+static volatile uint16_t scans_done = 0;
+
+/// The number of samples of each channel the scan adds up for decimation, 4^3 = 64
+#define ADC_DECIMATE_SAMPLES (1 << (2 * ADC_MAX_EXTRA_BITS))
+
+/// Running sums of each scanned channel's readings; 64 10-bit readings fit in 16 bits
+static uint16_t dec_sum[ADC_MAX_SCAN];
+
+/// The latest complete sum of 64 readings for each scanned channel
+static volatile uint16_t dec_result[ADC_MAX_SCAN];
+
+/// How many passes through the scan list have been added into the running sums
+static uint8_t dec_passes = 0;
+
+/// This is true once the first set of sums has been latched into @c dec_result[]
+static volatile bool dec_valid = false;
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This function does one conversion and waits for it to finish.
+ *  @details It's used by @c adc::read_once() for channels which aren't being scanned.
+ *           The caller must make sure a background scan isn't using the A/D.
+ *  @param   ch The channel to read, from 0 to 7
+ *  @return  The result of the A/D conversion
+ */
+
+static uint16_t convert_and_wait (uint8_t ch)
+{
+	ADMUX = (ADMUX & ~(7 << MUX0)) | (ch << MUX0);  // Sets MUX registers to channel
+	ADCSRA |= 1 << ADSC;                    // Begin conversion
+	while (ADCSRA & (1 << ADSC))            // Wait until ADSC is zero
+	{
+	}
+	return ADCW;                            // Reads ADCL, then ADCH, in that order
+}
 
 
 //-------------------------------------------------------------------------------------
@@ -46,8 +120,8 @@ adc::adc (emstream* p_serial_port)
 	ADCSRA |= ((1<<ADEN)|(1<<ADSC)|(1<<ADPS2)|(1<<ADPS0)); // ADC enable, start convertion and set prescaler to 32
 	
 	
-	// Print a handy debugging message
-	DBG (ptr_to_serial, "A/D constructor OK" << endl);
+	// Log a handy debugging message
+	LOG_INFO ("A/D constructor OK");
 }
 
 
@@ -59,62 +133,254 @@ adc::adc (emstream* p_serial_port)
 
 uint16_t adc::read_once (uint8_t ch)
 {
-	uint8_t ADSC_Check = 0;  // Initialize variable to check conversion completion
-	uint16_t ADC_out = 0;  // Initalize result
-	
+	uint16_t ADC_out;                       // Holds the result
+
 	if (ch > 7)  // Saturate ch at 7
 	{
 	  ch=7;
 	}
-	ADMUX &= ~(7<<MUX0);
-	ADMUX |= ch<<MUX0;  // Sets MUX registers to proper channel
-	ADCSRA |= 1<<ADSC;  // Begin conversion
-	ADSC_Check = (ADCSRA & 1<<ADSC);    // Set value of variable to check conversion completion
-	while (ADCSRA & 1<<ADSC) // Wait until ADSC is zero
+
+	// With no scan running, just do a conversion and wait for it
+	if (scan_length == 0)
 	{
+		return convert_and_wait (ch);
 	}
-	ADC_out = ((uint16_t) ADCL | (uint16_t) ADCH<<8);  // Concatenate Low and High bytes of ADC results
+
+	// If the channel is being scanned, the latest result is waiting in the buffer.
+	// Interrupts are held off just long enough to read both bytes of it
+	uint8_t slot = scan_slot[ch];
+	if (slot != ADC_NOT_SCANNED)
+	{
+		ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+		{
+			ADC_out = scan_buffer[scan_ready][slot];
+		}
+		return ADC_out;
+	}
+
+	// The channel isn't in the scan list, so pause the scan for one conversion. Once
+	// the interrupt is off, wait for the scan's conversion to finish; then clear its
+	// flag so the ISR won't run on our result when the scan resumes
+	ADCSRA &= ~(1 << ADIE);
+	while (ADCSRA & (1 << ADSC))
+	{
+	}
+	ADC_out = convert_and_wait (ch);
+	ADCSRA |= (1 << ADIF);
+
+	// Restart the scan from the channel whose conversion was interrupted
+	ADMUX = (ADMUX & ~(7 << MUX0)) | (scan_channels[scan_index] << MUX0);
+	ADCSRA |= (1 << ADIE) | (1 << ADSC);
+
 	return ADC_out;
 }
 
 
 //-------------------------------------------------------------------------------------
-/** @brief   This method does @b NOTHING because it hasn't been written yet.
- *  \details Nothing, nothing, nothing!
- *  @param   bacon
- *  @param   waffles
- *  @return  Is it Tuesday yet? (Answer: a Boolean value.)
+/** @brief   This method reads a channel with extra resolution by oversampling.
+ *  @details The sum of 4^n readings is shifted right by n bits, which gives a result
+ *           with n more bits than a single reading, 10 + n bits in all, as long as
+ *           there's a bit or so of noise on the signal to dither it. When the channel
+ *           is part of a background scan, the ISR keeps a running sum of 64 readings
+ *           of each scanned channel and this method just scales the latest sum, so it
+ *           takes the same few microseconds every time. Otherwise the method does
+ *           exactly 4^n conversions of 13 A/D clocks each and waits for them all.
+ *  @param   channel The A/D channel which is being read, from 0 to 7
+ *  @param   extra_bits The number of extra bits of resolution wanted, from 0 to
+ *           ADC_MAX_EXTRA_BITS; larger numbers are treated as ADC_MAX_EXTRA_BITS
+ *  @return  The oversampled reading, from 0 to 2^(10 + extra_bits) - 1
  */
 
-uint16_t adc::read_oversampled (uint8_t channel, uint8_t samples)
+uint16_t adc::read_oversampled (uint8_t channel, uint8_t extra_bits)
 {
-    static uint16_t average_result = 0;  // Initialize the value to be returned
-    uint16_t ro_result;  // Initialize the result of calling read_once
-    
-    if(samples >= 64) // Saturate the amount of samples that can be taken at 255
-    {
-      samples = 64;  // 255 is the greatest amount of the highest 8-bit number can fit into a 16-bit number
-    }
-    for(uint8_t i=0; i <= samples; i++)  // Average as many times as there are samples
-    {
-	ro_result = read_once(channel);  // Read once
-	
-	if(average_result == 0)  //  Do not divide the first sample by 2
+	uint16_t sum = 0;                       // Sum of all the readings
+
+	if (extra_bits > ADC_MAX_EXTRA_BITS)
+	{
+		extra_bits = ADC_MAX_EXTRA_BITS;
+	}
+	if (channel > 7)
+	{
+		channel = 7;
+	}
+
+	// If the scan is summing this channel already, scale its sum of 64 readings.
+	// Until the first sum is ready, scale up the latest single reading instead
+	uint8_t slot = scan_slot[channel];
+	if (scan_length != 0 && slot != ADC_NOT_SCANNED)
+	{
+		if (!dec_valid)
+		{
+			return (read_once (channel) << extra_bits);
+		}
+		ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+		{
+			sum = dec_result[slot];
+		}
+		return (sum >> (2 * ADC_MAX_EXTRA_BITS - extra_bits));
+	}
+
+	// Otherwise take 4^n readings, add them up and shift the sum right n bits
+	for (uint8_t count = (1 << (2 * extra_bits)); count > 0; count--)
+	{
+		sum += read_once (channel);
+	}
+	return (sum >> extra_bits);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method starts a background scan of a list of channels.
+ *  @details Each time a conversion finishes, the A/D complete interrupt saves the
+ *           result and starts a conversion of the next channel in the list; after the
+ *           last channel it starts over at the first. Results go into one of two
+ *           buffers; when a scan is complete the buffers are swapped, so tasks always
+ *           read a whole scan's worth of data from the same pass through the list.
+ *           If a scan is already running it's stopped and replaced by the new one.
+ *  @param   p_channels An array of channel numbers, each from 0 to 7
+ *  @param   num_channels How many channels are in the array, up to ADC_MAX_SCAN
+ */
+
+void adc::start_scan (const uint8_t* p_channels, uint8_t num_channels)
+{
+	stop_scan ();
+
+	if (num_channels > ADC_MAX_SCAN)
+	{
+		num_channels = ADC_MAX_SCAN;
+	}
+	if (num_channels == 0)
+	{
+		return;
+	}
+
+	// Build the list of channels and the table which finds each channel's results
+	for (uint8_t index = 0; index < num_channels; index++)
+	{
+		uint8_t ch = p_channels[index] & 0x07;
+		scan_channels[index] = ch;
+		scan_slot[ch] = index;
+		scan_buffer[0][index] = 0;
+		scan_buffer[1][index] = 0;
+		dec_sum[index] = 0;
+	}
+	dec_passes = 0;
+	dec_valid = false;
+
+	// Start the first conversion with the interrupt turned on; the ISR does the rest
+	scan_index = 0;
+	scan_ready = 0;
+	ADMUX = (ADMUX & ~(7 << MUX0)) | (scan_channels[0] << MUX0);
+	ADCSRA = (ADCSRA & ~ADC_PRESCALE_128) | ADC_PRESCALE_128 | (1 << ADIF);
+	scan_length = num_channels;
+	ADCSRA |= (1 << ADIE) | (1 << ADSC);
+
+	LOG_INFO ("A/D scanning %u channels", num_channels);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method stops a background scan.
+ *  @details The interrupt is turned off and any conversion in progress is allowed to
+ *           finish, so that the A/D is ready for @c read_once() to use directly.
+ */
+
+void adc::stop_scan (void)
+{
+	ADCSRA &= ~(1 << ADIE);
+	while (ADCSRA & (1 << ADSC))
+	{
+	}
+	ADCSRA = (ADCSRA & ~ADC_PRESCALE_128) | ADC_PRESCALE_32 | (1 << ADIF);
+
+	scan_length = 0;
+	for (uint8_t ch = 0; ch < 8; ch++)
+	{
+		scan_slot[ch] = ADC_NOT_SCANNED;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method tells whether a background scan is running.
+ *  @return  True if the A/D is scanning, false if not
+ */
+
+bool adc::is_scanning (void)
+{
+	return (scan_length != 0);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method copies the results of the latest complete scan.
+ *  @details The results are in the same order as the channels in the list given to
+ *           @c start_scan(). The copy is made with interrupts off; it takes only a
+ *           couple of microseconds even for a full list of channels.
+ *  @param   p_dest An array with room for one result for each channel in the scan
+ *  @return  The number of scans which have been completed, modulo 65536. A task can
+ *           compare this with the previous value to see whether there's new data
+ */
+
+uint16_t adc::read_scan (uint16_t* p_dest)
+{
+	uint16_t count;
+
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
 	{
-	  average_result = ro_result;
+		uint8_t ready = scan_ready;
+		for (uint8_t index = 0; index < scan_length; index++)
+		{
+			p_dest[index] = scan_buffer[ready][index];
+		}
+		count = scans_done;
 	}
-	else  // Average the previous average with the new sample
+	return count;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This ISR runs the background scan each time a conversion is complete.
+ *  @details It saves the result in the buffer which isn't being read, adds it to the
+ *           channel's running sum for decimation, points the multiplexer at the next
+ *           channel in the list and starts its conversion. At the end of the list the
+ *           buffers are swapped. Conversions are started one
+ *           at a time rather than in free running mode so that each result is sure to
+ *           belong to the channel which was selected when it started.
+ */
+
+ISR (ADC_vect)
+{
+	uint8_t index = scan_index;
+	uint8_t filling = scan_ready ^ 0x01;
+
+	uint16_t result = ADCW;
+
+	scan_buffer[filling][index] = result;
+	dec_sum[index] += result;
+
+	if (++index >= scan_length)
 	{
-	  average_result = (average_result + ro_result) / 2;
+		index = 0;
+		scan_ready = filling;
+		scans_done++;
+
+		// After 64 passes, latch the sums for read_oversampled() and start new ones
+		if (++dec_passes >= ADC_DECIMATE_SAMPLES)
+		{
+			for (uint8_t slot = 0; slot < scan_length; slot++)
+			{
+				dec_result[slot] = dec_sum[slot];
+				dec_sum[slot] = 0;
+			}
+			dec_passes = 0;
+			dec_valid = true;
+		}
 	}
-    }
+	scan_index = index;
 
-    return average_result;
-	/*
-	DBG (ptr_to_serial, "All your readings are belong to us" << endl);
-	*ptr_to_serial << "MY MESSAGE" << endl;
-	return (0xFFFF);
-	*/
+	ADMUX = (ADMUX & ~(7 << MUX0)) | (scan_channels[index] << MUX0);
+	ADCSRA |= (1 << ADSC);
 }
 
 
@@ -136,8 +402,8 @@ emstream& operator << (emstream& serpt, adc& a2d)
 	serpt << PMS ("The A/D Converter Values")<<endl 
 	      << PMS ("ADMUX value: ")<< bin << ADMUX << dec << endl
 	      << PMS ("ADCSRA value: ")<< bin<< ADCSRA << dec << endl
-	      << PMS ("Average result channel 0: ")<< a2d.read_oversampled (0, 10) << endl
-	      << PMS ("Average result channel 1: ")<< a2d.read_oversampled (1, 10) << endl;
+	      << PMS ("12-bit result channel 0: ")<< a2d.read_oversampled (0, 2) << endl
+	      << PMS ("12-bit result channel 1: ")<< a2d.read_oversampled (1, 2) << endl;
 	
 	
 	return (serpt);
@@ -9,6 +9,8 @@
  *    @li 01-15-2008 JRR Original (somewhat useful) file
  *    @li 10-11-2012 JRR Less original, more useful file with FreeRTOS mutex added
  *    @li 10-12-2012 JRR There was a bug in the mutex code, and it has been fixed
+ *    @li 10-17-2026 Added an interrupt-driven background scan of a list of channels
+ *    @li 10-17-2026 Oversampling changed to accumulate-and-shift decimation
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU 
@@ -37,10 +39,21 @@
 #include "semphr.h"                         // Header for FreeRTOS semaphores
 
 
+/// The largest number of channels which can be in the list for a background scan
+#define ADC_MAX_SCAN        8
+
+/// The most extra bits of resolution @c read_oversampled() can give. Each extra bit
+/// takes four times as many samples; 3 bits means 64 samples and a 13-bit result,
+/// which is as many as will fit in a 16-bit sum of 10-bit readings
+#define ADC_MAX_EXTRA_BITS  3
+
 //-------------------------------------------------------------------------------------
-/** @brief   This class @b will run the A/D converter on an AVR processor. 
- *  @details It should have some better comments. Yes, this is a @b subtle @b hint...
- *           @b Please @b fix @b these @b comments @b before @b turning @b this @b in!
+/** @brief   This class runs the A/D converter on an AVR processor. 
+ *  @details Conversions can be done one at a time, with the calling task waiting for
+ *           each to finish, or the A/D can run a background scan of a list of
+ *           channels, driven by its conversion complete interrupt. During a scan,
+ *           @c read_once() returns the most recent result for a scanned channel
+ *           straight from a buffer, so no task ever waits on the hardware.
  */
 
 class adc
@@ -60,10 +73,20 @@ class adc
 		// integer; it should be called from within a normal task, not an ISR
         uint16_t read_once (uint8_t);
 
-		// This function reads the A/D lots of times and returns the average. Doing so
-		// implements a crude sort of low-pass filtering that can help reduce noise
+		// This function adds up 4^n readings and shifts the sum right by n bits,
+		// giving a result with n more bits of resolution than one reading
 		uint16_t read_oversampled (uint8_t, uint8_t);
 
+		// These functions start and stop a background scan, in which the A/D's
+		// interrupt converts each channel in a list over and over. While a scan is
+		// running, read_once() returns the latest result without waiting
+		void start_scan (const uint8_t*, uint8_t);
+		void stop_scan (void);
+		bool is_scanning (void);
+
+		// This function copies the most recent complete scan into an array
+		uint16_t read_scan (uint16_t*);
+
 }; // end of class adc
 
 
@@ -0,0 +1,278 @@
+//*************************************************************************************
+/** @file axis.cpp
+ *    This file contains the table of the axes' hardware and the control step which
+ *    the motor task runs for each axis.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Potentiometer mode is converted here rather than in the task
+ *    @li 10-17-2026 Gains and the potentiometer's scaling come from the parameters
+ *    @li 10-17-2026 Axes stage their motors' changes in the Motor_group
+ *    @li 10-17-2026 Added the relay autotuning mode
+ *    @li 10-17-2026 Added the system identification mode
+ *
+ */
+//*************************************************************************************
+
+#include <stdlib.h>                         // Include standard library header files
+
+#include "axis.h"                           // Include header for the axes
+
+
+/** The hardware of each axis. Motor 1 is measured by encoder 0 and motor 2 by
+ *  encoder 1. The table must have @c NUM_AXES lines, or it won't match its
+ *  declaration and won't compile.
+ */
+
+const axis_hardware axis_table[] =
+{
+	{ "Axis a", "Encoder Count", motor_1::init, motor_1::stage_power,
+	  motor_1::stage_brake, 0 },
+	{ "Axis b", "Encoder Count 2", motor_2::init, motor_2::stage_power,
+	  motor_2::stage_brake, 1 }
+};
+
+
+//-------------------------------------------------------------------------------------
+/** This constructor makes an axis which has no hardware yet; @c init() must be called
+ *  before the axis is used. The controller's gains are all zero until then.
+ */
+
+Axis::Axis (void)
+	: pid (0, 0, 0)
+{
+	p_hardware = NULL;
+	position_gains.k_p = position_gains.k_i = position_gains.k_d = 0;
+	velocity_gains = position_gains;
+	last_mode = AXIS_POT;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method gives the axis its hardware and gains, and sets up the motor's pins.
+ *  @param p_hw A pointer to the axis's line in @c axis_table
+ *  @param position The gains for position control
+ *  @param velocity The gains for velocity control
+ */
+
+void Axis::init (const axis_hardware* p_hw, const pid_gains& position,
+                 const pid_gains& velocity)
+{
+	p_hardware = p_hw;
+	position_gains = position;
+	velocity_gains = velocity;
+	p_hardware->init ();
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method changes the axis's gains. If the axis is under closed-loop control,
+ *  the controller's gains are changed at once, without resetting it, so gains can be
+ *  tuned while the motor runs; otherwise they're used when control next starts.
+ *  @param position The gains for position control
+ *  @param velocity The gains for velocity control
+ */
+
+void Axis::set_gains (const pid_gains& position, const pid_gains& velocity)
+{
+	position_gains = position;
+	velocity_gains = velocity;
+	if (last_mode == AXIS_POSITION)
+	{
+		pid.set_gains (position_gains.k_p, position_gains.k_i, position_gains.k_d);
+	}
+	else if (last_mode == AXIS_VELOCITY)
+	{
+		pid.set_gains (velocity_gains.k_p, velocity_gains.k_i, velocity_gains.k_d);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method works out what the axis's motor should do.
+ *  @details It uses only the command, the encoder reading and the controller, so it
+ *           can be run away from the hardware. The modes are:
+ *           \li @c AXIS_POWER: the power in the command
+ *           \li @c AXIS_BRAKE: brake, as hard as the power in the command
+ *           \li @c AXIS_POSITION: closed-loop control to a setpoint in encoder counts
+ *           \li @c AXIS_VELOCITY: closed-loop control to a setpoint in encoder counts
+ *               per second
+ *           \li @c AXIS_AUTOTUNE: a relay experiment around the position at which
+ *               the mode was entered, with the command's power as the relay's (see
+ *               relay_tune.h); the motor is left unpowered when it's over
+ *           \li @c AXIS_SYSID: a PRBS or chirp of the command's size, as the
+ *               @c sysid_* parameters say, recorded for a model (see sysid.h); the
+ *               motor is left unpowered when the buffer is full
+ *
+ *           The motor task turns @c AXIS_POT into one of the first two with
+ *           @c axis_pot_command() before calling this method, since the
+ *           potentiometer is shared by all the axes.
+ *  @param   command What the user has asked the axis to do
+ *  @param   reading The position and velocity found by the axis's encoder this run
+ *  @return  The power to give the motor, and whether to brake it
+ */
+
+axis_output Axis::step (const axis_command& command, const enc_reading& reading)
+{
+	// When closed-loop control starts, load the gains for the kind of control and
+	// start the controller from the present measurement
+	if (command.mode != last_mode)
+	{
+		if (command.mode == AXIS_POSITION)
+		{
+			pid.set_gains (position_gains.k_p, position_gains.k_i, position_gains.k_d);
+			pid.reset (reading.position);
+		}
+		else if (command.mode == AXIS_VELOCITY)
+		{
+			pid.set_gains (velocity_gains.k_p, velocity_gains.k_i, velocity_gains.k_d);
+			pid.reset (reading.velocity);
+		}
+		else if (command.mode == AXIS_AUTOTUNE)
+		{
+			tuner.begin (reading.position, command.power);
+		}
+		else if (command.mode == AXIS_SYSID)
+		{
+			sysid_setup setup;
+			axis_param_sysid (setup);
+			sysid.begin (reading.position, command.power, setup);
+		}
+
+		// An experiment which is left before it's finished lets go of the buffer
+		if (last_mode == AXIS_SYSID)
+		{
+			sysid.stop ();
+		}
+		last_mode = command.mode;
+	}
+
+	axis_output output;
+	output.brake = false;
+	switch (command.mode)
+	{
+		case (AXIS_BRAKE):
+			output.power = command.power;
+			output.brake = true;
+			break;
+		case (AXIS_POSITION):
+			output.power = pid.update (command.setpoint, reading.position);
+			break;
+		case (AXIS_VELOCITY):
+			output.power = pid.update (command.setpoint, reading.velocity);
+			break;
+		case (AXIS_AUTOTUNE):
+			output.power = tuner.step (reading.position);
+			break;
+		case (AXIS_SYSID):
+			output.power = sysid.step (reading.position);
+			break;
+		default:
+			output.power = command.power;
+			break;
+	}
+
+	return output;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function turns a command in @c AXIS_POT mode into the one the potentiometer
+ *  asks for. The reading is measured from the middle of the knob's travel in steps
+ *  of @c pot_divisor A/D counts; within @c pot_deadband steps of the middle the
+ *  motor is braked, and outside it the power is @c pot_gain times the steps beyond
+ *  the dead band's upper edge. Commands in the other modes are returned as they are.
+ *  It's used by the motor task and by the replay program in @c host/replay.cpp, so
+ *  both turn the knob into power the same way.
+ *  @param command What the user has asked the axis to do
+ *  @param pot_reading The potentiometer's A/D reading, from 0 to 1023
+ *  @return The command with its mode set to @c AXIS_POWER or @c AXIS_BRAKE
+ */
+
+axis_command axis_pot_command (const axis_command& command, uint16_t pot_reading)
+{
+	axis_command result = command;
+	if (command.mode == AXIS_POT)
+	{
+		int16_t deadband = (int16_t)param_get (PARAM_POT_DEADBAND);
+		int16_t motor_read = ((int16_t)pot_reading - 512)
+		                     / (int16_t)param_get (PARAM_POT_DIVISOR);
+		result.mode = (motor_read > deadband || motor_read < -deadband)
+		              ? AXIS_POWER : AXIS_BRAKE;
+		result.power = (motor_read - deadband) * (int16_t)param_get (PARAM_POT_GAIN);
+	}
+	return result;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function gets the position and velocity control gains from the parameters.
+ *  @param position The place to put the gains for position control
+ *  @param velocity The place to put the gains for velocity control
+ */
+
+void axis_param_gains (pid_gains& position, pid_gains& velocity)
+{
+	position.k_p = (int16_t)param_get (PARAM_POS_KP);
+	position.k_i = (int16_t)param_get (PARAM_POS_KI);
+	position.k_d = (int16_t)param_get (PARAM_POS_KD);
+	velocity.k_p = (int16_t)param_get (PARAM_VEL_KP);
+	velocity.k_i = (int16_t)param_get (PARAM_VEL_KI);
+	velocity.k_d = (int16_t)param_get (PARAM_VEL_KD);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function gets the system identification experiment's settings from the
+ *  parameters. The chirp's frequencies are worked out from @c loop_hz, which is the
+ *  loop's rate as long as it hasn't been changed since the AVR was reset.
+ *  @param setup The place to put the settings
+ */
+
+void axis_param_sysid (sysid_setup& setup)
+{
+	setup.signal = (uint8_t)param_get (PARAM_SYSID_SIGNAL);
+	setup.offset = (int16_t)param_get (PARAM_SYSID_OFFSET);
+	setup.hold = (uint8_t)param_get (PARAM_SYSID_HOLD);
+	setup.every = (uint8_t)param_get (PARAM_SYSID_EVERY);
+	setup.chirp_hz = (uint16_t)param_get (PARAM_SYSID_CHIRP_HZ);
+	setup.loop_hz = (uint16_t)param_get (PARAM_LOOP_HZ);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method stages the motor's power or braking, as a step has decided, in the
+ *  @c Motor_group. The motor doesn't change until @c Motor_group::commit() is called,
+ *  which is done once all the axes have been driven.
+ *  @param output The power and whether to brake, from @c step()
+ */
+
+void Axis::drive (const axis_output& output)
+{
+	if (output.brake)
+	{
+		p_hardware->stage_brake (output.power);
+	}
+	else
+	{
+		p_hardware->stage_power (output.power);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This operator prints an axis command on one line, so the axes' command shares can
+ *  be shown in the list of shares.
+ *  @param serpt Reference to a serial port to which the printout will be printed
+ *  @param command Reference to the command which is being printed
+ *  @return A reference to the same serial device on which we write information.
+ *          This is used to string together things to write with @c << operators
+ */
+
+emstream& operator << (emstream& serpt, const axis_command& command)
+{
+	serpt << PMS ("mode ") << command.mode << PMS (" pwr ") << command.power
+	      << PMS (" set ") << command.setpoint;
+
+	return (serpt);
+}
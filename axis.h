@@ -0,0 +1,202 @@
+//======================================================================================
+/** @file axis.h
+ *    This file contains the header for the axes which the motor task controls. An
+ *    axis is a motor, the encoder which measures it, and the controller which drives
+ *    it. The axes are numbered from zero, and everything which is done to a motor is
+ *    done in a loop over the axes, so another motor can be added by raising
+ *    @c NUM_AXES and @c TELEM_AXES and adding a line to @c axis_table in axis.cpp.
+ *    There can be at most three, as every motor's PWM comes from Timer 1.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 The potentiometer's command is worked out here, for the replay
+ *    @li 10-17-2026 Gains and the potentiometer's scaling come from the parameters
+ *    @li 10-17-2026 Motors are changed through the Motor_group, all at one PWM edge
+ *    @li 10-17-2026 Added the relay autotuning mode
+ *    @li 10-17-2026 Added the system identification mode
+ *    @li 10-17-2026 The telemetry packets carry all the axes
+ *    @li 10-17-2026 Says there can be at most three axes, one per Timer 1 output
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//======================================================================================
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _AXIS_H_
+#define _AXIS_H_
+
+#include <stdint.h>                         // Fixed-size integer types
+
+#include "emstream.h"                       // Header for serial ports and devices
+#include "motor_dr.h"                       // Header for the motor drivers
+#include "encoder_dr.h"                     // Header for the encoder driver
+#include "pid.h"                            // Header for the PID controller
+#include "params.h"                         // Header for the changeable parameters
+#include "relay_tune.h"                     // Header for the relay autotuner
+#include "sysid.h"                          // Header for system identification
+
+
+/// The number of axes. Each needs a line in @c axis_table and an encoder, and the
+/// telemetry packets carry @c TELEM_AXES axes, which must be the same number
+#define NUM_AXES            2
+
+#if (NUM_AXES > ENC_NUM_ENCODERS)
+	#error Each axis needs an encoder; raise ENC_NUM_ENCODERS and add its ISR
+#endif
+
+// The Motor_group only drives Timer 1, which has three PWM outputs, so there can't
+// be more than three axes unless another timer is given a group of its own
+#if (NUM_AXES > MOTOR_GROUP_SIZE)
+	#error Every axis is changed through the Timer 1 Motor_group, which has 3 outputs
+#endif
+
+
+/// Motor 1 uses PORTC for INA, INB and DIAGA/B, and PB6 (OC1B) for its PWM
+typedef Motor_driver_fixed<motor_port_C, PC0, motor_port_C, PC2,
+                           motor_port_B, PB6, motor_ocr_1B> motor_1;
+
+/// Motor 2 uses PORTD for INA, INB and DIAGA/B, and PB5 (OC1A) for its PWM
+typedef Motor_driver_fixed<motor_port_D, PD5, motor_port_D, PD7,
+                           motor_port_B, PB5, motor_ocr_1A> motor_2;
+
+
+/// The ways in which an axis can be run. The numbers are the ones the user interface
+/// has always used for the motor states
+enum axis_mode
+{
+	AXIS_POT = 0,                           ///< Power from the potentiometer
+	AXIS_POWER = 1,                         ///< Power set by the user
+	AXIS_BRAKE = 2,                         ///< Brake
+	AXIS_POSITION = 3,                      ///< Closed-loop control of position
+	AXIS_VELOCITY = 4,                      ///< Closed-loop control of velocity
+	AXIS_AUTOTUNE = 5,                      ///< Relay experiment to find position gains
+	AXIS_SYSID = 6                          ///< PRBS or chirp recorded for a model
+};
+
+
+/** @brief   This structure holds the things about an axis's hardware which are fixed
+ *           when the program is built.
+ *  @details The motor's functions are those of a @c Motor_driver_fixed, whose pins are
+ *           template parameters, so each axis's functions are compiled for its own
+ *           pins and the loop over the axes calls them through this table.
+ */
+
+struct axis_hardware
+{
+	const char* name;                       ///< Name of the axis's command share
+	const char* count_name;                 ///< Name of its encoder count share
+	void (*init) (void);                    ///< Sets up the motor's pins
+	void (*stage_power) (int16_t);          ///< Stages the motor's power
+	void (*stage_brake) (int16_t);          ///< Stages braking the motor
+	uint8_t encoder;                        ///< Number of the encoder on the motor
+};
+
+// The hardware of each axis, in order of axis number
+extern const axis_hardware axis_table[NUM_AXES];
+
+
+/** @brief   This structure holds what the user has asked an axis to do. The user
+ *           interface task puts it in the axis's share and the motor task reads it
+ *           each run, so the mode, power and setpoint are always seen together.
+ */
+
+struct axis_command
+{
+	uint8_t mode;                           ///< One of the @c axis_mode values
+	int16_t power;                          ///< Power, or braking strength when braking
+	int32_t setpoint;                       ///< Counts, or counts per second
+};
+
+// This operator prints an axis command on one line
+emstream& operator << (emstream&, const axis_command&);
+
+// Turn a command in potentiometer mode into a power or a brake command
+axis_command axis_pot_command (const axis_command& command, uint16_t pot_reading);
+
+// Get the position and velocity control gains from the parameters
+void axis_param_gains (pid_gains& position, pid_gains& velocity);
+
+// Get the system identification experiment's settings from the parameters
+void axis_param_sysid (sysid_setup& setup);
+
+
+/** @brief   This structure holds what one step of an axis's control decided to do
+ *           to the motor.
+ */
+
+struct axis_output
+{
+	int16_t power;                          ///< Power, or braking strength when braking
+	bool brake;                             ///< True if the motor is to be braked
+};
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This class controls one motor from its encoder.
+ *  @details Each run of the control loop, the motor task samples the axis's encoder,
+ *           calls @c step() to work out what the motor should do, and then calls
+ *           @c drive() to stage it; once every axis is staged,
+ *           @c Motor_group::commit() changes all the motors at the same PWM edge.
+ *           @c step() doesn't touch any hardware, so the same code can be run on a
+ *           PC with recorded encoder readings. When the mode changes to position or
+ *           velocity control, the controller is given the gains for that kind of
+ *           control and started from the present measurement.
+ *
+ *           The axes are kept in a fixed array in the motor task, so they're made
+ *           with the default constructor and given their hardware by @c init().
+ */
+
+class Axis
+{
+protected:
+	/// The axis's motor and encoder
+	const axis_hardware* p_hardware;
+
+	/// The controller which runs the motor in the closed-loop modes
+	PID pid;
+
+	/// The gains used for position and for velocity control
+	pid_gains position_gains;
+	pid_gains velocity_gains;
+
+	/// The mode at the last step, so a change to closed-loop control can be seen
+	uint8_t last_mode;
+
+	/// The relay experiment which is run in @c AXIS_AUTOTUNE mode
+	Relay_tune tuner;
+
+	/// The system identification experiment which is run in @c AXIS_SYSID mode
+	Sysid sysid;
+
+public:
+	// The constructor makes an axis which has no hardware yet
+	Axis (void);
+
+	// Give the axis its hardware and gains and set up its motor
+	void init (const axis_hardware* p_hw, const pid_gains& position,
+	           const pid_gains& velocity);
+
+	// Change the gains, including those of the controller if it's running
+	void set_gains (const pid_gains& position, const pid_gains& velocity);
+
+	// Work out what the motor should do, without touching the hardware
+	axis_output step (const axis_command& command, const enc_reading& reading);
+
+	// Stage the motor's power or braking, to be made by Motor_group::commit()
+	void drive (const axis_output& output);
+
+	/// Find the position and velocity of the axis's encoder
+	enc_reading sample (void) { return Encoder_dr::sample (p_hardware->encoder); }
+
+	/// Get the axis's controller, so its state can be looked at or its gains changed
+	PID& get_pid (void) { return pid; }
+
+	/// Get the axis's autotuner, to see what its experiment has found
+	Relay_tune& get_tuner (void) { return tuner; }
+
+	/// Get the axis's system identification experiment, to see whether it's over
+	Sysid& get_sysid (void) { return sysid; }
+};
+
+#endif // _AXIS_H_
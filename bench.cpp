@@ -0,0 +1,294 @@
+//*************************************************************************************
+/** @file bench.cpp
+ *    This file contains the main() code for a benchmark program which measures how
+ *    many CPU cycles the drivers and shared data items in this project take. It's
+ *    built and run under the simavr simulator with @c make @c bench; simavr counts
+ *    cycles exactly as an ATmega1281 at 16 MHz would, so the numbers can be compared
+ *    from one build to the next to catch timing regressions before flashing.
+ *
+ *    Each kernel is timed with timer/counter 4 running at the full CPU clock. The
+ *    cost of reading the timer is measured first and subtracted. Interrupt service
+ *    routines are timed from the moment interrupts are enabled with one pending until
+ *    the ISR has returned, so those numbers include the interrupt response time and
+ *    the @c reti. The results are printed on simavr's console, one line per kernel.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Added the PID controller update
+ *    @li 10-17-2026 Added sequence-locked share access
+ *    @li 10-17-2026 Added the fixed-pin motor driver template
+ *    @li 10-17-2026 Added fixed-point sine and the odometry update
+ *    @li 10-17-2026 The PID is timed with task_motor.h's default position gains
+ *    @li 10-17-2026 The text queue is emptied before each run instead of filling up
+ *    @li 10-17-2026 Added the control step of both axes, as the motor task runs it
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#include <stdlib.h>                         // Prototype declarations for I/O functions
+#include <avr/io.h>                         // Port I/O for SFR's
+#include <avr/interrupt.h>                  // Interrupt enable and disable
+#include <avr/sleep.h>                      // Sleeping is how a program exits simavr
+
+#include "FreeRTOS.h"                       // Primary header for FreeRTOS
+#include "task.h"                           // Header for FreeRTOS task functions
+#include "queue.h"                          // FreeRTOS inter-task communication queues
+
+#include "emstream.h"                       // Base class for serial devices
+#include "textqueue.h"                      // Wrapper for FreeRTOS character queues
+#include "taskshare.h"                      // Header for thread-safe shared data
+#include "seqshare.h"                       // Header for sequence-locked shares
+#include "adc.h"                            // Header for the A/D converter driver
+#include "motor_dr.h"                       // Header for the motor driver
+#include "encoder_dr.h"                     // Header for the encoder driver
+#include "pid.h"                            // Header for the PID controller
+#include "task_motor.h"                     // For the motors' fixed-pin drivers
+#include "odometry.h"                       // Header for the odometry class
+
+#include "avr/avr_mcu_section.h"            // simavr's firmware description macros
+
+
+// Tell simavr which processor this is and how fast it runs, and have it print any
+// characters written to GPIOR0 on its console
+AVR_MCU (F_CPU, "atmega1281");
+AVR_MCU_SIMAVR_CONSOLE (&GPIOR0);
+
+
+/// The number of times each kernel is run; the best, average and worst are printed
+#define BENCH_RUNS          32
+
+
+//-------------------------------------------------------------------------------------
+/** This class sends characters to simavr's console by writing them to GPIOR0.
+ */
+
+class sim_console : public emstream
+{
+public:
+	/** This method writes one character to the simulator's console.
+	 *  @param a_char The character to be written
+	 *  @return Always true, because the console is never busy
+	 */
+	bool putchar (char a_char)
+	{
+		GPIOR0 = a_char;
+		return true;
+	}
+};
+
+
+//-------------------------------------------------------------------------------------
+/** This class is a serial device which throws its characters away, so that the time
+ *  taken to format numbers can be measured without the time taken to send them.
+ */
+
+class null_device : public emstream
+{
+public:
+	/// The number of characters which have been "sent," to keep the work honest
+	uint16_t count;
+
+	null_device (void) : count (0) { }
+
+	/** This method counts a character and forgets it.
+	 *  @return Always true
+	 */
+	bool putchar (char)
+	{
+		count++;
+		return true;
+	}
+};
+
+
+/// The console on which results are printed
+static sim_console console;
+
+/// The cycles it takes just to read the timer twice; subtracted from every result
+static uint16_t overhead = 0;
+
+/// The least, greatest and total number of cycles taken by runs of a kernel
+static uint16_t least, most;
+static uint32_t total;
+
+
+//-------------------------------------------------------------------------------------
+/** This macro times @c BENCH_RUNS runs of a piece of code and prints the results. The
+ *  memory barriers keep the compiler from moving the code outside the timed region.
+ *  @param name A string which names the kernel in the printout
+ *  @param setup Code which is run before each timed run but isn't timed
+ *  @param code The code to be timed
+ */
+
+#define BENCH(name, setup, code)                                                    \
+	least = 0xFFFF; most = 0; total = 0;                                            \
+	for (uint8_t run = 0; run < BENCH_RUNS; run++)                                  \
+	{                                                                               \
+		setup;                                                                      \
+		asm volatile ("" ::: "memory");                                             \
+		uint16_t start = TCNT4;                                                     \
+		asm volatile ("" ::: "memory");                                             \
+		code;                                                                       \
+		asm volatile ("" ::: "memory");                                             \
+		uint16_t cycles = TCNT4 - start - overhead;                                 \
+		if (cycles < least) least = cycles;                                         \
+		if (cycles > most) most = cycles;                                           \
+		total += cycles;                                                            \
+	}                                                                               \
+	report (PMS (name))
+
+
+//-------------------------------------------------------------------------------------
+/** This function prints one line of benchmark results on the console.
+ *  @param p_name The name of the kernel which was timed
+ */
+
+static void report (const char* p_name)
+{
+	console << p_name << PMS (": min ") << least << PMS (", avg ")
+	        << (uint16_t)(total / BENCH_RUNS) << PMS (", max ") << most
+	        << PMS (" cycles") << endl;
+}
+
+
+//=====================================================================================
+/** The main function sets up the drivers and shares, times each kernel and prints the
+ *  results, then stops the simulator by going to sleep with interrupts disabled.
+ *  @return This function never returns; the simulator stops instead
+ */
+
+int main (void)
+{
+	cli ();
+
+	// Timer/counter 4 counts CPU cycles: normal mode, no prescaler
+	TCCR4A = 0;
+	TCCR4B = (1 << CS40);
+
+	// Measure the cost of the timing itself, which is taken off every result
+	overhead = 0;
+	BENCH ("Timer overhead", , );
+	overhead = least;
+
+	console << endl << PMS ("ATmega1281 benchmarks at ") << (uint32_t)(F_CPU / 1000UL)
+	        << PMS (" kHz, ") << (uint16_t)BENCH_RUNS << PMS (" runs each") << endl;
+
+	// A/D converter: a blocking conversion, then reads from a background scan
+	adc* p_adc = new adc (NULL);
+	BENCH ("adc::read_once, blocking", , p_adc->read_once (0));
+	BENCH ("adc::read_oversampled 2 bits, blocking", , p_adc->read_oversampled (0, 2));
+
+	const uint8_t scan_list[] = { 0, 1 };
+	p_adc->start_scan (scan_list, sizeof (scan_list));
+	BENCH ("adc::read_once, scanning", , p_adc->read_once (0));
+	BENCH ("adc::read_oversampled 2 bits, scanning", , p_adc->read_oversampled (0, 2));
+
+	// The A/D scan ISR: wait for a conversion to finish, then let the ISR run
+	BENCH ("ADC_vect (scan ISR)",
+	       while (!(ADCSRA & (1 << ADIF))) { },
+	       sei (); asm volatile ("nop"); cli ());
+	p_adc->stop_scan ();
+
+	// The encoder ISR. Pin PE5 is made an output, so toggling it raises INT5 just as
+	// an edge from the encoder would
+	Encoder_dr* p_encoder = new Encoder_dr (NULL, 0, &EICRB, ISC50, ISC60,
+	                                        &EIMSK, INT5, INT6, &PORTE, PE5);
+	DDRE |= (1 << PE5);
+	BENCH ("INT5_vect (encoder ISR)",
+	       PORTE ^= (1 << PE5); while (!(EIFR & (1 << INTF5))) { },
+	       sei (); asm volatile ("nop"); cli ());
+	BENCH ("Encoder_dr::get_position", , p_encoder->get_position ());
+
+	// Motor updates: both motors as task_motor drives them, with the power scaled
+	// to Timer 1's TOP
+	Motor_driver::setup_timer1 (MOTOR_PWM_MODE);
+	Motor_driver* p_motor_1 = new Motor_driver (NULL, &PORTC, PC0, &PORTC, PC2,
+	                                            &PORTB, PB6, &OCR1B);
+	Motor_driver* p_motor_2 = new Motor_driver (NULL, &PORTD, PD5, &PORTD, PD7,
+	                                            &PORTB, PB5, &OCR1A);
+	BENCH ("Motor_driver::set_power x2", ,
+	       p_motor_1->set_power (120); p_motor_2->set_power (-120));
+	BENCH ("Motor_driver::brake x2", , p_motor_1->brake (50); p_motor_2->brake (50));
+
+	// The same motors through the fixed-pin template which task_motor uses
+	motor_1::init ();
+	motor_2::init ();
+	BENCH ("Motor_driver_fixed::set_power x2", ,
+	       motor_1::set_power (120); motor_2::set_power (-120));
+	BENCH ("Motor_driver_fixed::brake x2", , motor_1::brake (50); motor_2::brake (50));
+
+	// One update of a motor's PID controller with the default position gains, as
+	// run for each axis MOTOR_LOOP_HZ times a second (every millisecond at the
+	// default 1 kHz from Timer 0) by task_motor
+	PID* p_pid = new PID (MOTOR_POS_KP, MOTOR_POS_KI, MOTOR_POS_KD);
+	int32_t measurement = 0;
+	BENCH ("PID::update", measurement += 7, p_pid->update (1000, measurement));
+
+	// The control step of one run of task_motor's loop, for both axes in position
+	// mode: each axis's controllers, staging its motor's change, and the commit
+	// which hands the staged changes to Timer 1's interrupt
+	static Axis axes[NUM_AXES];
+	pid_gains position_gains = { MOTOR_POS_KP, MOTOR_POS_KI, MOTOR_POS_KD };
+	pid_gains velocity_gains = { MOTOR_VEL_KP, MOTOR_VEL_KI, MOTOR_VEL_KD };
+	for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+	{
+		axes[axis].init (&axis_table[axis], position_gains, velocity_gains);
+	}
+	axis_command command = { AXIS_POSITION, 0, 1000 };
+	enc_reading reading = { 0, 0 };
+	BENCH ("Axis::step x2 and commit", reading.position += 7,
+	       for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+	           axes[axis].drive (axes[axis].step (command, reading));
+	       Motor_group::commit ());
+
+	// Dead reckoning, as run every millisecond by task_odometry, with the wheels
+	// turning at different speeds so the heading changes each time
+	volatile int32_t sink;
+	volatile uint16_t angle = 12345;
+	BENCH ("fix_sin", , sink = fix_sin (angle));
+	Odometry* p_odometry = new Odometry (0, 0);
+	int32_t left = 0;
+	int32_t right = 0;
+	BENCH ("Odometry::update", left += 5; right += 9, p_odometry->update (left, right));
+
+	// Shared data items
+	TaskShare<int16_t>* p_share_16 = new TaskShare<int16_t> ("Bench 16");
+	TaskShare<int32_t>* p_share_32 = new TaskShare<int32_t> ("Bench 32");
+	BENCH ("TaskShare<int16_t>::put", , p_share_16->put (1234));
+	BENCH ("TaskShare<int16_t>::get", , sink = p_share_16->get ());
+	BENCH ("TaskShare<int32_t>::put", , p_share_32->put (123456L));
+	BENCH ("TaskShare<int32_t>::get", , sink = p_share_32->get ());
+
+	SeqShare<int32_t>* p_seq_32 = new SeqShare<int32_t> ("Bench seq 32");
+	BENCH ("SeqShare<int32_t>::put", , p_seq_32->put (123456L));
+	BENCH ("SeqShare<int32_t>::get", , sink = p_seq_32->get ());
+
+	// Serial formatting, into a device which discards the characters
+	null_device nowhere;
+	BENCH ("emstream << int16_t", , nowhere << (int16_t)(-12345));
+	BENCH ("emstream << int32_t", , nowhere << (int32_t)(-1234567890L));
+	BENCH ("emstream << PMS string", , nowhere << PMS ("Motor power: "));
+
+	// A text queue like the one tasks use to send printouts to the user interface.
+	// It's emptied before each run, so every run starts with the same empty queue
+	// rather than one which earlier runs have filled
+	TextQueue* p_queue = new TextQueue (32, "Bench", NULL, 0);
+	BENCH ("TextQueue 16 chars in",
+	       while (p_queue->check_for_char ()) sink = p_queue->getchar (),
+	       for (uint8_t i = 0; i < 16; i++) p_queue->putchar ('x'));
+	BENCH ("TextQueue 16 chars out",
+	       while (p_queue->check_for_char ()) sink = p_queue->getchar ();
+	       for (uint8_t i = 0; i < 16; i++) p_queue->putchar ('x'),
+	       for (uint8_t i = 0; i < 16; i++) sink = p_queue->getchar ());
+
+	(void)sink;
+	console << PMS ("Benchmarks done") << endl;
+
+	// Sleeping with interrupts off tells simavr that the program is finished
+	cli ();
+	sleep_enable ();
+	sleep_cpu ();
+	for (;;);
+}
@@ -0,0 +1,71 @@
+//*************************************************************************************
+/** @file control_timer.cpp
+ *    This file contains a timer which wakes a control task at a steady rate, using
+ *    Timer 0's compare match interrupt.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Semaphore is static when the RTOS supports static allocation
+ *
+ */
+//*************************************************************************************
+
+#include <stdlib.h>                         // Include standard library header files
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#include "control_timer.h"                  // Include header for the control timer
+#include "static_alloc.h"                   // Static memory for objects made once
+
+
+/// The semaphore which the interrupt gives to wake the control task
+static SemaphoreHandle_t tick_signal = NULL;
+
+
+//-------------------------------------------------------------------------------------
+/** This constructor sets up Timer 0 in CTC mode so that its compare match interrupt
+ *  comes at the given rate. The rate is rounded to the nearest one the timer can
+ *  make; at 16 MHz, 1 kHz and 2 kHz are exact.
+ *  @param a_rate_hz The rate at which the control loop runs, from @c CTRL_MIN_HZ up
+ */
+
+Control_timer::Control_timer (uint16_t a_rate_hz)
+{
+	rate_hz = a_rate_hz;
+	tick_signal = STATIC_SEMAPHORE_BINARY ();
+
+	TCCR0B = 0;
+	TCNT0 = 0;
+	OCR0A = (uint8_t)((F_CPU / CTRL_PRESCALER + rate_hz / 2) / rate_hz - 1);
+	TCCR0A = (1 << WGM01);
+	TIFR0 = (1 << OCF0A);
+	TIMSK0 |= (1 << OCIE0A);
+	TCCR0B = (1 << CS01) | (1 << CS00);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method waits until the timer's next interrupt. It's called by the control
+ *  task at the end of each run of its loop, in place of a delay.
+ */
+
+void Control_timer::wait (void)
+{
+	xSemaphoreTake (tick_signal, portMAX_DELAY);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This ISR is run at each compare match of Timer 0. It wakes the control task, and
+ *  switches straight to it if it has a higher priority than the interrupted task.
+ */
+
+ISR (TIMER0_COMPA_vect)
+{
+	BaseType_t woken = pdFALSE;
+	xSemaphoreGiveFromISR (tick_signal, &woken);
+	if (woken != pdFALSE)
+	{
+		taskYIELD ();
+	}
+}
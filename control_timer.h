@@ -0,0 +1,64 @@
+//======================================================================================
+/** @file control_timer.h
+ *    This file contains the header for a timer which paces a control loop. Timer 0's
+ *    compare match interrupt wakes the control task at a steady rate, so the loop's
+ *    timing doesn't depend on the RTOS tick or on what other tasks are doing.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//======================================================================================
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _CONTROL_TIMER_H_
+#define _CONTROL_TIMER_H_
+
+#include "FreeRTOS.h"                       // Header for the FreeRTOS RTOS
+#include "task.h"                           // Header for FreeRTOS task functions
+#include "queue.h"                          // Header for FreeRTOS queues
+#include "semphr.h"                         // Header for FreeRTOS semaphores
+
+
+/// Timer 0 counts at the CPU clock divided by this number
+#define CTRL_PRESCALER      64
+
+/// The slowest rate the timer can run at with its 8-bit counter, in Hz
+#define CTRL_MIN_HZ         ((F_CPU / CTRL_PRESCALER + 255) / 256)
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This class runs Timer 0 as the clock of a control loop.
+ *  @details Timer 0 is put in CTC mode, so its compare match interrupt comes at an
+ *           exact rate which is set by the crystal, not by the RTOS. Each interrupt
+ *           gives a binary semaphore, and the control task takes it with @c wait().
+ *           If the control task has a higher priority than any other, it starts
+ *           running as soon as the interrupt returns, so the jitter of the loop is
+ *           only the time taken by interrupts and critical sections.
+ *
+ *           If the task hasn't taken the semaphore by the next interrupt, it has
+ *           overrun its period, and the tick is dropped rather than run late; the
+ *           task's @c LoopProfile counts each dropped tick as a missed deadline.
+ *           Only one object of this class may be made.
+ */
+
+class Control_timer
+{
+protected:
+	/// The rate at which the timer interrupts, in Hz
+	uint16_t rate_hz;
+
+public:
+	// The constructor sets up Timer 0 and starts its interrupts
+	Control_timer (uint16_t a_rate_hz);
+
+	// Wait for the next tick of the timer
+	void wait (void);
+
+	/// Get the rate at which the timer interrupts, in Hz
+	uint16_t get_rate_hz (void) { return rate_hz; }
+};
+
+#endif // _CONTROL_TIMER_H_
@@ -1,50 +1,387 @@
+//*************************************************************************************
+/** @file encoder_dr.cpp
+ *    This file contains a quadrature encoder driver for the wheel encoders on the
+ *    ME405 board. Both channels of each encoder are connected to external interrupt
+ *    pins which interrupt on any change; the interrupt service routines decode the
+ *    channel states into a signed 32-bit position.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Table-driven 4x decoding into a 32-bit position; two encoders
+ *    @li 10-17-2026 Added position_of() for readers which don't own the driver
+ *    @li 10-17-2026 The ISR's publish positions through sequence-locked shares
+ *    @li 10-17-2026 Edges are timestamped for an M/T velocity estimate
+ *    @li 10-17-2026 Shares are made in static memory when STATIC_ALLOCATION is set
+ *    @li 10-17-2026 Debugging message is logged in binary rather than printed
+ *    @li 10-17-2026 An interrupt which doesn't move the count publishes nothing
+ *
+ */
+//*************************************************************************************
+
 #include <stdlib.h>                         // Include standard library header files
 #include <avr/io.h>
 #include <avr/interrupt.h>
+#include <util/atomic.h>                    // Macros for interrupt-safe blocks
 
 #include "rs232int.h"                       // Include header for serial port class
-#include "encoder_dr.h"                       // Include header for the A/D class
+#include "encoder_dr.h"                     // Include header for the encoder class
+#include "static_alloc.h"                   // Static memory for objects made once
+#include "log.h"                            // Binary log messages
+
+
+/** This table gives the change in position for each transition of the two channels.
+ *  It is indexed by (old state << 2) | new state, where a state is (B << 1) | A.
+ *  Transitions in which both channels changed at once are illegal and count zero.
+ *  The table is kept in RAM rather than flash because it's read in the ISR, and an
+ *  @c ld is quicker than an @c lpm.
+ */
+static const int8_t enc_table[16] =
+{
+	 0, +1, -1,  0,                         // From 00 to 00, 01, 10, 11
+	-1,  0,  0, +1,                         // From 01 to 00, 01, 10, 11
+	+1,  0,  0, -1,                         // From 10 to 00, 01, 10, 11
+	 0, -1, +1,  0                          // From 11 to 00, 01, 10, 11
+};
+
+/// The position of each encoder. These belong to the ISR's, which publish each new
+/// count in the encoder's share; tasks only ever read the shares
+static volatile int32_t enc_position[ENC_NUM_ENCODERS];
+
+/// The shares through which the ISR's publish the positions and the times of the
+/// edges. Each is created by the encoder's constructor before its interrupts are
+/// enabled
+static SeqShare<enc_edge>* enc_share[ENC_NUM_ENCODERS];
 
+/// The shares in which sample() publishes each encoder's position and velocity
+static SeqShare<enc_reading>* enc_reading_share[ENC_NUM_ENCODERS];
 
+/// The edge which sample() saw last time for each encoder; the next velocity is
+/// measured from it
+static enc_edge enc_ref_edge[ENC_NUM_ENCODERS];
 
+/// The velocity which sample() found last time for each encoder, in counts per second
+static int32_t enc_velocity[ENC_NUM_ENCODERS];
 
-Encoder_dr::Encoder_dr(emstream* p_serial, volatile uint8_t* my_p_isr_cntl, uint8_t my_isr_pin1, uint8_t my_isr_pin2,
-	 volatile uint8_t* my_p_isr_enable, uint8_t my_isr_enable_pin1, uint8_t my_isr_enable_pin2, 
-	    volatile uint8_t* my_p_encoder_DDR, volatile uint8_t* my_p_encoder_PORT)
+/// The most recent state of both channels of each encoder, as (B << 1) | A
+static volatile uint8_t enc_last_state[ENC_NUM_ENCODERS];
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This constructor sets up an encoder driver.
+ *  @details The pins for both channels are set as inputs with pull-ups, the external
+ *           interrupts are set to trigger on any logical change, the current state of
+ *           the channels is saved so the first edge is decoded properly, and then the
+ *           interrupts are enabled.
+ *  @param p_serial_port A serial port for debugging printouts (default: NULL)
+ *  @param a_number Which encoder this is: 0 for the INT5/INT6 one, 1 for INT0/INT1
+ *  @param my_p_isr_cntl The external interrupt control register, EICRA or EICRB
+ *  @param my_isr_pin1 The ISCn0 bit for the first channel's interrupt
+ *  @param my_isr_pin2 The ISCn0 bit for the second channel's interrupt
+ *  @param my_p_isr_enable The external interrupt mask register, EIMSK
+ *  @param my_isr_enable_pin1 The INTn bit for the first channel's interrupt
+ *  @param my_isr_enable_pin2 The INTn bit for the second channel's interrupt
+ *  @param my_p_encoder_PORT The data register of the port the channels are on; the
+ *                           DDR and PIN registers are one and two addresses below it
+ *  @param my_encoder_pin The pin of channel A; channel B must be the next pin up
+ */
+
+Encoder_dr::Encoder_dr (emstream* p_serial_port, uint8_t a_number,
+                        volatile uint8_t* my_p_isr_cntl, uint8_t my_isr_pin1,
+                        uint8_t my_isr_pin2, volatile uint8_t* my_p_isr_enable,
+                        uint8_t my_isr_enable_pin1, uint8_t my_isr_enable_pin2,
+                        volatile uint8_t* my_p_encoder_PORT, uint8_t my_encoder_pin)
 {
-	ptr_to_serial = p_serial;
+	ptr_to_serial = p_serial_port;
+	number = (a_number < ENC_NUM_ENCODERS) ? a_number : (ENC_NUM_ENCODERS - 1);
+
 	p_isr_cntl = my_p_isr_cntl;
 	isr_pin1 = my_isr_pin1;
 	isr_pin2 = my_isr_pin2;
 	p_isr_enable = my_p_isr_enable;
 	isr_enable_pin1 = my_isr_enable_pin1;
 	isr_enable_pin2 = my_isr_enable_pin2;
-	p_encoder_DDR = my_p_encoder_DDR;
 	p_encoder_PORT = my_p_encoder_PORT;
+	p_encoder_DDR = my_p_encoder_PORT - 1;  // DDR register is one below the data port
+	p_encoder_PIN = my_p_encoder_PORT - 2;  // PIN register is two below the data port
+	encoder_pin = my_encoder_pin;
+
+	// The shares are named for the encoder so they can be found in the list of shares
+	p_share = STATIC_NEW_ONE_OF (SeqShare<enc_edge>, ENC_NUM_ENCODERS, number,
+	                             (number == 0 ? "Encoder 0 ISR" : "Encoder 1 ISR"));
+	enc_share[number] = p_share;
+	enc_reading_share[number] = STATIC_NEW_ONE_OF (SeqShare<enc_reading>,
+	                                               ENC_NUM_ENCODERS, number,
+	                                               (number == 0 ? "Encoder 0 M/T"
+	                                                            : "Encoder 1 M/T"));
+
+	// Both channels are inputs with their pull-up resistors turned on
+	*p_encoder_DDR &= ~((1 << encoder_pin) | (1 << (encoder_pin + 1)));
+	*p_encoder_PORT |= (1 << encoder_pin) | (1 << (encoder_pin + 1));
+
+	// Interrupt on any logical change: ISCn0 set and ISCn1 clear for each channel
+	*p_isr_cntl &= ~((1 << (isr_pin1 + 1)) | (1 << (isr_pin2 + 1)));
+	*p_isr_cntl |= (1 << isr_pin1) | (1 << isr_pin2);
+
+	// Start from the state the channels are in now, then turn on the interrupts
+	enc_edge start;
+	start.position = 0;
+	start.time = LoopProfile::now ();
+	enc_ref_edge[number] = start;
+	enc_velocity[number] = 0;
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		enc_last_state[number] = (*p_encoder_PIN >> encoder_pin) & 0x03;
+		enc_position[number] = 0;
+		p_share->put (start);
+	}
+	*p_isr_enable |= (1 << isr_enable_pin1) | (1 << isr_enable_pin2);
+
+	LOG_INFO ("Encoder %u constructor OK", number);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method returns the encoder's position.
+ *  @details The position is copied from the share the ISR publishes it in; if an
+ *           edge comes in during the copy, the copy is made again. Interrupts are
+ *           never disabled.
+ *  @return  The number of counts moved since the encoder was last zeroed
+ */
+
+int32_t Encoder_dr::get_position (void)
+{
+	return p_share->get ().position;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method returns the position of any of the encoders.
+ *  @details It's static so that a task such as the motor controller can read an
+ *           encoder which was set up by another task, without a pointer to the
+ *           driver object. It reads the count the same way @c get_position() does.
+ *  @param   a_number The number of the encoder, from 0 to ENC_NUM_ENCODERS - 1
+ *  @return  The number of counts that encoder has moved since it was last zeroed,
+ *           or zero if that encoder hasn't been set up yet
+ */
+
+int32_t Encoder_dr::position_of (uint8_t a_number)
+{
+	if (a_number >= ENC_NUM_ENCODERS || enc_share[a_number] == NULL)
+	{
+		return 0;
+	}
+	return enc_share[a_number]->get ().position;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method finds an encoder's position and velocity, and publishes them.
+ *  @details The velocity is found by the M/T method from the last edge the ISR
+ *           published and the last edge seen by the previous call: the counts between
+ *           the two edges over the time between them. If no edge has come since the
+ *           previous call, the wheel can't be going faster than one count in the time
+ *           since the last edge, so the previous velocity is limited to that. This
+ *           method must be called at a steady rate by one task, usually the control
+ *           loop; other tasks can get the result with @c reading_of().
+ *  @param   a_number The number of the encoder, from 0 to ENC_NUM_ENCODERS - 1
+ *  @return  The encoder's position in counts and velocity in counts per second, or
+ *           zeros if that encoder hasn't been set up yet
+ */
+
+enc_reading Encoder_dr::sample (uint8_t a_number)
+{
+	enc_reading reading;
+	if (a_number >= ENC_NUM_ENCODERS || enc_share[a_number] == NULL)
+	{
+		reading.position = 0;
+		reading.velocity = 0;
+		return reading;
+	}
+
+	enc_edge edge = enc_share[a_number]->get ();
+	enc_edge& ref = enc_ref_edge[a_number];
+	int32_t& velocity = enc_velocity[a_number];
+	int32_t counts = edge.position - ref.position;
+	uint32_t ticks = edge.time - ref.time;
+
+	if (ticks != 0)
+	{
+		// At least one edge since last time: counts over the time between edges. A
+		// count times the ticks in a second overflows 32 bits past 8589 counts, so a
+		// long move is worked out with coarser time
+		if (counts > -8192 && counts < 8192)
+		{
+			velocity = counts * (int32_t)ENC_TICKS_PER_SEC / (int32_t)ticks;
+		}
+		else
+		{
+			int32_t coarse_ticks = (int32_t)(ticks >> 8);
+			velocity = counts * (int32_t)(ENC_TICKS_PER_SEC >> 8)
+			           / (coarse_ticks > 0 ? coarse_ticks : 1);
+		}
+		ref = edge;
+	}
+	else
+	{
+		// No edge: the speed is at most one count since the last edge
+		uint32_t since = LoopProfile::now () - ref.time;
+		int32_t limit = (since > 0) ? (int32_t)(ENC_TICKS_PER_SEC / since)
+		                            : (int32_t)ENC_TICKS_PER_SEC;
+		if (velocity > limit)
+		{
+			velocity = limit;
+		}
+		else if (velocity < -limit)
+		{
+			velocity = -limit;
+		}
+	}
+
+	reading.position = edge.position;
+	reading.velocity = velocity;
+	enc_reading_share[a_number]->put (reading);
+	return reading;
 }
 
-void Encoder_dr::encoder_setup ()
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method returns the position and velocity which @c sample() found
+ *           most recently for an encoder.
+ *  @param   a_number The number of the encoder, from 0 to ENC_NUM_ENCODERS - 1
+ *  @return  The encoder's position in counts and velocity in counts per second, or
+ *           zeros if that encoder hasn't been set up yet
+ */
+
+enc_reading Encoder_dr::reading_of (uint8_t a_number)
 {
-	*p_isr_control |= (1 << isr_pin1) | (1 << (isr_pin1 + 1)) | (1 << isr_pin2) | (1 << (isr_pin2 + 1));
-	*p_isr_enable  |= (1 << isr_enable_pin1) | (1 << isr_enable_pin2);
-	
-	*p_encoder_DDR &= ~();
-	*p_encoder_PORT |= ();
+	if (a_number >= ENC_NUM_ENCODERS || enc_reading_share[a_number] == NULL)
+	{
+		enc_reading reading;
+		reading.position = 0;
+		reading.velocity = 0;
+		return reading;
+	}
+	return enc_reading_share[a_number]->get ();
 }
 
-ISR(INT5_vect)
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method sets the encoder's position count.
+ *  @details The ISR is the only writer of the share, so interrupts are held off
+ *           while the count and the share are changed; this is the only place the
+ *           driver disables interrupts after it has been set up. The velocity is then
+ *           measured from the new position, so the jump isn't seen as motion.
+ *  @param   new_position The value to put into the count (default: 0)
+ */
+
+void Encoder_dr::set_position (int32_t new_position)
 {
-	switch(p_encoder_state->get())
+	enc_edge edge;
+	edge.position = new_position;
+	edge.time = LoopProfile::now ();
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
 	{
-		case (0): //case 10
-			break;
-		case (1): //case 11
-			break;
-		case (2): //case 01
-			break;
-		case (3): //case 00
-			break;
+		enc_position[number] = new_position;
+		p_share->put (edge);
+		enc_ref_edge[number] = edge;
 	}
 }
-ISR(INT6_vect, ISR_ALIASOF(INT5_vect));
 
+
+//-------------------------------------------------------------------------------------
+/** @brief   This ISR decodes encoder 0 on pins PE5 (INT5) and PE6 (INT6).
+ *  @details Both channels are read at once from the PIN register, the old and new
+ *           states index the transition table, and the result is added to the
+ *           count, which is then published in the encoder's share with the time of
+ *           the edge. If the table gives no change, because a glitch left the
+ *           channels as they were or both changed at once, the edge is neither
+ *           timed nor published, so the velocity estimate doesn't see an edge
+ *           without a count. INT6 shares this code through an alias, so the vector
+ *           costs nothing extra.
+ */
+
+ISR (INT5_vect)
+{
+	uint8_t new_state = (PINE >> PE5) & 0x03;
+	int8_t change = enc_table[(enc_last_state[0] << 2) | new_state];
+	enc_last_state[0] = new_state;
+	if (change != 0)
+	{
+		enc_edge edge;
+		edge.time = LoopProfile::now ();
+		edge.position = enc_position[0] + change;
+		enc_position[0] = edge.position;
+		enc_share[0]->ISR_put (edge);
+	}
+}
+
+ISR (INT6_vect, ISR_ALIASOF (INT5_vect));
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This ISR decodes encoder 1 on pins PD0 (INT0) and PD1 (INT1).
+ *  @details It works just like the one for encoder 0; INT1 is an alias of INT0.
+ */
+
+ISR (INT0_vect)
+{
+	uint8_t new_state = (PIND >> PD0) & 0x03;
+	int8_t change = enc_table[(enc_last_state[1] << 2) | new_state];
+	enc_last_state[1] = new_state;
+	if (change != 0)
+	{
+		enc_edge edge;
+		edge.time = LoopProfile::now ();
+		edge.position = enc_position[1] + change;
+		enc_position[1] = edge.position;
+		enc_share[1]->ISR_put (edge);
+	}
+}
+
+ISR (INT1_vect, ISR_ALIASOF (INT0_vect));
+
+
+//-------------------------------------------------------------------------------------
+/** \brief   This overloaded operator prints the encoder's position.
+ *  @param   serpt Reference to a serial port to which the printout will be printed
+ *  @param   enc   Reference to the encoder driver which is being printed
+ *  @return  A reference to the same serial device on which we write information.
+ *           This is used to string together things to write with @c << operators
+ */
+
+emstream& operator << (emstream& serpt, Encoder_dr& enc)
+{
+	serpt << PMS ("Encoder ") << enc.get_number () << PMS (" position: ")
+	      << enc.get_position () << endl;
+
+	return (serpt);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This operator prints the position and time of an encoder edge.
+ *  @param   serpt Reference to a serial port to which the printout will be printed
+ *  @param   edge  Reference to the edge which is being printed
+ *  @return  A reference to the same serial device on which we write information
+ */
+
+emstream& operator << (emstream& serpt, const enc_edge& edge)
+{
+	serpt << edge.position << PMS (" @ ") << edge.time;
+
+	return (serpt);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This operator prints an encoder's position and velocity.
+ *  @param   serpt   Reference to a serial port to which the printout will be printed
+ *  @param   reading Reference to the reading which is being printed
+ *  @return  A reference to the same serial device on which we write information
+ */
+
+emstream& operator << (emstream& serpt, const enc_reading& reading)
+{
+	serpt << reading.position << PMS (", ") << reading.velocity << PMS ("/s");
+
+	return (serpt);
+}
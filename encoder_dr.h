@@ -1,40 +1,136 @@
-#ifndef encoder_dr
-#define encoder_dr
+//======================================================================================
+/** @file encoder_dr.h
+ *    This file contains the header for a quadrature encoder driver which counts the
+ *    edges on both channels of the ME405 board's wheel encoders using the external
+ *    interrupt pins of the AVR.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Table-driven 4x decoding into a 32-bit position; two encoders
+ *    @li 10-17-2026 Added position_of() for readers which don't own the driver
+ *    @li 10-17-2026 The ISR's publish positions through sequence-locked shares
+ *    @li 10-17-2026 Edges are timestamped for an M/T velocity estimate
+ *
+ */
+//======================================================================================
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef ENCODER_DR
+#define ENCODER_DR
 
 #include "emstream.h"                       // Header for serial ports and devices
 #include "FreeRTOS.h"                       // Header for the FreeRTOS RTOS
 #include "task.h"                           // Header for FreeRTOS task functions
 #include "queue.h"                          // Header for FreeRTOS queues
 #include "semphr.h"                         // Header for FreeRTOS semaphores
+#include "seqshare.h"                       // Header for sequence-locked shares
+#include "profiler.h"                       // For the timer which stamps the edges
+
+
+/// The number of encoders which have interrupt service routines in encoder_dr.cpp.
+/// Encoder 0 uses INT5 and INT6 (pins PE5 and PE6); encoder 1 uses INT0 and INT1
+/// (pins PD0 and PD1). Each encoder's two channels must be on adjacent pins.
+#define ENC_NUM_ENCODERS    2
+
+/// The number of edge timestamp counts in a second; the edges are stamped with the
+/// profiler's free-running timer
+#define ENC_TICKS_PER_SEC   (PROF_TICKS_PER_MS * 1000L)
+
+
+/// What an encoder's ISR publishes after each edge
+struct enc_edge
+{
+	int32_t position;                       ///< The count after the edge
+	uint32_t time;                          ///< When the edge came, in timer counts
+};
+
+/// An encoder's position and velocity, as found by @c Encoder_dr::sample()
+struct enc_reading
+{
+	int32_t position;                       ///< The count, in encoder counts
+	int32_t velocity;                       ///< The speed, in counts per second
+};
+
+// These operators print an edge and a reading, so their shares can be printed
+emstream& operator << (emstream&, const enc_edge&);
+emstream& operator << (emstream&, const enc_reading&);
+
 
+//-------------------------------------------------------------------------------------
+/** @brief   This class runs a quadrature encoder using two external interrupt pins.
+ *  @details Both channels of the encoder interrupt on every edge, and the interrupt
+ *           service routine looks up the change in position from the old and new
+ *           states of the two channels in a 16-entry table. That gives four counts
+ *           per cycle of either channel. The count is kept in a signed 32-bit number
+ *           which belongs to the ISR. After each edge the ISR publishes the count in
+ *           a @c SeqShare, which takes no critical section; tasks read it through
+ *           @c get_position() or @c position_of(), retrying if an edge came in the
+ *           middle of the read, so reading never holds off the encoder interrupts.
+ *
+ *           Each edge is also stamped with the time from the profiler's timer, and
+ *           @c sample() uses the stamps to find the velocity by the M/T method: the
+ *           number of counts between the last edges seen at two samples, divided by
+ *           the time between those two edges. At high speed many edges come in each
+ *           sample period, and the result is as precise as counting them over a
+ *           period; at crawl speed, when an edge may come only every few periods, the
+ *           time between edges is measured to a few microseconds instead of being
+ *           rounded to whole periods, so the estimate doesn't jump between zero and
+ *           a large value. When no edge has come for a while, the velocity can be at
+ *           most one count in the time since the last edge, so it falls smoothly to
+ *           zero when the wheel stops.
+ */
 
 class Encoder_dr
 {
 protected:
-  
-private:
+	/// The encoder driver uses this pointer to the serial port to say hello
 	emstream* ptr_to_serial;
+
+	/// Which of the encoders serviced in encoder_dr.cpp this object runs
+	uint8_t number;
+
+	/// The share through which the ISR publishes this encoder's position
+	SeqShare<enc_edge>* p_share;
+
+private:
 	volatile uint8_t* p_isr_cntl;
 	uint8_t isr_pin1;
 	uint8_t isr_pin2;
 	volatile uint8_t* p_isr_enable;
 	uint8_t isr_enable_pin1;
 	uint8_t isr_enable_pin2;
-	
+
 	volatile uint8_t* p_encoder_DDR;
 	volatile uint8_t* p_encoder_PORT;
+	volatile uint8_t* p_encoder_PIN;
 	uint8_t encoder_pin;
-	
-	
-  
+
 public:
-  
-	Encoder_dr(emstream* ptr_to_serial, volatile uint8_t* p_isr_cntl, uint8_t isr_pin1, uint8_t isr_pin2,
-	    volatile uint8_t* p_isr_enable, uint8_t isr_enable_pin1, uint8_t isr_enable_pin2, 
-	    volatile uint8_t* p_encoder_DDR, volatile uint8_t* p_encoder_PORT);
-  
+	Encoder_dr (emstream* p_serial_port, uint8_t a_number,
+	            volatile uint8_t* p_isr_cntl, uint8_t isr_pin1, uint8_t isr_pin2,
+	            volatile uint8_t* p_isr_enable, uint8_t isr_enable_pin1,
+	            uint8_t isr_enable_pin2, volatile uint8_t* p_encoder_PORT,
+	            uint8_t encoder_pin);
+
+	// Get the number of counts the encoder has moved since it was last zeroed
+	int32_t get_position (void);
+
+	// Get the position of encoder number n, for code which doesn't own its driver
+	static int32_t position_of (uint8_t a_number);
+
+	// Find encoder number n's position and velocity and publish them
+	static enc_reading sample (uint8_t a_number);
+
+	// Get the position and velocity most recently found by sample()
+	static enc_reading reading_of (uint8_t a_number);
+
+	// Set the position count to a given value, usually zero
+	void set_position (int32_t new_position = 0);
+
+	/// Get the number of the encoder this object runs
+	uint8_t get_number (void) { return number; }
 };
 
-emstream& operator << (emstream&, ISR&);
+// This operator prints the encoder's position
+emstream& operator << (emstream&, Encoder_dr&);
 
-#endif 
\ No newline at end of file
+#endif // ENCODER_DR
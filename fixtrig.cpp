@@ -0,0 +1,65 @@
+//*************************************************************************************
+/** @file fixtrig.cpp
+ *    This file contains fixed-point sine and cosine functions which look the answer
+ *    up in a table of a quarter of a sine wave and interpolate between its entries.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ */
+//*************************************************************************************
+
+#include <avr/pgmspace.h>                   // For the table, which is kept in flash
+
+#include "fixtrig.h"                        // Include header for the trig functions
+
+
+/// The sine of each 1/256 of a turn from 0 to 90 degrees, in Q2.14 format
+static const uint16_t sine_table[65] PROGMEM =
+{
+	    0,   402,   804,  1205,  1606,  2006,  2404,  2801,
+	 3196,  3590,  3981,  4370,  4756,  5139,  5520,  5897,
+	 6270,  6639,  7005,  7366,  7723,  8076,  8423,  8765,
+	 9102,  9434,  9760, 10080, 10394, 10702, 11003, 11297,
+	11585, 11866, 12140, 12406, 12665, 12916, 13160, 13395,
+	13623, 13842, 14053, 14256, 14449, 14635, 14811, 14978,
+	15137, 15286, 15426, 15557, 15679, 15791, 15893, 15986,
+	16069, 16143, 16207, 16261, 16305, 16340, 16364, 16379,
+	16384
+};
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This function finds the sine of a binary angle.
+ *  @details The top two bits of the angle are the quadrant, which sets the sign and
+ *           whether the table is read forwards or backwards. The next six bits pick
+ *           an entry in the table and the next seven interpolate linearly to the
+ *           next entry; the difference between entries is less than 512, so the
+ *           product fits in 16 bits. The error is a few parts in 16384, and the
+ *           function takes two table reads and one 16-bit multiplication.
+ *  @param   angle The angle, in 65536ths of a turn
+ *  @return  The sine, from -16384 to 16384
+ */
+
+int16_t fix_sin (uint16_t angle)
+{
+	// In the second and fourth quadrants the sine comes back down, so the angle is
+	// measured back from the end of the quadrant
+	uint16_t within = angle & (FIX_QUARTER_TURN - 1);
+	if (angle & FIX_QUARTER_TURN)
+	{
+		within = FIX_QUARTER_TURN - within;
+	}
+
+	uint8_t index = within >> 8;
+	uint8_t fraction = (within & 0xFF) >> 1;
+	uint16_t value = pgm_read_word (&sine_table[index]);
+	if (fraction != 0)
+	{
+		uint16_t next = pgm_read_word (&sine_table[index + 1]);
+		value += ((next - value) * fraction) >> 7;
+	}
+
+	// The third and fourth quadrants are negative
+	return (angle & (2 * FIX_QUARTER_TURN)) ? -(int16_t)value : (int16_t)value;
+}
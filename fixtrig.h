@@ -0,0 +1,43 @@
+//======================================================================================
+/** @file fixtrig.h
+ *    This file contains the header for fixed-point sine and cosine functions. Angles
+ *    are binary angles, in which a whole turn is 65536, so they wrap around by
+ *    themselves when they overflow; the results are Q2.14 numbers. The AVR has no
+ *    floating point hardware, and these functions take a small fraction of the time
+ *    that the floating point library's @c sin() does.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//======================================================================================
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _FIXTRIG_H_
+#define _FIXTRIG_H_
+
+#include <stdint.h>                         // Fixed-size integer types
+
+
+/// The number of fractional bits in a sine or cosine; 1.0 is 16384
+#define FIX_TRIG_BITS       14
+
+/// A quarter of a turn as a binary angle
+#define FIX_QUARTER_TURN    0x4000U
+
+
+// Find the sine of a binary angle, as a Q2.14 number
+int16_t fix_sin (uint16_t angle);
+
+/** This function finds the cosine of a binary angle, as a Q2.14 number.
+ *  @param angle The angle, in 65536ths of a turn
+ *  @return The cosine, from -16384 to 16384
+ */
+inline int16_t fix_cos (uint16_t angle)
+{
+	return fix_sin (angle + FIX_QUARTER_TURN);
+}
+
+#endif // _FIXTRIG_H_
@@ -0,0 +1,65 @@
+//*************************************************************************************
+/** @file host/FreeRTOSConfig.h
+ *    This file configures FreeRTOS for the POSIX port used when the program is built
+ *    for a Linux host with @c make @c host. It's found ahead of the AVR configuration
+ *    in the ME405 library because the host directory comes first on the include
+ *    path. The settings follow the AVR ones where the tasks can tell the difference,
+ *    such as the tick rate, and are generous where they can't, such as heap size.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#define configUSE_PREEMPTION                    1
+#define configUSE_IDLE_HOOK                     0
+#define configUSE_TICK_HOOK                     0
+#define configCPU_CLOCK_HZ                      ((unsigned long) F_CPU)
+#define configTICK_RATE_HZ                      ((TickType_t) 1000)
+#define configMAX_PRIORITIES                    6
+#define configMINIMAL_STACK_SIZE                ((unsigned short) 4096)
+#define configTOTAL_HEAP_SIZE                   ((size_t) (256 * 1024))
+#define configMAX_TASK_NAME_LEN                 16
+#define configUSE_TRACE_FACILITY                1
+#define configUSE_16_BIT_TICKS                  0
+#define configIDLE_SHOULD_YIELD                 1
+#define configUSE_MUTEXES                       1
+#define configUSE_RECURSIVE_MUTEXES             1
+#define configUSE_COUNTING_SEMAPHORES           1
+#define configUSE_TASK_NOTIFICATIONS            1
+#define configQUEUE_REGISTRY_SIZE               0
+#define configUSE_APPLICATION_TASK_TAG          0
+#define configCHECK_FOR_STACK_OVERFLOW          0
+#define configUSE_MALLOC_FAILED_HOOK            0
+#define configSUPPORT_DYNAMIC_ALLOCATION        1
+#define configSUPPORT_STATIC_ALLOCATION         0
+#define configENABLE_BACKWARD_COMPATIBILITY     1
+#define configUSE_CO_ROUTINES                   0
+#define configMAX_CO_ROUTINE_PRIORITIES         1
+
+#define configUSE_TIMERS                        1
+#define configTIMER_TASK_PRIORITY               (configMAX_PRIORITIES - 1)
+#define configTIMER_QUEUE_LENGTH                10
+#define configTIMER_TASK_STACK_DEPTH            configMINIMAL_STACK_SIZE
+
+#define INCLUDE_vTaskPrioritySet                1
+#define INCLUDE_uxTaskPriorityGet               1
+#define INCLUDE_vTaskDelete                     1
+#define INCLUDE_vTaskCleanUpResources           0
+#define INCLUDE_vTaskSuspend                    1
+#define INCLUDE_vTaskDelayUntil                 1
+#define INCLUDE_vTaskDelay                      1
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
+#define INCLUDE_xTaskGetSchedulerState          1
+#define INCLUDE_xTaskGetCurrentTaskHandle       1
+#define INCLUDE_xTaskGetIdleTaskHandle          1
+#define INCLUDE_eTaskGetState                   1
+#define INCLUDE_pcTaskGetTaskName               1
+
+#endif // FREERTOS_CONFIG_H
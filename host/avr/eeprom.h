@@ -0,0 +1,62 @@
+//*************************************************************************************
+/** @file host/avr/eeprom.h
+ *    This file stands in for the avr-libc EEPROM header on a Linux host. Variables
+ *    marked @c EEMEM are ordinary variables in RAM, so the EEPROM starts out zeroed
+ *    each time the program runs, and reading and writing it are copies. The last
+ *    block written is remembered, so a test can damage what was saved.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Remembers where the last block was written, for the unit tests
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#ifndef _HOST_AVR_EEPROM_H_
+#define _HOST_AVR_EEPROM_H_
+
+#include <stddef.h>
+#include <string.h>
+
+#define EEMEM
+
+/// Where the last block was written in the EEPROM, and its size
+struct host_eeprom_block
+{
+	void* p_start;
+	size_t size;
+};
+
+/** This function gives the place in the EEPROM where the last block was written. The
+ *  static variable in an inline function is the same one in every file.
+ *  @return A reference to the block's start and size, which are zero until one has
+ *          been written
+ */
+inline host_eeprom_block& host_eeprom_last_block (void)
+{
+	static host_eeprom_block block = { NULL, 0 };
+	return block;
+}
+
+inline void eeprom_read_block (void* p_dest, const void* p_src, size_t size)
+{
+	memcpy (p_dest, p_src, size);
+}
+
+inline void eeprom_update_block (const void* p_src, void* p_dest, size_t size)
+{
+	memcpy (p_dest, p_src, size);
+	host_eeprom_last_block ().p_start = p_dest;
+	host_eeprom_last_block ().size = size;
+}
+
+inline void eeprom_write_block (const void* p_src, void* p_dest, size_t size)
+{
+	memcpy (p_dest, p_src, size);
+	host_eeprom_last_block ().p_start = p_dest;
+	host_eeprom_last_block ().size = size;
+}
+
+#endif // _HOST_AVR_EEPROM_H_
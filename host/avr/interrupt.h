@@ -0,0 +1,31 @@
+//*************************************************************************************
+/** @file host/avr/interrupt.h
+ *    This file stands in for the avr-libc interrupt header on a Linux host. An ISR
+ *    becomes an ordinary function named after its vector, so a test or benchmark
+ *    program can "fire" an interrupt simply by calling, for example, @c INT5_vect().
+ *    Aliased vectors are declared but not defined; call the vector they alias.
+ *    Enabling and disabling interrupts only changes the I bit in the simulated
+ *    status register.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#ifndef _HOST_AVR_INTERRUPT_H_
+#define _HOST_AVR_INTERRUPT_H_
+
+#include <avr/io.h>
+
+#define ISR(vector, ...)    extern "C" void vector (void); \
+                            extern "C" void vector (void)
+#define ISR_ALIASOF(vector)
+#define ISR_NOBLOCK
+#define ISR_NAKED
+#define sei()               (SREG |= (1 << SREG_I))
+#define cli()               (SREG &= (uint8_t)~(1 << SREG_I))
+
+#endif // _HOST_AVR_INTERRUPT_H_
@@ -0,0 +1,375 @@
+//*************************************************************************************
+/** @file host/avr/io.h
+ *    This file stands in for the avr-libc header of the same name when the drivers
+ *    and tasks are compiled for a Linux host with @c make @c host. Each special
+ *    function register is mapped onto a byte in a simulated register file, at the
+ *    same data-space address it has on an ATmega1281, so that address arithmetic
+ *    such as "DDR is one below PORT" still works and a test or benchmark program
+ *    can inspect or poke the registers after a driver has used them.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#ifndef _HOST_AVR_IO_H_
+#define _HOST_AVR_IO_H_
+
+#include <stdint.h>
+
+/// The size of the simulated I/O space; it covers the extended I/O of an ATmega1281
+#define SIM_IO_SIZE         0x200
+
+/// The simulated register file. It's defined in @c host/sim_regs.cpp
+extern uint8_t sim_io_mem[SIM_IO_SIZE];
+
+// Data-space addresses of the few registers whose behavior is simulated
+#define SIM_ADCSRA_ADDR     0x7A
+#define SIM_UCSR0A_ADDR     0xC0
+#define SIM_UCSR1A_ADDR     0xC8
+
+// This function, in sim_regs.cpp, finishes an A/D conversion which has been started
+void sim_adc_access (void);
+
+/** This function is called for every access to an 8-bit register. The address is a
+ *  constant wherever a register is named, so the compiler reduces the tests below to
+ *  nothing for all but the registers which need simulated behavior. The A/D finishes
+ *  a conversion as soon as its status register is looked at, and the USART transmit
+ *  buffers are always empty, so code which waits on either never waits long.
+ *  @param addr The data-space address of the register
+ *  @return A pointer to the register's byte in the simulated register file
+ */
+inline volatile uint8_t* sim_reg8 (uint16_t addr)
+{
+	if (addr == SIM_ADCSRA_ADDR)
+	{
+		sim_adc_access ();
+	}
+	else if (addr == SIM_UCSR0A_ADDR || addr == SIM_UCSR1A_ADDR)
+	{
+		sim_io_mem[addr] |= 0x60;           // UDREn and TXCn are always set
+	}
+	return (volatile uint8_t*)(sim_io_mem + addr);
+}
+
+// Accessors which turn a data-space address into an 8 or 16 bit register lvalue
+#define _SFR_MEM8(addr)     (*sim_reg8 (addr))
+#define _SFR_MEM16(addr)    (*(volatile uint16_t*)(sim_io_mem + (addr)))
+#define _SFR_IO8(addr)      _SFR_MEM8 ((addr) + 0x20)
+#define _SFR_IO16(addr)     _SFR_MEM16 ((addr) + 0x20)
+#define _BV(bit)            (1 << (bit))
+
+// General purpose I/O ports
+#define PINA    _SFR_IO8 (0x00)
+#define DDRA    _SFR_IO8 (0x01)
+#define PORTA   _SFR_IO8 (0x02)
+#define PINB    _SFR_IO8 (0x03)
+#define DDRB    _SFR_IO8 (0x04)
+#define PORTB   _SFR_IO8 (0x05)
+#define PINC    _SFR_IO8 (0x06)
+#define DDRC    _SFR_IO8 (0x07)
+#define PORTC   _SFR_IO8 (0x08)
+#define PIND    _SFR_IO8 (0x09)
+#define DDRD    _SFR_IO8 (0x0A)
+#define PORTD   _SFR_IO8 (0x0B)
+#define PINE    _SFR_IO8 (0x0C)
+#define DDRE    _SFR_IO8 (0x0D)
+#define PORTE   _SFR_IO8 (0x0E)
+#define PINF    _SFR_IO8 (0x0F)
+#define DDRF    _SFR_IO8 (0x10)
+#define PORTF   _SFR_IO8 (0x11)
+#define PING    _SFR_IO8 (0x12)
+#define DDRG    _SFR_IO8 (0x13)
+#define PORTG   _SFR_IO8 (0x14)
+
+// Interrupt flag registers and external interrupt control
+#define TIFR0   _SFR_IO8 (0x15)
+#define TIFR1   _SFR_IO8 (0x16)
+#define TIFR2   _SFR_IO8 (0x17)
+#define TIFR3   _SFR_IO8 (0x18)
+#define TIFR4   _SFR_IO8 (0x19)
+#define TIFR5   _SFR_IO8 (0x1A)
+#define EIFR    _SFR_IO8 (0x1C)
+#define EIMSK   _SFR_IO8 (0x1D)
+#define GPIOR0  _SFR_IO8 (0x1E)
+#define EECR    _SFR_IO8 (0x1F)
+#define EEDR    _SFR_IO8 (0x20)
+#define EEAR    _SFR_IO16 (0x21)
+#define GTCCR   _SFR_IO8 (0x23)
+#define TCCR0A  _SFR_IO8 (0x24)
+#define TCCR0B  _SFR_IO8 (0x25)
+#define TCNT0   _SFR_IO8 (0x26)
+#define OCR0A   _SFR_IO8 (0x27)
+#define OCR0B   _SFR_IO8 (0x28)
+#define SMCR    _SFR_IO8 (0x33)
+#define MCUSR   _SFR_IO8 (0x34)
+#define MCUCR   _SFR_IO8 (0x35)
+#define SREG    _SFR_IO8 (0x3F)
+
+// Extended I/O space
+#define WDTCSR  _SFR_MEM8 (0x60)
+#define EICRA   _SFR_MEM8 (0x69)
+#define EICRB   _SFR_MEM8 (0x6A)
+#define TIMSK0  _SFR_MEM8 (0x6E)
+#define TIMSK1  _SFR_MEM8 (0x6F)
+#define TIMSK2  _SFR_MEM8 (0x70)
+#define TIMSK3  _SFR_MEM8 (0x71)
+#define TIMSK4  _SFR_MEM8 (0x72)
+#define TIMSK5  _SFR_MEM8 (0x73)
+#define ADCW    _SFR_MEM16 (0x78)
+#define ADC     _SFR_MEM16 (0x78)
+#define ADCL    _SFR_MEM8 (0x78)
+#define ADCH    _SFR_MEM8 (0x79)
+#define ADCSRA  _SFR_MEM8 (0x7A)
+#define ADCSRB  _SFR_MEM8 (0x7B)
+#define ADMUX   _SFR_MEM8 (0x7C)
+#define DIDR0   _SFR_MEM8 (0x7E)
+#define TCCR1A  _SFR_MEM8 (0x80)
+#define TCCR1B  _SFR_MEM8 (0x81)
+#define TCCR1C  _SFR_MEM8 (0x82)
+#define TCNT1   _SFR_MEM16 (0x84)
+#define ICR1    _SFR_MEM16 (0x86)
+#define OCR1A   _SFR_MEM16 (0x88)
+#define OCR1B   _SFR_MEM16 (0x8A)
+#define OCR1C   _SFR_MEM16 (0x8C)
+#define TCCR3A  _SFR_MEM8 (0x90)
+#define TCCR3B  _SFR_MEM8 (0x91)
+#define TCCR3C  _SFR_MEM8 (0x92)
+#define TCNT3   _SFR_MEM16 (0x94)
+#define ICR3    _SFR_MEM16 (0x96)
+#define OCR3A   _SFR_MEM16 (0x98)
+#define OCR3B   _SFR_MEM16 (0x9A)
+#define OCR3C   _SFR_MEM16 (0x9C)
+#define TCCR4A  _SFR_MEM8 (0xA0)
+#define TCCR4B  _SFR_MEM8 (0xA1)
+#define TCCR4C  _SFR_MEM8 (0xA2)
+#define TCNT4   _SFR_MEM16 (0xA4)
+#define ICR4    _SFR_MEM16 (0xA6)
+#define OCR4A   _SFR_MEM16 (0xA8)
+#define OCR4B   _SFR_MEM16 (0xAA)
+#define OCR4C   _SFR_MEM16 (0xAC)
+#define TCCR2A  _SFR_MEM8 (0xB0)
+#define TCCR2B  _SFR_MEM8 (0xB1)
+#define TCNT2   _SFR_MEM8 (0xB2)
+#define OCR2A   _SFR_MEM8 (0xB3)
+#define OCR2B   _SFR_MEM8 (0xB4)
+#define UCSR0A  _SFR_MEM8 (0xC0)
+#define UCSR0B  _SFR_MEM8 (0xC1)
+#define UCSR0C  _SFR_MEM8 (0xC2)
+#define UBRR0   _SFR_MEM16 (0xC4)
+#define UDR0    _SFR_MEM8 (0xC6)
+#define UCSR1A  _SFR_MEM8 (0xC8)
+#define UCSR1B  _SFR_MEM8 (0xC9)
+#define UCSR1C  _SFR_MEM8 (0xCA)
+#define UBRR1   _SFR_MEM16 (0xCC)
+#define UDR1    _SFR_MEM8 (0xCE)
+#define TCCR5A  _SFR_MEM8 (0x120)
+#define TCCR5B  _SFR_MEM8 (0x121)
+#define TCCR5C  _SFR_MEM8 (0x122)
+#define TCNT5   _SFR_MEM16 (0x124)
+#define ICR5    _SFR_MEM16 (0x126)
+#define OCR5A   _SFR_MEM16 (0x128)
+#define OCR5B   _SFR_MEM16 (0x12A)
+#define OCR5C   _SFR_MEM16 (0x12C)
+
+// Port pin numbers. They're the same for every port, so only the generic names and
+// the ones used in this project are given
+#define PA0 0
+#define PA1 1
+#define PA2 2
+#define PA3 3
+#define PA4 4
+#define PA5 5
+#define PA6 6
+#define PA7 7
+#define PB0 0
+#define PB1 1
+#define PB2 2
+#define PB3 3
+#define PB4 4
+#define PB5 5
+#define PB6 6
+#define PB7 7
+#define PC0 0
+#define PC1 1
+#define PC2 2
+#define PC3 3
+#define PC4 4
+#define PC5 5
+#define PC6 6
+#define PC7 7
+#define PD0 0
+#define PD1 1
+#define PD2 2
+#define PD3 3
+#define PD4 4
+#define PD5 5
+#define PD6 6
+#define PD7 7
+#define PE0 0
+#define PE1 1
+#define PE2 2
+#define PE3 3
+#define PE4 4
+#define PE5 5
+#define PE6 6
+#define PE7 7
+
+// External interrupt bits
+#define INT0    0
+#define INT1    1
+#define INT2    2
+#define INT3    3
+#define INT4    4
+#define INT5    5
+#define INT6    6
+#define INT7    7
+#define ISC00   0
+#define ISC01   1
+#define ISC10   2
+#define ISC11   3
+#define ISC20   4
+#define ISC21   5
+#define ISC30   6
+#define ISC31   7
+#define ISC40   0
+#define ISC41   1
+#define ISC50   2
+#define ISC51   3
+#define ISC60   4
+#define ISC61   5
+#define ISC70   6
+#define ISC71   7
+
+// A/D converter bits
+#define MUX0    0
+#define MUX1    1
+#define MUX2    2
+#define MUX3    3
+#define MUX4    4
+#define ADLAR   5
+#define REFS0   6
+#define REFS1   7
+#define ADPS0   0
+#define ADPS1   1
+#define ADPS2   2
+#define ADIE    3
+#define ADIF    4
+#define ADATE   5
+#define ADSC    6
+#define ADEN    7
+#define ADTS0   0
+#define ADTS1   1
+#define ADTS2   2
+#define MUX5    3
+
+// Timer/counter bits; these are the same for timers 1, 3, 4 and 5
+#define WGM10   0
+#define WGM11   1
+#define COM1C0  2
+#define COM1C1  3
+#define COM1B0  4
+#define COM1B1  5
+#define COM1A0  6
+#define COM1A1  7
+#define CS10    0
+#define CS11    1
+#define CS12    2
+#define WGM12   3
+#define WGM13   4
+#define ICES1   6
+#define ICNC1   7
+#define TOIE1   0
+#define OCIE1A  1
+#define OCIE1B  2
+#define OCIE1C  3
+#define ICIE1   5
+#define TOV1    0
+#define OCF1A   1
+#define OCF1B   2
+#define OCF1C   3
+#define ICF1    5
+#define WGM30   0
+#define WGM31   1
+#define COM3C0  2
+#define COM3C1  3
+#define COM3B0  4
+#define COM3B1  5
+#define COM3A0  6
+#define COM3A1  7
+#define CS30    0
+#define CS31    1
+#define CS32    2
+#define WGM32   3
+#define WGM33   4
+#define WGM40   0
+#define WGM41   1
+#define CS40    0
+#define CS41    1
+#define CS42    2
+#define WGM42   3
+#define WGM43   4
+#define TOIE4   0
+#define OCIE4A  1
+#define TOV4    0
+#define OCF4A   1
+
+// Timer/counter 0 bits
+#define WGM00   0
+#define WGM01   1
+#define CS00    0
+#define CS01    1
+#define CS02    2
+#define WGM02   3
+#define TOIE0   0
+#define OCIE0A  1
+#define TOV0    0
+#define OCF0A   1
+
+// USART bits; these are the same for both USARTs
+#define MPCM0   0
+#define U2X0    1
+#define UPE0    2
+#define DOR0    3
+#define FE0     4
+#define UDRE0   5
+#define TXC0    6
+#define RXC0    7
+#define TXB80   0
+#define RXB80   1
+#define UCSZ02  2
+#define TXEN0   3
+#define RXEN0   4
+#define UDRIE0  5
+#define TXCIE0  6
+#define RXCIE0  7
+#define UCSZ00  1
+#define UCSZ01  2
+#define U2X1    1
+#define UDRE1   5
+#define TXC1    6
+#define RXC1    7
+#define TXEN1   3
+#define RXEN1   4
+#define UDRIE1  5
+#define TXCIE1  6
+#define RXCIE1  7
+#define UCSZ10  1
+#define UCSZ11  2
+
+// EEPROM control bits
+#define EERE    0
+#define EEPE    1
+#define EEMPE   2
+#define EERIE   3
+
+// Status register bits
+#define SREG_I  7
+
+// Sleep mode bits
+#define SE      0
+
+#endif // _HOST_AVR_IO_H_
@@ -0,0 +1,34 @@
+//*************************************************************************************
+/** @file host/avr/pgmspace.h
+ *    This file stands in for the avr-libc program memory header on a Linux host,
+ *    where there is only one address space; strings and tables which would live in
+ *    flash on the AVR are ordinary constants here.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#ifndef _HOST_AVR_PGMSPACE_H_
+#define _HOST_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(s)                 (s)
+#define pgm_read_byte(addr)     (*(const uint8_t*)(addr))
+#define pgm_read_word(addr)     (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr)    (*(const uint32_t*)(addr))
+#define pgm_read_ptr(addr)      (*(void* const*)(addr))
+#define strlen_P                strlen
+#define strcpy_P                strcpy
+#define strcmp_P                strcmp
+#define memcpy_P                memcpy
+
+typedef char prog_char;
+
+#endif // _HOST_AVR_PGMSPACE_H_
@@ -0,0 +1,27 @@
+//*************************************************************************************
+/** @file host/avr/wdt.h
+ *    This file stands in for the avr-libc watchdog header on a Linux host. Enabling
+ *    the watchdog, which the user interface does to reset the AVR, ends the program.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#ifndef _HOST_AVR_WDT_H_
+#define _HOST_AVR_WDT_H_
+
+#include <stdlib.h>
+
+#define WDTO_15MS           0
+#define WDTO_120MS          3
+#define WDTO_1S             6
+
+#define wdt_disable()
+#define wdt_reset()
+#define wdt_enable(timeout) exit (0)
+
+#endif // _HOST_AVR_WDT_H_
@@ -0,0 +1,97 @@
+//*************************************************************************************
+/** @file host/host_compat.cpp
+ *    This file contains host versions of the avr-libc number-to-string functions
+ *    which the ME405 library uses; see host_compat.h.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#include <stdio.h>
+
+#include "host_compat.h"
+
+
+//-------------------------------------------------------------------------------------
+/** This function converts an unsigned long to a string in any radix from 2 to 36,
+ *  which is what all the integer conversions below come down to.
+ *  @param value The number to be converted
+ *  @param p_str A buffer big enough for the digits and a terminating null
+ *  @param radix The base, from 2 to 36
+ *  @param negative True if a minus sign should be put in front of the digits
+ *  @return The pointer to the buffer
+ */
+
+static char* convert (unsigned long value, char* p_str, int radix, bool negative)
+{
+	char digits[8 * sizeof (long) + 1];
+	char* p_out = p_str;
+	int count = 0;
+
+	if (radix < 2 || radix > 36)
+	{
+		*p_str = '\0';
+		return p_str;
+	}
+	do
+	{
+		int digit = value % radix;
+		digits[count++] = (digit < 10) ? ('0' + digit) : ('a' + digit - 10);
+		value /= radix;
+	}
+	while (value != 0);
+
+	if (negative)
+	{
+		*p_out++ = '-';
+	}
+	while (count > 0)
+	{
+		*p_out++ = digits[--count];
+	}
+	*p_out = '\0';
+	return p_str;
+}
+
+
+char* itoa (int value, char* p_str, int radix)
+{
+	if (radix == 10 && value < 0)
+	{
+		return convert (-(unsigned long)(long)value, p_str, radix, true);
+	}
+	return convert ((unsigned int)value, p_str, radix, false);
+}
+
+
+char* utoa (unsigned int value, char* p_str, int radix)
+{
+	return convert (value, p_str, radix, false);
+}
+
+
+char* ltoa (long value, char* p_str, int radix)
+{
+	if (radix == 10 && value < 0)
+	{
+		return convert (-(unsigned long)value, p_str, radix, true);
+	}
+	return convert ((unsigned long)value, p_str, radix, false);
+}
+
+
+char* ultoa (unsigned long value, char* p_str, int radix)
+{
+	return convert (value, p_str, radix, false);
+}
+
+
+char* dtostrf (double value, signed char width, unsigned char precision, char* p_str)
+{
+	sprintf (p_str, "%*.*f", width, precision, value);
+	return p_str;
+}
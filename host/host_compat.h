@@ -0,0 +1,33 @@
+//*************************************************************************************
+/** @file host/host_compat.h
+ *    This file is included ahead of every source file in a host build (with the gcc
+ *    @c -include option). It declares the avr-libc extensions to the standard C
+ *    library, such as @c itoa() and @c dtostrf(), which the ME405 library uses to
+ *    print numbers but which glibc doesn't have. They're defined in host_compat.cpp.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#ifndef _HOST_COMPAT_H_
+#define _HOST_COMPAT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+char* itoa (int value, char* p_str, int radix);
+char* utoa (unsigned int value, char* p_str, int radix);
+char* ltoa (long value, char* p_str, int radix);
+char* ultoa (unsigned long value, char* p_str, int radix);
+char* dtostrf (double value, signed char width, unsigned char precision, char* p_str);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _HOST_COMPAT_H_
@@ -0,0 +1,401 @@
+//*************************************************************************************
+/** @file host/log_decode.cpp
+ *    This file contains a PC program which turns the binary log messages in the
+ *    AVR's telemetry stream back into text. The AVR only sends each message's number
+ *    and the raw bytes of its arguments; the format strings are kept in the @c .logstr
+ *    section of the ELF file, where a message's number is its string's address. So
+ *    the ELF file must be the one which is running on the AVR:
+ *
+ *        log_decode build/lab1.elf /dev/ttyUSB0
+ *
+ *    prints one line for each message, with the time at which it was logged:
+ *
+ *        1234 INFO  Encoder 1 constructor OK
+ *
+ *    Other telemetry packets, and text which the user interface prints among the
+ *    frames, are skipped, so this can read the same capture as @c telemetry_decode.
+ *    A message whose number isn't in the ELF file is printed as a number and its
+ *    arguments in hexadecimal.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <vector>
+
+#include "telemetry.h"                      // Packet formats and framing
+
+
+/// The name of the section which holds the format strings
+#define LOG_SECTION         ".logstr"
+
+/// The contents of the @c .logstr section; a message's string is at its number
+static std::vector<char> log_strings;
+
+/// Counts of messages printed, bad frames and lost packets
+static unsigned long messages = 0;
+static unsigned long bad_frames = 0;
+static unsigned long lost_packets = 0;
+
+/// Set when the user presses Ctrl-C, so that the counts are printed
+static volatile sig_atomic_t stop_now = 0;
+
+
+//-------------------------------------------------------------------------------------
+/** This function is called when the user presses Ctrl-C while reading a serial port.
+ */
+
+static void on_interrupt (int)
+{
+	stop_now = 1;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** These functions read little-endian numbers out of the ELF file's bytes.
+ *  @param file The whole ELF file
+ *  @param offset Where the number is
+ *  @return The number, or zero if it's past the end of the file
+ */
+
+static unsigned long read_16 (const std::vector<unsigned char>& file, unsigned long offset)
+{
+	if (offset + 2 > file.size ())
+	{
+		return 0;
+	}
+	return file[offset] | (file[offset + 1] << 8);
+}
+
+static unsigned long read_32 (const std::vector<unsigned char>& file, unsigned long offset)
+{
+	if (offset + 4 > file.size ())
+	{
+		return 0;
+	}
+	return read_16 (file, offset) | (read_16 (file, offset + 2) << 16);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function reads the @c .logstr section out of an ELF file. The AVR's ELF files
+ *  are 32-bit and little-endian, so only those are understood. The section starts at
+ *  address zero, but its address is subtracted anyway, so a different linker script
+ *  would still work.
+ *  @param p_name The name of the ELF file
+ *  @return True if the section was found
+ */
+
+static bool load_strings (const char* p_name)
+{
+	FILE* p_file = fopen (p_name, "rb");
+	if (p_file == NULL)
+	{
+		perror (p_name);
+		return false;
+	}
+	std::vector<unsigned char> file;
+	int a_byte;
+	while ((a_byte = fgetc (p_file)) != EOF)
+	{
+		file.push_back ((unsigned char)a_byte);
+	}
+	fclose (p_file);
+
+	// Check the identification: "\x7F" "ELF", 32-bit, little-endian
+	if (file.size () < 52 || memcmp (&file[0], "\x7F" "ELF", 4) != 0
+		|| file[4] != 1 || file[5] != 1)
+	{
+		fprintf (stderr, "%s: not a 32-bit little-endian ELF file\n", p_name);
+		return false;
+	}
+
+	// Find the section headers and the one holding the sections' names
+	unsigned long headers = read_32 (file, 32);
+	unsigned long header_size = read_16 (file, 46);
+	unsigned long count = read_16 (file, 48);
+	unsigned long names_index = read_16 (file, 50);
+	if (header_size < 40 || names_index >= count)
+	{
+		fprintf (stderr, "%s: no section names\n", p_name);
+		return false;
+	}
+	unsigned long names = read_32 (file, headers + names_index * header_size + 16);
+
+	for (unsigned long index = 0; index < count; index++)
+	{
+		unsigned long header = headers + index * header_size;
+		unsigned long name = names + read_32 (file, header);
+		if (name + sizeof (LOG_SECTION) > file.size ()
+			|| memcmp (&file[name], LOG_SECTION, sizeof (LOG_SECTION)) != 0)
+		{
+			continue;
+		}
+
+		unsigned long address = read_32 (file, header + 12);
+		unsigned long offset = read_32 (file, header + 16);
+		unsigned long size = read_32 (file, header + 20);
+		if (offset + size > file.size ())
+		{
+			break;
+		}
+		log_strings.assign (address, '\0');
+		log_strings.insert (log_strings.end (), file.begin () + offset,
+		                    file.begin () + offset + size);
+		log_strings.push_back ('\0');
+		return true;
+	}
+
+	fprintf (stderr, "%s: no %s section; was it linked with logstr.ld?\n", p_name,
+	         LOG_SECTION);
+	return false;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function prints a message's text, taking its arguments from the packet as
+ *  the format string calls for them: four bytes for a conversion with an @c l, as
+ *  in @c %ld, and two bytes for any other, which is how log.h stored them. Each
+ *  conversion is done by @c printf() with a @c long, so widths, flags and precisions
+ *  work as they would on the AVR. Strings can't be logged, so @c %s prints a @c ?.
+ *  @param p_format The format string, without its level letter
+ *  @param p_args The arguments
+ *  @param size The number of bytes of arguments
+ */
+
+static void print_message (const char* p_format, const uint8_t* p_args, uint8_t size)
+{
+	uint8_t used = 0;
+	while (*p_format)
+	{
+		if (*p_format != '%')
+		{
+			putchar (*p_format++);
+			continue;
+		}
+		if (p_format[1] == '%')
+		{
+			putchar ('%');
+			p_format += 2;
+			continue;
+		}
+
+		// Copy the flags, width and precision, leaving out the size letters
+		char spec[32] = "%";
+		size_t length = 1;
+		bool is_long = false;
+		p_format++;
+		while (*p_format && strchr ("-+ #0123456789.hl", *p_format))
+		{
+			if (*p_format == 'l')
+			{
+				is_long = true;
+			}
+			else if (*p_format != 'h' && length < sizeof (spec) - 3)
+			{
+				spec[length++] = *p_format;
+			}
+			p_format++;
+		}
+		char conversion = *p_format;
+		if (conversion == '\0')
+		{
+			break;
+		}
+		p_format++;
+
+		// Take the argument out of the packet, sign extending it if it's signed
+		uint8_t bytes = is_long ? 4 : 2;
+		if (used + bytes > size)
+		{
+			printf ("<missing>");
+			continue;
+		}
+		unsigned long value = p_args[used] | (p_args[used + 1] << 8);
+		if (is_long)
+		{
+			value |= (unsigned long)(p_args[used + 2] | (p_args[used + 3] << 8)) << 16;
+		}
+		used += bytes;
+		long signed_value = is_long ? (long)(int32_t)value : (long)(int16_t)value;
+
+		spec[length++] = 'l';
+		spec[length++] = conversion;
+		spec[length] = '\0';
+		switch (conversion)
+		{
+			case ('d'):
+			case ('i'):
+				printf (spec, signed_value);
+				break;
+			case ('u'):
+			case ('x'):
+			case ('X'):
+			case ('o'):
+				printf (spec, value);
+				break;
+			case ('c'):
+				putchar ((int)(value & 0xFF));
+				break;
+			default:
+				putchar ('?');
+				break;
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function checks a decoded packet and, if it's a log message, prints it.
+ *  @param p_packet The packet, including its CRC
+ *  @param length The number of bytes in the packet
+ */
+
+static void handle_packet (const uint8_t* p_packet, uint8_t length)
+{
+	static bool have_sequence = false;
+	static uint8_t next_sequence = 0;
+
+	if (length < sizeof (telem_header) + TELEM_CRC_SIZE)
+	{
+		bad_frames++;
+		return;
+	}
+	uint8_t size = length - TELEM_CRC_SIZE;
+	uint16_t crc = p_packet[size] | (p_packet[size + 1] << 8);
+	telem_header header;
+	memcpy (&header, p_packet, sizeof (header));
+	if (telem_crc (p_packet, size) != crc)
+	{
+		bad_frames++;
+		return;
+	}
+
+	// Every packet counts toward the sequence, so lost messages can be noticed
+	if (have_sequence)
+	{
+		lost_packets += (uint8_t)(header.sequence - next_sequence);
+	}
+	have_sequence = true;
+	next_sequence = header.sequence + 1;
+
+	if (header.type != TELEM_LOG || size < sizeof (header) + sizeof (uint16_t))
+	{
+		return;
+	}
+	const uint8_t* p_payload = p_packet + sizeof (header);
+	uint16_t id = p_payload[0] | (p_payload[1] << 8);
+	const uint8_t* p_args = p_payload + sizeof (uint16_t);
+	uint8_t arg_size = size - sizeof (header) - sizeof (uint16_t);
+	messages++;
+
+	printf ("%u ", header.time_ms);
+	if (id >= log_strings.size () || log_strings[id] == '\0')
+	{
+		printf ("? message %u", id);
+		for (uint8_t index = 0; index < arg_size; index++)
+		{
+			printf (" %02X", p_args[index]);
+		}
+		printf ("\n");
+		return;
+	}
+
+	// The first letter of the string is the message's level
+	const char* p_format = &log_strings[id];
+	switch (*p_format)
+	{
+		case ('E'): printf ("ERROR "); break;
+		case ('W'): printf ("WARN  "); break;
+		case ('I'): printf ("INFO  "); break;
+		case ('D'): printf ("DEBUG "); break;
+		default:    printf ("?     "); break;
+	}
+	print_message (p_format + 1, p_args, arg_size);
+	printf ("\n");
+	fflush (stdout);
+}
+
+
+//=====================================================================================
+/** The main function reads the format strings from the ELF file, then reads bytes
+ *  until the input ends, collecting them into frames at each zero byte and decoding
+ *  each frame.
+ *  @param argc The number of command line arguments
+ *  @param argv The ELF file's name, then the input file name, or "-" for standard
+ *              input
+ *  @return Zero if the input could be read, one if not
+ */
+
+int main (int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		fprintf (stderr, "Usage: %s <ELF file> <capture file, serial port, or ->\n",
+		         argv[0]);
+		return 1;
+	}
+	if (!load_strings (argv[1]))
+	{
+		return 1;
+	}
+
+	FILE* p_input = strcmp (argv[2], "-") ? fopen (argv[2], "rb") : stdin;
+	if (p_input == NULL)
+	{
+		perror (argv[2]);
+		return 1;
+	}
+	signal (SIGINT, on_interrupt);
+
+	uint8_t frame[TELEM_MAX_FRAME];
+	uint8_t packet[TELEM_MAX_FRAME];
+	unsigned int frame_size = 0;
+	bool overflow = false;
+	int a_byte;
+
+	while (!stop_now && (a_byte = fgetc (p_input)) != EOF)
+	{
+		if (a_byte != 0)
+		{
+			// A frame that's too long is text or noise; skip to the next zero
+			if (frame_size < sizeof (frame))
+			{
+				frame[frame_size++] = (uint8_t)a_byte;
+			}
+			else
+			{
+				overflow = true;
+			}
+			continue;
+		}
+
+		if (frame_size > 0)
+		{
+			uint8_t length = overflow ? 0
+			                 : telem_cobs_decode (frame, (uint8_t)frame_size, packet);
+			if (length > 0)
+			{
+				handle_packet (packet, length);
+			}
+			else
+			{
+				bad_frames++;
+			}
+		}
+		frame_size = 0;
+		overflow = false;
+	}
+
+	fprintf (stderr, "%lu messages, %lu bad frames, %lu packets lost\n",
+	         messages, bad_frames, lost_packets);
+
+	return 0;
+}
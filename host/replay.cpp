@@ -0,0 +1,313 @@
+//*************************************************************************************
+/** @file host/replay.cpp
+ *    This file contains a PC program which runs the motor task's control logic on a
+ *    recorded trace and writes out what it would have done to the motors. It's built
+ *    from the same @c axis.cpp and @c pid.cpp as the AVR program and uses the
+ *    parameters' initial values, so a run in which the vehicle misbehaved can be
+ *    replayed, and the outputs of a changed controller can be compared with the
+ *    recorded ones:
+ *
+ *        replay run1_trace.csv run1_out.csv
+ *
+ *    Each line of the trace is one run of the control loop. It holds the
+ *    potentiometer's A/D reading, then for each axis the command from the user
+ *    interface and the encoder's reading:
+ *
+ *        adc_0,mode_0,power_0,setpoint_0,position_0,velocity_0,mode_1,...
+ *
+ *    Lines which start with anything other than a digit or a minus sign, such as
+ *    headings and comments, are skipped. @c telemetry_decode writes a trace in this
+ *    form from the packets the AVR sends while its trace is on. Each line of the
+ *    output holds the run's number and each axis's power and brake flag:
+ *
+ *        run,power_0,brake_0,power_1,brake_1
+ *
+ *    The program has no timing of its own; runs go as fast as the PC can do them,
+ *    and the time they took is printed when they're done. With @c -r @c N the trace
+ *    is run @c N times from the start, which is handy for timing short traces, and
+ *    each time's outputs are checked against the first time's.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Traces come from the AVR's telemetry, through telemetry_decode
+ *    @li 10-17-2026 Gains and knob scaling are the parameters' initial values
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#include "axis.h"                           // The axes and their control step
+#include "params.h"                         // The gains and knob scaling
+
+
+/// The number of numbers in each line of a trace
+#define REPLAY_FIELDS       (1 + 5 * NUM_AXES)
+
+
+/** @brief   This structure holds one line of a trace: what the motor task read at
+ *           the start of one run of its loop.
+ */
+
+struct replay_input
+{
+	uint16_t adc;                           ///< The potentiometer's A/D reading
+	axis_command command[NUM_AXES];         ///< Each axis's command share
+	enc_reading reading[NUM_AXES];          ///< Each axis's encoder reading
+};
+
+
+/** @brief   This structure holds what the motor task did to the motors in one run.
+ */
+
+struct replay_output
+{
+	axis_output output[NUM_AXES];           ///< Each axis's power and brake
+};
+
+
+//-------------------------------------------------------------------------------------
+/** This function reads a line of a trace.
+ *  @param p_line The line, which must end with a null
+ *  @param input The place to put what the line holds
+ *  @return The number of numbers found, which is @c REPLAY_FIELDS if the line was
+ *          complete, or zero if it's a heading or comment or blank
+ */
+
+static int parse_line (const char* p_line, replay_input& input)
+{
+	while (*p_line == ' ' || *p_line == '\t')
+	{
+		p_line++;
+	}
+	if (*p_line != '-' && (*p_line < '0' || *p_line > '9'))
+	{
+		return 0;
+	}
+
+	long fields[REPLAY_FIELDS];
+	int count = 0;
+	while (count < REPLAY_FIELDS)
+	{
+		char* p_end;
+		fields[count] = strtol (p_line, &p_end, 10);
+		if (p_end == p_line)
+		{
+			break;
+		}
+		count++;
+		p_line = p_end;
+		while (*p_line == ' ' || *p_line == '\t')
+		{
+			p_line++;
+		}
+		if (*p_line != ',')
+		{
+			break;
+		}
+		p_line++;
+	}
+
+	if (count == REPLAY_FIELDS)
+	{
+		input.adc = (uint16_t)fields[0];
+		for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+		{
+			const long* p_field = fields + 1 + 5 * axis;
+			input.command[axis].mode = (uint8_t)p_field[0];
+			input.command[axis].power = (int16_t)p_field[1];
+			input.command[axis].setpoint = (int32_t)p_field[2];
+			input.reading[axis].position = (int32_t)p_field[3];
+			input.reading[axis].velocity = (int32_t)p_field[4];
+		}
+	}
+	return count;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function runs the whole trace through new axes, just as the motor task runs
+ *  each axis in each run of its loop, except that the commands and encoder readings
+ *  come from the trace and the motors aren't driven.
+ *  @param inputs The trace
+ *  @param outputs The place to put what was done in each run
+ */
+
+static void replay (const std::vector<replay_input>& inputs,
+                    std::vector<replay_output>& outputs)
+{
+	Axis axes[NUM_AXES];
+	pid_gains position_gains;
+	pid_gains velocity_gains;
+	axis_param_gains (position_gains, velocity_gains);
+	for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+	{
+		axes[axis].init (&axis_table[axis], position_gains, velocity_gains);
+	}
+
+	outputs.resize (inputs.size ());
+	for (size_t run = 0; run < inputs.size (); run++)
+	{
+		const replay_input& input = inputs[run];
+		for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+		{
+			axis_command command = axis_pot_command (input.command[axis], input.adc);
+			outputs[run].output[axis] = axes[axis].step (command, input.reading[axis]);
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function checks whether two replays did the same thing in every run.
+ *  @param first The outputs of one replay
+ *  @param second The outputs of another replay of the same trace
+ *  @return True if every power and brake flag is the same
+ */
+
+static bool same_outputs (const std::vector<replay_output>& first,
+                          const std::vector<replay_output>& second)
+{
+	for (size_t run = 0; run < first.size (); run++)
+	{
+		for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+		{
+			if (first[run].output[axis].power != second[run].output[axis].power
+				|| first[run].output[axis].brake != second[run].output[axis].brake)
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function finds the time from a monotonic clock.
+ *  @return The time in seconds
+ */
+
+static double seconds_now (void)
+{
+	struct timespec now;
+	clock_gettime (CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+
+//=====================================================================================
+/** The main function reads the whole trace, replays it, and writes the outputs.
+ *  @param argc The number of command line arguments
+ *  @param argv Optionally @c -r and a number of times to replay, then the trace file
+ *              name or "-" for standard input, and the output file name (default:
+ *              standard output)
+ *  @return Zero if the trace was replayed, one if it couldn't be read or a replay
+ *          didn't match the first one
+ */
+
+int main (int argc, char** argv)
+{
+	unsigned long repeats = 1;
+	int arg = 1;
+	if (arg + 1 < argc && strcmp (argv[arg], "-r") == 0)
+	{
+		repeats = strtoul (argv[arg + 1], NULL, 10);
+		arg += 2;
+	}
+	if (arg >= argc || repeats == 0)
+	{
+		fprintf (stderr, "Usage: %s [-r times] <trace file or -> [output file]\n",
+		         argv[0]);
+		return 1;
+	}
+
+	param_defaults ();
+
+	FILE* p_input = strcmp (argv[arg], "-") ? fopen (argv[arg], "r") : stdin;
+	if (p_input == NULL)
+	{
+		perror (argv[arg]);
+		return 1;
+	}
+
+	// Read the whole trace first, so the time taken by the replay doesn't include
+	// reading the file
+	std::vector<replay_input> inputs;
+	char line[512];
+	unsigned long line_number = 0;
+	while (fgets (line, sizeof (line), p_input) != NULL)
+	{
+		line_number++;
+		replay_input input;
+		int count = parse_line (line, input);
+		if (count == REPLAY_FIELDS)
+		{
+			inputs.push_back (input);
+		}
+		else if (count != 0)
+		{
+			fprintf (stderr, "%s:%lu: %d numbers instead of %d\n", argv[arg],
+			         line_number, count, REPLAY_FIELDS);
+			return 1;
+		}
+	}
+	if (p_input != stdin)
+	{
+		fclose (p_input);
+	}
+
+	std::vector<replay_output> outputs;
+	std::vector<replay_output> again;
+	double start = seconds_now ();
+	replay (inputs, outputs);
+	for (unsigned long time = 1; time < repeats; time++)
+	{
+		replay (inputs, again);
+		if (!same_outputs (outputs, again))
+		{
+			fprintf (stderr, "Replay %lu didn't match the first one\n", time + 1);
+			return 1;
+		}
+	}
+	double elapsed = seconds_now () - start;
+
+	FILE* p_output = (arg + 1 < argc) ? fopen (argv[arg + 1], "w") : stdout;
+	if (p_output == NULL)
+	{
+		perror (argv[arg + 1]);
+		return 1;
+	}
+	fprintf (p_output, "run");
+	for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+	{
+		fprintf (p_output, ",power_%u,brake_%u", axis, axis);
+	}
+	fprintf (p_output, "\n");
+	for (size_t run = 0; run < outputs.size (); run++)
+	{
+		fprintf (p_output, "%lu", (unsigned long)run);
+		for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+		{
+			fprintf (p_output, ",%d,%d", outputs[run].output[axis].power,
+			         outputs[run].output[axis].brake ? 1 : 0);
+		}
+		fprintf (p_output, "\n");
+	}
+	if (p_output != stdout)
+	{
+		fclose (p_output);
+	}
+
+	unsigned long runs = inputs.size () * repeats;
+	fprintf (stderr, "%lu runs in %.3f ms, %.1f ns per run\n", runs, elapsed * 1e3,
+	         runs ? elapsed * 1e9 / runs : 0.0);
+
+	return 0;
+}
@@ -0,0 +1,78 @@
+//*************************************************************************************
+/** @file host/sim_regs.cpp
+ *    This file contains the simulated AVR register file used when the drivers and
+ *    tasks are built for a Linux host, and the little bit of peripheral behavior
+ *    which keeps the drivers from waiting forever on hardware that isn't there.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#include <string.h>
+
+#include "sim_regs.h"
+
+
+/// The simulated register file, indexed by data-space address as on the ATmega1281
+uint8_t sim_io_mem[SIM_IO_SIZE];
+
+/// The readings the simulated A/D returns for each of its channels
+uint16_t sim_adc_input[8];
+
+/// The A/D complete ISR, if the program being built has one
+extern "C" void ADC_vect (void) __attribute__ ((weak));
+
+
+//-------------------------------------------------------------------------------------
+/** This function puts every simulated register back into its reset state, which for
+ *  the registers the drivers use is all zeros, and sets every A/D input to zero.
+ */
+
+void sim_reset (void)
+{
+	memset (sim_io_mem, 0, sizeof (sim_io_mem));
+	memset (sim_adc_input, 0, sizeof (sim_adc_input));
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function is called whenever ADCSRA is accessed. If the A/D is enabled and a
+ *  conversion has been started, the conversion finishes at once: the reading for the
+ *  selected channel goes into ADCW, ADSC is cleared and the interrupt flag is set.
+ */
+
+void sim_adc_access (void)
+{
+	uint8_t status = sim_io_mem[SIM_ADCSRA_ADDR];
+
+	if ((status & (1 << ADEN)) && (status & (1 << ADSC)))
+	{
+		ADCW = sim_adc_input[ADMUX & 0x07] & 0x03FF;
+		sim_io_mem[SIM_ADCSRA_ADDR] = (status & ~(1 << ADSC)) | (1 << ADIF);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function runs the A/D complete interrupt, as the AVR would, if the interrupt
+ *  is enabled and a conversion has finished. Calling it repeatedly steps a background
+ *  scan through its channel list one conversion at a time.
+ *  @return True if the ISR was run, false if it wasn't
+ */
+
+bool sim_adc_interrupt (void)
+{
+	uint8_t status = ADCSRA;                // Finishes any conversion in progress
+
+	if (ADC_vect && (status & (1 << ADIE)) && (status & (1 << ADIF)))
+	{
+		ADCSRA = status & ~(1 << ADIF);
+		ADC_vect ();
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,32 @@
+//*************************************************************************************
+/** @file host/sim_regs.h
+ *    This file contains the interface to the simulated AVR register file used when
+ *    the drivers and tasks are built for a Linux host. A test, benchmark or replay
+ *    program uses these functions to put the registers into their reset state, to
+ *    set the voltages the A/D converter will "measure," and to run the interrupts
+ *    whose flags the drivers have raised. Port pins are set by simply writing the
+ *    PIN registers, as in <tt> PINE = 0x20; INT5_vect (); </tt>
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#ifndef _HOST_SIM_REGS_H_
+#define _HOST_SIM_REGS_H_
+
+#include <avr/io.h>
+
+/// The readings, from 0 to 1023, which the simulated A/D returns for each channel
+extern uint16_t sim_adc_input[8];
+
+// This function puts every simulated register back into its reset state
+void sim_reset (void);
+
+// This function runs the A/D complete interrupt if it's enabled and its flag is set
+bool sim_adc_interrupt (void);
+
+#endif // _HOST_SIM_REGS_H_
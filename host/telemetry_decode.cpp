@@ -0,0 +1,378 @@
+//*************************************************************************************
+/** @file host/telemetry_decode.cpp
+ *    This file contains a PC program which decodes the binary telemetry stream sent
+ *    by the AVR's telemetry task and writes the samples into CSV files, one for each
+ *    type of packet. It reads a capture of the serial port, or the port itself:
+ *
+ *        telemetry_decode /dev/ttyUSB0 run1
+ *
+ *    writes run1_encoder.csv, run1_pwm.csv, run1_adc.csv, run1_timing.csv and
+ *    run1_profile.csv. The serial port must already be set to the right baud rate,
+ *    for example with stty.
+ *    If the motor task's trace was on, the traced runs are written to run1_trace.csv
+ *    in the form which host/replay reads, each with the commands the axes were
+ *    following. Runs which come before the decoder knows every axis's command are
+ *    left out, and a comment line says how many runs are missing wherever there's a
+ *    gap; replay skips it.
+ *    Text which the user interface prints among the frames is skipped. Frames which
+ *    fail their CRC are dropped and counted, and gaps in the sequence numbers are
+ *    counted as lost packets; the counts are printed when the input ends. Log
+ *    messages are counted but not written; @c log_decode turns them into text.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Decodes the tasks' loop profiles
+ *    @li 10-17-2026 Traced runs are written in the form which host/replay reads
+ *    @li 10-17-2026 Log message packets are checked and skipped
+ *    @li 10-17-2026 Writes a column for each of the TELEM_AXES axes
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+
+#include "telemetry.h"                      // Packet formats and framing
+
+
+/// The number of packet types, plus one because the codes start at one
+#define NUM_TYPES           9
+
+/// The names of the packet types which have their own CSV files, used in the file
+/// names. Log messages aren't written, and trace and command packets go together
+/// into the trace file
+static const char* type_names[NUM_TYPES] = { NULL, "encoder", "adc", "pwm", "timing",
+                                                "profile", NULL, NULL, NULL };
+
+/// The column headings of each type's CSV file, before any columns for the axes
+static const char* type_headings[NUM_TYPES] =
+{
+	NULL,
+	"time_ms,sequence",
+	"time_ms,sequence,adc_0,adc_1",
+	"time_ms,sequence",
+	"time_ms,sequence,loop_us,max_loop_us",
+	"time_ms,sequence,task,cpu_permille,max_exec_us,max_late_us,misses",
+	NULL, NULL, NULL
+};
+
+/// The heading of the column which each type has for each axis, numbered by axis
+static const char* type_axis_headings[NUM_TYPES] = { NULL, "position", NULL, "power",
+                                                        NULL, NULL, NULL, NULL, NULL };
+
+/// The payload size of each type of packet; a log message's size varies
+static const uint8_t type_sizes[NUM_TYPES] =
+{
+	0, sizeof (telem_encoder), sizeof (telem_adc), sizeof (telem_pwm),
+	sizeof (telem_timing), sizeof (telem_profile), sizeof (telem_trace),
+	sizeof (telem_command), 0
+};
+
+/// The CSV file for each type, opened when the first packet of that type arrives
+static FILE* csv_files[NUM_TYPES];
+
+/// The trace file, opened when the first run which can be written arrives
+static FILE* trace_file = NULL;
+
+/// The latest command for each axis, and which axes have had one
+static telem_command trace_commands[TELEM_AXES];
+static uint8_t commands_known = 0;
+
+/// Counts of good packets, bad frames and lost packets
+static unsigned long good_packets = 0;
+static unsigned long bad_frames = 0;
+static unsigned long lost_packets = 0;
+
+/// Set when the user presses Ctrl-C, so that the files are closed properly
+static volatile sig_atomic_t stop_now = 0;
+
+
+//-------------------------------------------------------------------------------------
+/** This function is called when the user presses Ctrl-C while reading a serial port.
+ */
+
+static void on_interrupt (int)
+{
+	stop_now = 1;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function writes a traced run into the trace file, as a line which host/replay
+ *  reads, or keeps the command from a command packet for the runs which follow it.
+ *  @param p_payload The packet's payload
+ *  @param type @c TELEM_TRACE or @c TELEM_COMMAND
+ *  @param prefix The start of the CSV file names
+ */
+
+static void handle_trace (const uint8_t* p_payload, uint8_t type, const char* prefix)
+{
+	static bool have_run = false;
+	static uint16_t next_run = 0;
+
+	if (type == TELEM_COMMAND)
+	{
+		telem_command command;
+		memcpy (&command, p_payload, sizeof (command));
+		if (command.axis < TELEM_AXES)
+		{
+			trace_commands[command.axis] = command;
+			commands_known |= (1 << command.axis);
+		}
+		return;
+	}
+
+	telem_trace run;
+	memcpy (&run, p_payload, sizeof (run));
+	if (commands_known != (1 << TELEM_AXES) - 1)
+	{
+		return;
+	}
+
+	if (trace_file == NULL)
+	{
+		char name[256];
+		snprintf (name, sizeof (name), "%s_trace.csv", prefix);
+		trace_file = fopen (name, "w");
+		if (trace_file == NULL)
+		{
+			perror (name);
+			return;
+		}
+		fprintf (trace_file, "adc_0");
+		for (uint8_t axis = 0; axis < TELEM_AXES; axis++)
+		{
+			fprintf (trace_file, ",mode_%u,power_%u,setpoint_%u,position_%u,velocity_%u",
+			         axis, axis, axis, axis, axis);
+		}
+		fprintf (trace_file, "\n");
+	}
+
+	if (have_run && run.run != next_run)
+	{
+		fprintf (trace_file, "# %u runs missing\n", (uint16_t)(run.run - next_run));
+	}
+	have_run = true;
+	next_run = run.run + 1;
+
+	fprintf (trace_file, "%u", run.adc);
+	for (uint8_t axis = 0; axis < TELEM_AXES; axis++)
+	{
+		fprintf (trace_file, ",%u,%d,%ld,%ld,%ld", trace_commands[axis].mode,
+		         trace_commands[axis].power, (long)trace_commands[axis].setpoint,
+		         (long)run.position[axis], (long)run.velocity[axis]);
+	}
+	fprintf (trace_file, "\n");
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function checks a decoded packet and writes its sample into the CSV file for
+ *  its type.
+ *  @param p_packet The packet, including its CRC
+ *  @param length The number of bytes in the packet
+ *  @param prefix The start of the CSV file names
+ */
+
+static void handle_packet (const uint8_t* p_packet, uint8_t length, const char* prefix)
+{
+	static bool have_sequence = false;
+	static uint8_t next_sequence = 0;
+
+	// Check the size and the CRC before trusting anything in the packet
+	if (length < sizeof (telem_header) + TELEM_CRC_SIZE)
+	{
+		bad_frames++;
+		return;
+	}
+	uint8_t size = length - TELEM_CRC_SIZE;
+	uint16_t crc = p_packet[size] | (p_packet[size + 1] << 8);
+	telem_header header;
+	memcpy (&header, p_packet, sizeof (header));
+	bool log_message = (header.type == TELEM_LOG);
+	if (telem_crc (p_packet, size) != crc || header.type == 0
+		|| header.type >= NUM_TYPES
+		|| (!log_message && size != sizeof (header) + type_sizes[header.type])
+		|| (log_message && size < sizeof (header) + sizeof (uint16_t)))
+	{
+		bad_frames++;
+		return;
+	}
+
+	good_packets++;
+	if (have_sequence)
+	{
+		lost_packets += (uint8_t)(header.sequence - next_sequence);
+	}
+	have_sequence = true;
+	next_sequence = header.sequence + 1;
+
+	// Log messages vary in size and need the ELF file to be read; log_decode does that
+	if (log_message)
+	{
+		return;
+	}
+
+	const uint8_t* p_payload = p_packet + sizeof (header);
+	if (header.type == TELEM_TRACE || header.type == TELEM_COMMAND)
+	{
+		handle_trace (p_payload, header.type, prefix);
+		return;
+	}
+
+	FILE*& p_file = csv_files[header.type];
+	if (p_file == NULL)
+	{
+		char name[256];
+		snprintf (name, sizeof (name), "%s_%s.csv", prefix, type_names[header.type]);
+		p_file = fopen (name, "w");
+		if (p_file == NULL)
+		{
+			perror (name);
+			return;
+		}
+		fprintf (p_file, "%s", type_headings[header.type]);
+		for (uint8_t axis = 0; type_axis_headings[header.type] != NULL
+		                       && axis < TELEM_AXES; axis++)
+		{
+			fprintf (p_file, ",%s_%u", type_axis_headings[header.type], axis);
+		}
+		fprintf (p_file, "\n");
+	}
+
+	fprintf (p_file, "%u,%u", header.time_ms, header.sequence);
+	switch (header.type)
+	{
+		case (TELEM_ENCODER):
+		{
+			telem_encoder sample;
+			memcpy (&sample, p_payload, sizeof (sample));
+			for (uint8_t axis = 0; axis < TELEM_AXES; axis++)
+			{
+				fprintf (p_file, ",%ld", (long)sample.position[axis]);
+			}
+			fprintf (p_file, "\n");
+			break;
+		}
+		case (TELEM_ADC):
+		{
+			telem_adc sample;
+			memcpy (&sample, p_payload, sizeof (sample));
+			fprintf (p_file, ",%u,%u\n", sample.reading[0], sample.reading[1]);
+			break;
+		}
+		case (TELEM_PWM):
+		{
+			telem_pwm sample;
+			memcpy (&sample, p_payload, sizeof (sample));
+			for (uint8_t axis = 0; axis < TELEM_AXES; axis++)
+			{
+				fprintf (p_file, ",%d", sample.power[axis]);
+			}
+			fprintf (p_file, "\n");
+			break;
+		}
+		case (TELEM_TIMING):
+		{
+			telem_timing sample;
+			memcpy (&sample, p_payload, sizeof (sample));
+			fprintf (p_file, ",%u,%u\n", sample.loop_us, sample.max_loop_us);
+			break;
+		}
+		case (TELEM_PROFILE):
+		{
+			telem_profile sample;
+			memcpy (&sample, p_payload, sizeof (sample));
+			fprintf (p_file, ",%u,%u,%u,%u,%u\n", sample.task, sample.cpu_permille,
+			         sample.max_exec_us, sample.max_late_us, sample.misses);
+			break;
+		}
+	}
+}
+
+
+//=====================================================================================
+/** The main function reads bytes until the input ends, collecting them into frames at
+ *  each zero byte and decoding each frame.
+ *  @param argc The number of command line arguments
+ *  @param argv The input file name, or "-" for standard input, and the prefix for the
+ *              CSV file names (default: "telemetry")
+ *  @return Zero if the input could be read, one if not
+ */
+
+int main (int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		fprintf (stderr, "Usage: %s <capture file, serial port, or -> [prefix]\n",
+		         argv[0]);
+		return 1;
+	}
+	const char* prefix = (argc > 2) ? argv[2] : "telemetry";
+
+	FILE* p_input = strcmp (argv[1], "-") ? fopen (argv[1], "rb") : stdin;
+	if (p_input == NULL)
+	{
+		perror (argv[1]);
+		return 1;
+	}
+	signal (SIGINT, on_interrupt);
+
+	uint8_t frame[TELEM_MAX_FRAME];
+	uint8_t packet[TELEM_MAX_FRAME];
+	unsigned int frame_size = 0;
+	bool overflow = false;
+	int a_byte;
+
+	while (!stop_now && (a_byte = fgetc (p_input)) != EOF)
+	{
+		if (a_byte != 0)
+		{
+			// A frame that's too long is text or noise; skip to the next zero
+			if (frame_size < sizeof (frame))
+			{
+				frame[frame_size++] = (uint8_t)a_byte;
+			}
+			else
+			{
+				overflow = true;
+			}
+			continue;
+		}
+
+		if (frame_size > 0)
+		{
+			uint8_t length = overflow ? 0
+			                 : telem_cobs_decode (frame, (uint8_t)frame_size, packet);
+			if (length > 0)
+			{
+				handle_packet (packet, length, prefix);
+			}
+			else
+			{
+				bad_frames++;
+			}
+		}
+		frame_size = 0;
+		overflow = false;
+	}
+
+	for (uint8_t type = 0; type < NUM_TYPES; type++)
+	{
+		if (csv_files[type] != NULL)
+		{
+			fclose (csv_files[type]);
+		}
+	}
+	if (trace_file != NULL)
+	{
+		fclose (trace_file);
+	}
+	fprintf (stderr, "%lu packets, %lu bad frames, %lu packets lost\n",
+	         good_packets, bad_frames, lost_packets);
+
+	return 0;
+}
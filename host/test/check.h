@@ -0,0 +1,47 @@
+//*************************************************************************************
+/** @file host/test/check.h
+ *    This file contains the checks which the unit tests use, and the tests which
+ *    @c test_main.cpp runs. A check which fails prints its file, line and condition
+ *    and is counted, and the tests carry on, so one run shows every failure.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _CHECK_H_
+#define _CHECK_H_
+
+
+/// Check that a condition is true
+#define CHECK(condition)                                                            \
+	check_that ((condition), #condition, __FILE__, __LINE__)
+
+/// Check that a number is within a tolerance of the one expected
+#define CHECK_NEAR(value, expected, tolerance)                                      \
+	check_near ((value), (expected), (tolerance), #value, __FILE__, __LINE__)
+
+
+// Count a check, and print it if it failed
+void check_that (bool passed, const char* p_text, const char* p_file, int line);
+
+// Count a check of a number, and print the number if it's too far from the one wanted
+void check_near (double value, double expected, double tolerance, const char* p_text,
+                 const char* p_file, int line);
+
+
+// The tests, one function for each file of them
+void test_encoder (void);
+void test_pid (void);
+void test_telemetry (void);
+void test_fixtrig (void);
+void test_odometry (void);
+void test_params (void);
+void test_relay_tune (void);
+void test_sysid (void);
+
+#endif // _CHECK_H_
@@ -0,0 +1,47 @@
+//*************************************************************************************
+/** @file host/test/stub/FreeRTOS.h
+ *    This file stands in for the FreeRTOS headers in the unit tests, which run the
+ *    modules under test without an RTOS. It has the types and macros the modules'
+ *    headers use, with the sizes they have on the AVR; task.h, queue.h and semphr.h
+ *    declare the few kernel functions which are called, and stub.cpp defines them.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _FREERTOS_H_
+#define _FREERTOS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+typedef uint16_t TickType_t;
+typedef int8_t BaseType_t;
+typedef uint8_t UBaseType_t;
+typedef void* TaskHandle_t;
+typedef void* QueueHandle_t;
+typedef void* SemaphoreHandle_t;
+
+#define portBASE_TYPE           char
+#define portMAX_DELAY           ((TickType_t)0xFFFF)
+#define portTICK_PERIOD_MS      1
+#define configTICK_RATE_HZ      1000
+#define configMAX_TASK_NAME_LEN 12
+#define pdTRUE                  1
+#define pdFALSE                 0
+#define pdPASS                  1
+
+// Nothing else runs in the tests, so there's nothing to hold off
+#define portENTER_CRITICAL()
+#define portEXIT_CRITICAL()
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+#define taskYIELD()
+
+#endif // _FREERTOS_H_
@@ -0,0 +1,43 @@
+//*************************************************************************************
+/** @file host/test/stub/baseshare.h
+ *    This file stands in for the ME405 library's base class of shared data items in
+ *    the unit tests. Shares aren't linked into a list here, since the tests don't
+ *    print them.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _BASESHARE_H_
+#define _BASESHARE_H_
+
+#include "emstream.h"                       // The stand-in stream
+
+
+/** @brief   This class stands in for the library's base class of shares, with the
+ *           members its derived classes use.
+ */
+
+class BaseShare
+{
+protected:
+	/// The share's name, which is printed in the list of shares
+	const char* name;
+
+	/// The next share in the list, which is always NULL here
+	BaseShare* p_next;
+
+public:
+	/// The constructor only keeps the name
+	BaseShare (const char* p_name = NULL) : name (p_name), p_next (NULL) { }
+
+	/// Each kind of share prints itself in the list of shares
+	virtual void print_in_list (emstream* p_ser_dev) = 0;
+};
+
+#endif // _BASESHARE_H_
@@ -0,0 +1,66 @@
+//*************************************************************************************
+/** @file host/test/stub/emstream.h
+ *    This file stands in for the ME405 library's serial stream header in the unit
+ *    tests. The tests don't print, so a stream here takes anything it's given and
+ *    throws it away; only what the modules under test use is declared.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _EMSTREAM_H_
+#define _EMSTREAM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <avr/pgmspace.h>
+
+
+/// The manipulators which the library's streams take, such as @c endl
+enum ser_manipulator {bin, oct, dec, hex, ascii, numeric, endl, clrscr, send_now};
+
+
+/** @brief   This class stands in for the library's base class of serial devices. Its
+ *           output operators do nothing; see stub.cpp.
+ */
+
+class emstream
+{
+public:
+	emstream (void) { }
+	virtual ~emstream (void) { }
+
+	virtual bool ready_to_send (void) { return true; }
+	virtual bool putchar (char) = 0;
+	virtual void puts (const char*) { }
+	virtual bool check_for_char (void) { return false; }
+	virtual char getchar (void) { return 0; }
+	virtual void transmit_now (void) { }
+	virtual void clear_screen (void) { }
+
+	emstream& operator << (const char*);
+	emstream& operator << (char);
+	emstream& operator << (bool);
+	emstream& operator << (uint8_t);
+	emstream& operator << (int8_t);
+	emstream& operator << (uint16_t);
+	emstream& operator << (int16_t);
+	emstream& operator << (uint32_t);
+	emstream& operator << (int32_t);
+	emstream& operator << (float);
+	emstream& operator << (ser_manipulator);
+};
+
+
+/// Strings go straight into RAM on the host, as they do in host/avr/pgmspace.h
+#define PMS(s) (s)
+
+/// Debugging output goes nowhere in the tests
+#define DBG(port, stuff)
+
+#endif // _EMSTREAM_H_
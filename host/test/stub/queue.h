@@ -0,0 +1,20 @@
+//*************************************************************************************
+/** @file host/test/stub/queue.h
+ *    This file stands in for the FreeRTOS queue header in the unit tests; see
+ *    FreeRTOS.h in this directory.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _QUEUE_H_
+#define _QUEUE_H_
+
+#include "FreeRTOS.h"                       // The stand-in types
+
+#endif // _QUEUE_H_
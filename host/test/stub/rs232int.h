@@ -0,0 +1,20 @@
+//*************************************************************************************
+/** @file host/test/stub/rs232int.h
+ *    This file stands in for the ME405 library's serial port header in the unit
+ *    tests, whose modules include it but never make a port.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _RS232INT_H_
+#define _RS232INT_H_
+
+#include "emstream.h"                       // The stand-in stream
+
+#endif // _RS232INT_H_
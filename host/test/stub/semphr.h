@@ -0,0 +1,20 @@
+//*************************************************************************************
+/** @file host/test/stub/semphr.h
+ *    This file stands in for the FreeRTOS semaphore header in the unit tests; see
+ *    FreeRTOS.h in this directory.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _SEMPHR_H_
+#define _SEMPHR_H_
+
+#include "FreeRTOS.h"                       // The stand-in types
+
+#endif // _SEMPHR_H_
@@ -0,0 +1,33 @@
+//*************************************************************************************
+/** @file host/test/stub/stub.cpp
+ *    This file defines what the stand-in library headers in this directory declare,
+ *    so the unit tests link without the ME405 library or an RTOS.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Defines the tick count, which the log reads
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#include "emstream.h"                       // The stand-in stream
+#include "task.h"                           // The stand-in tick count
+
+
+// A stream's output is thrown away, since the tests check values and not text
+emstream& emstream::operator << (const char*) { return *this; }
+emstream& emstream::operator << (char) { return *this; }
+emstream& emstream::operator << (bool) { return *this; }
+emstream& emstream::operator << (uint8_t) { return *this; }
+emstream& emstream::operator << (int8_t) { return *this; }
+emstream& emstream::operator << (uint16_t) { return *this; }
+emstream& emstream::operator << (int16_t) { return *this; }
+emstream& emstream::operator << (uint32_t) { return *this; }
+emstream& emstream::operator << (int32_t) { return *this; }
+emstream& emstream::operator << (float) { return *this; }
+emstream& emstream::operator << (ser_manipulator) { return *this; }
+
+// No time passes in the tests
+TickType_t xTaskGetTickCount (void) { return 0; }
@@ -0,0 +1,25 @@
+//*************************************************************************************
+/** @file host/test/stub/task.h
+ *    This file stands in for the FreeRTOS task header in the unit tests; see
+ *    FreeRTOS.h in this directory. The tick count stays at zero.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Declares the tick count, which the log reads
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _TASK_H_
+#define _TASK_H_
+
+#include "FreeRTOS.h"                       // The stand-in types
+
+
+// The time since the scheduler started, in ticks
+TickType_t xTaskGetTickCount (void);
+
+#endif // _TASK_H_
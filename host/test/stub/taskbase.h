@@ -0,0 +1,50 @@
+//*************************************************************************************
+/** @file host/test/stub/taskbase.h
+ *    This file stands in for the ME405 library's base task class in the unit tests.
+ *    Task classes' headers can be included, but no task is made or run here.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _TASKBASE_H_
+#define _TASKBASE_H_
+
+#include "emstream.h"                       // The stand-in stream
+#include "FreeRTOS.h"                       // The stand-in types
+
+
+/** @brief   This class stands in for the library's base task class, with the members
+ *           its derived classes use.
+ */
+
+class TaskBase
+{
+protected:
+	/// The number of times the task's loop has run
+	uint32_t runs;
+
+	/// The serial device to which the task can print
+	emstream* p_serial;
+
+	/// Delays do nothing here
+	void delay_ms (TickType_t) { }
+
+	/// Delays do nothing here
+	void delay_from_for_ms (TickType_t&, TickType_t) { }
+
+public:
+	/// The constructor only keeps the serial device
+	TaskBase (const char*, unsigned portBASE_TYPE, size_t, emstream* p_ser_dev = NULL)
+		: runs (0), p_serial (p_ser_dev) { }
+
+	/// Each task has a loop, which the tests don't run
+	virtual void run (void) = 0;
+};
+
+#endif // _TASKBASE_H_
@@ -0,0 +1,48 @@
+//*************************************************************************************
+/** @file host/test/stub/taskqueue.h
+ *    This file stands in for the ME405 library's queue template in the unit tests. A
+ *    queue here holds nothing; it's always empty, and what's put in it is dropped.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _TASKQUEUE_H_
+#define _TASKQUEUE_H_
+
+#include "baseshare.h"                      // The stand-in base class
+
+
+/** @brief   This class stands in for the library's queue, with the methods the
+ *           program's headers use.
+ */
+
+template <class dataType> class TaskQueue : public BaseShare
+{
+public:
+	/// The constructor only keeps the name
+	TaskQueue (BaseType_t, const char* p_name = NULL, TickType_t = 10)
+		: BaseShare (p_name) { }
+
+	/// Putting an item in the queue drops it
+	bool put (const dataType&) { return true; }
+
+	/// Putting an item in the queue drops it
+	bool ISR_put (const dataType&) { return true; }
+
+	/// The queue is always empty
+	bool is_empty (void) { return true; }
+
+	/// Getting an item gives one made by its default constructor
+	void get (dataType* p_item) { *p_item = dataType (); }
+
+	/// Nothing is printed in the list of shares
+	void print_in_list (emstream*) { }
+};
+
+#endif // _TASKQUEUE_H_
@@ -0,0 +1,51 @@
+//*************************************************************************************
+/** @file host/test/stub/taskshare.h
+ *    This file stands in for the ME405 library's shared data template in the unit
+ *    tests. A share here is a plain variable, since no other task can use it.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _TASKSHARE_H_
+#define _TASKSHARE_H_
+
+#include "baseshare.h"                      // The stand-in base class
+
+
+/** @brief   This class stands in for the library's share, with the methods the
+ *           program's headers use.
+ */
+
+template <class dataType> class TaskShare : public BaseShare
+{
+protected:
+	/// The data being shared
+	dataType the_data;
+
+public:
+	/// The constructor only keeps the name
+	TaskShare (const char* p_name = NULL) : BaseShare (p_name) { }
+
+	/// Put data into the share
+	void put (dataType new_data) { the_data = new_data; }
+
+	/// Put data into the share
+	void ISR_put (dataType new_data) { the_data = new_data; }
+
+	/// Get the data from the share
+	dataType get (void) { return the_data; }
+
+	/// Get the data from the share
+	dataType ISR_get (void) { return the_data; }
+
+	/// Nothing is printed in the list of shares
+	void print_in_list (emstream*) { }
+};
+
+#endif // _TASKSHARE_H_
@@ -0,0 +1,35 @@
+//*************************************************************************************
+/** @file host/test/stub/time_stamp.h
+ *    This file stands in for the ME405 library's time stamp class in the unit tests,
+ *    where every time stamp reads zero.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _TIME_STAMP_H_
+#define _TIME_STAMP_H_
+
+#include "emstream.h"                       // The stand-in stream
+
+
+/** @brief   This class stands in for the library's time stamp, with the methods the
+ *           program's headers use.
+ */
+
+class time_stamp
+{
+public:
+	/// Setting a time stamp to now does nothing
+	time_stamp& set_to_now (void) { return *this; }
+
+	/// Every time stamp is zero microseconds
+	uint32_t get_microsec (void) { return 0; }
+};
+
+#endif // _TIME_STAMP_H_
@@ -0,0 +1,104 @@
+//*************************************************************************************
+/** @file host/test/test_encoder.cpp
+ *    This file contains a test of the encoder driver's transition table, run through
+ *    the encoder's interrupt with the host's simulated pins.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#include <avr/io.h>                         // The simulated pins
+#include <avr/interrupt.h>                  // The encoder's interrupt, to call
+
+#include "check.h"                          // The checks
+#include "encoder_dr.h"                     // The driver being tested
+
+
+// The interrupt which decodes encoder 0, which on the host is a plain function
+extern "C" void INT5_vect (void);
+
+
+/// The order the channels' states go in when the encoder turns forwards, as (B << 1)
+/// | A; each is one step of a Gray code from the one before
+static const uint8_t forward[4] = { 0, 1, 3, 2 };
+
+
+//-------------------------------------------------------------------------------------
+/** This function sets encoder 0's channels and runs its interrupt.
+ *  @param state The new state of the channels, as (B << 1) | A
+ */
+
+static void set_channels (uint8_t state)
+{
+	PINE = (PINE & ~(0x03 << PE5)) | (state << PE5);
+	INT5_vect ();
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function finds how the count should change between two states: up one for a
+ *  step forwards along the Gray code, down one for a step back, and nothing if
+ *  neither channel changed or both did, which can't be told apart.
+ *  @param from The channels' old state
+ *  @param to The channels' new state
+ *  @return The change in the count
+ */
+
+static int8_t expected_change (uint8_t from, uint8_t to)
+{
+	uint8_t place = 0;
+	while (forward[place] != from)
+	{
+		place++;
+	}
+	if (forward[(place + 1) & 0x03] == to)
+	{
+		return 1;
+	}
+	if (forward[(place + 3) & 0x03] == to)
+	{
+		return -1;
+	}
+	return 0;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function tests every one of the sixteen transitions against the Gray code,
+ *  then turns the encoder a few cycles each way.
+ */
+
+void test_encoder (void)
+{
+	PINE &= ~(0x03 << PE5);
+	Encoder_dr encoder (NULL, 0, &EICRB, ISC50, ISC60, &EIMSK, INT5, INT6, &PORTE, PE5);
+	CHECK (encoder.get_position () == 0);
+
+	for (uint8_t from = 0; from < 4; from++)
+	{
+		for (uint8_t to = 0; to < 4; to++)
+		{
+			set_channels (from);
+			int32_t before = encoder.get_position ();
+			set_channels (to);
+			CHECK (encoder.get_position () - before == expected_change (from, to));
+		}
+	}
+
+	set_channels (0);
+	encoder.set_position (0);
+	for (uint8_t step = 1; step <= 12; step++)
+	{
+		set_channels (forward[step & 0x03]);
+	}
+	CHECK (encoder.get_position () == 12);
+	for (uint8_t step = 1; step <= 20; step++)
+	{
+		set_channels (forward[(12 - step) & 0x03]);
+	}
+	CHECK (encoder.get_position () == -8);
+}
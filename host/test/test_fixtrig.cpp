@@ -0,0 +1,56 @@
+//*************************************************************************************
+/** @file host/test/test_fixtrig.cpp
+ *    This file contains tests of the fixed-point sine and cosine.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#include <math.h>
+
+#include "check.h"                          // The checks
+#include "fixtrig.h"                        // The functions being tested
+
+
+/// The largest error allowed in a sine or cosine, in parts of 16384
+#define FIX_TRIG_MAX_ERROR  3
+
+
+//-------------------------------------------------------------------------------------
+/** This function compares the sine and cosine of every binary angle with the C
+ *  library's, and checks the values at the quarter turns exactly.
+ */
+
+void test_fixtrig (void)
+{
+	CHECK (fix_sin (0) == 0);
+	CHECK (fix_sin (FIX_QUARTER_TURN) == (1 << FIX_TRIG_BITS));
+	CHECK (fix_sin (2 * FIX_QUARTER_TURN) == 0);
+	CHECK (fix_sin (3 * FIX_QUARTER_TURN) == -(1 << FIX_TRIG_BITS));
+	CHECK (fix_cos (0) == (1 << FIX_TRIG_BITS));
+
+	long worst_sin = 0;
+	long worst_cos = 0;
+	for (uint32_t angle = 0; angle < 65536UL; angle++)
+	{
+		double radians = 2.0 * M_PI * angle / 65536.0;
+		long sin_error = labs (fix_sin ((uint16_t)angle)
+		                       - lround ((1 << FIX_TRIG_BITS) * sin (radians)));
+		long cos_error = labs (fix_cos ((uint16_t)angle)
+		                       - lround ((1 << FIX_TRIG_BITS) * cos (radians)));
+		if (sin_error > worst_sin)
+		{
+			worst_sin = sin_error;
+		}
+		if (cos_error > worst_cos)
+		{
+			worst_cos = cos_error;
+		}
+	}
+	CHECK (worst_sin <= FIX_TRIG_MAX_ERROR);
+	CHECK (worst_cos <= FIX_TRIG_MAX_ERROR);
+}
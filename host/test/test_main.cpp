@@ -0,0 +1,87 @@
+//*************************************************************************************
+/** @file host/test/test_main.cpp
+ *    This file contains the main function of the unit tests, which runs each file of
+ *    tests in turn on the PC and says how many checks failed. @c make @c test builds
+ *    and runs it.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#include <stdio.h>
+#include <math.h>
+
+#include "check.h"                          // The checks and the tests
+
+
+/// Counts of the checks made and of those which failed
+static unsigned long checks_run = 0;
+static unsigned long checks_failed = 0;
+
+
+//-------------------------------------------------------------------------------------
+/** This function counts a check, and prints it if it failed.
+ *  @param passed True if the check passed
+ *  @param p_text The condition which was checked
+ *  @param p_file The file in which the check is
+ *  @param line The line on which the check is
+ */
+
+void check_that (bool passed, const char* p_text, const char* p_file, int line)
+{
+	checks_run++;
+	if (!passed)
+	{
+		checks_failed++;
+		printf ("%s:%d: check failed: %s\n", p_file, line, p_text);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function counts a check of a number, and prints the number and the one which
+ *  was expected if they're too far apart.
+ *  @param value The number which was found
+ *  @param expected The number which should have been found
+ *  @param tolerance How far apart they may be
+ *  @param p_text The expression which gave the number
+ *  @param p_file The file in which the check is
+ *  @param line The line on which the check is
+ */
+
+void check_near (double value, double expected, double tolerance, const char* p_text,
+                 const char* p_file, int line)
+{
+	checks_run++;
+	if (!(fabs (value - expected) <= tolerance))
+	{
+		checks_failed++;
+		printf ("%s:%d: %s is %g, not %g within %g\n", p_file, line, p_text, value,
+		        expected, tolerance);
+	}
+}
+
+
+//=====================================================================================
+/** The main function runs all the tests.
+ *  @return Zero if every check passed, one if any failed
+ */
+
+int main (void)
+{
+	test_encoder ();
+	test_pid ();
+	test_telemetry ();
+	test_fixtrig ();
+	test_odometry ();
+	test_params ();
+	test_relay_tune ();
+	test_sysid ();
+
+	printf ("%lu checks, %lu failed\n", checks_run, checks_failed);
+	return checks_failed ? 1 : 0;
+}
@@ -0,0 +1,59 @@
+//*************************************************************************************
+/** @file host/test/test_odometry.cpp
+ *    This file contains tests of the odometry on a straight line and on an arc,
+ *    compared with the geometry worked out in floating point.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#include <math.h>
+
+#include "check.h"                          // The checks
+#include "odometry.h"                       // The odometry being tested
+
+
+/// The distance a wheel moves for one count, in micrometres
+#define UM_PER_COUNT        (M_PI * ODO_WHEEL_DIA_UM / ODO_COUNTS_PER_REV)
+
+
+//-------------------------------------------------------------------------------------
+/** This function drives both wheels one turn, a count at a time as the odometry task
+ *  sees them, then drives the right wheel twice as fast as the left through a
+ *  quarter turn of the vehicle, and checks the poses.
+ */
+
+void test_odometry (void)
+{
+	// Straight ahead for one turn of the wheels: the distance is the wheels'
+	// circumference, and there's no sideways drift or turn at all
+	Odometry straight (1000, -1000);
+	for (int32_t count = 1; count <= ODO_COUNTS_PER_REV; count++)
+	{
+		straight.update (1000 + count, -1000 + count);
+	}
+	odo_pose pose = straight.get_pose ();
+	CHECK_NEAR (pose.x, M_PI * ODO_WHEEL_DIA_UM, 20.0);
+	CHECK (pose.y == 0);
+	CHECK (pose.heading == 0);
+
+	// The right wheel twice as fast as the left makes a circle whose centre is three
+	// half-tracks to the left of the vehicle's centre. The turn is the difference
+	// in the wheels' distances over the track
+	const int32_t runs = 1662;
+	Odometry arc (0, 0);
+	for (int32_t run = 1; run <= runs; run++)
+	{
+		arc.update (run, 2 * run);
+	}
+	double radius = 3.0 * ODO_TRACK_UM / 2.0;
+	double turn = runs * UM_PER_COUNT / ODO_TRACK_UM;
+	pose = arc.get_pose ();
+	CHECK_NEAR (pose.x, radius * sin (turn), 100.0);
+	CHECK_NEAR (pose.y, radius * (1.0 - cos (turn)), 100.0);
+	CHECK_NEAR (pose.heading, turn * 65536.0 / (2.0 * M_PI), 2.0);
+}
@@ -0,0 +1,64 @@
+//*************************************************************************************
+/** @file host/test/test_params.cpp
+ *    This file contains tests of saving the parameters in the EEPROM, loading them,
+ *    and refusing a saved record which has been damaged.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#include <avr/eeprom.h>                     // The host's EEPROM, to damage the record
+
+#include "check.h"                          // The checks
+#include "params.h"                         // The parameters being tested
+#include "task_motor.h"                     // The gains' initial values
+
+
+//-------------------------------------------------------------------------------------
+/** This function checks that a blank EEPROM gives the initial values, that a saved
+ *  value comes back, and that flipping one bit of a saved value makes the load fail
+ *  because the CRC no longer matches, leaving every parameter at its initial value.
+ */
+
+void test_params (void)
+{
+	CHECK (!param_load ());
+	CHECK (param_get (PARAM_POS_KP) == MOTOR_POS_KP);
+
+	CHECK (param_set (PARAM_POS_KP, 300));
+	CHECK (param_set (PARAM_VEL_KD, 5));
+	param_save ();
+	param_defaults ();
+	CHECK (param_get (PARAM_POS_KP) == MOTOR_POS_KP);
+	CHECK (param_load ());
+	CHECK (param_get (PARAM_POS_KP) == 300);
+	CHECK (param_get (PARAM_VEL_KD) == 5);
+
+	host_eeprom_block& block = host_eeprom_last_block ();
+	CHECK (block.p_start != NULL && block.size > 12);
+	if (block.p_start == NULL || block.size <= 12)
+	{
+		return;
+	}
+	uint8_t* p_record = (uint8_t*)block.p_start;
+
+	// A bit flipped in one of the first few values; the record's layout isn't known
+	// here, but the values start within its first four bytes on both the AVR and
+	// the PC and take four bytes each
+	for (uint8_t index = 6; index < 12; index += 4)
+	{
+		p_record[index] ^= 0x10;
+		CHECK (!param_load ());
+		CHECK (param_get (PARAM_POS_KP) == MOTOR_POS_KP);
+		CHECK (param_get (PARAM_VEL_KD) != 5);
+		p_record[index] ^= 0x10;
+		CHECK (param_load ());
+		CHECK (param_get (PARAM_POS_KP) == 300);
+	}
+
+	param_defaults ();
+}
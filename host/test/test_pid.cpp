@@ -0,0 +1,64 @@
+//*************************************************************************************
+/** @file host/test/test_pid.cpp
+ *    This file contains tests of the PID controller's saturation and of the
+ *    conditional integration which keeps its integral from winding up.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#include "check.h"                          // The checks
+#include "pid.h"                            // The controller being tested
+
+
+//-------------------------------------------------------------------------------------
+/** This function tests that the output is limited both ways, and that the integral
+ *  stops growing once the output is saturated, so the controller comes out of
+ *  saturation as soon as the error changes sign.
+ */
+
+void test_pid (void)
+{
+	// A huge error in either direction gives exactly the limit
+	PID saturated (512, 10, 0);
+	CHECK (saturated.update (100000L, 0) == MOTOR_POWER_MAX);
+	CHECK (saturated.update (-100000L, 0) == -MOTOR_POWER_MAX);
+
+	PID limited (512, 10, 0, 2, 100);
+	CHECK (limited.update (100000L, 0) == 100);
+	CHECK (limited.update (-100000L, 0) == -100);
+
+	// While the proportional term alone saturates the output, the integral isn't
+	// added to at all, and the output falls to zero the moment the error does
+	PID stalled (256, 64, 0);
+	for (uint16_t run = 0; run < 1000; run++)
+	{
+		CHECK (stalled.update (1000, 0) == MOTOR_POWER_MAX);
+	}
+	CHECK (stalled.get_integral () == 0);
+	CHECK (stalled.update (0, 0) == 0);
+
+	// An error of 100 with a gain of 1.0 gives 100 from the proportional term, and
+	// the integral grows by 25 each run. It stops within one run of the 155 which
+	// saturates the output rather than going on to the limit, so once the error
+	// reverses, the output changes sign in four runs instead of seven
+	PID winding (256, 64, 0);
+	for (uint16_t run = 0; run < 1000; run++)
+	{
+		winding.update (100, 0);
+	}
+	CHECK (winding.get_output () == MOTOR_POWER_MAX);
+	CHECK (winding.get_integral () >= MOTOR_POWER_MAX - 100);
+	CHECK (winding.get_integral () <= MOTOR_POWER_MAX - 100 + 25);
+
+	uint16_t runs_to_reverse = 0;
+	while (winding.update (-100, 0) >= 0 && runs_to_reverse < 1000)
+	{
+		runs_to_reverse++;
+	}
+	CHECK (runs_to_reverse <= 4);
+}
@@ -0,0 +1,61 @@
+//*************************************************************************************
+/** @file host/test/test_relay_tune.cpp
+ *    This file contains a test of the relay autotuner on an oscillation whose size
+ *    and period are known.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#include <math.h>
+
+#include "check.h"                          // The checks
+#include "relay_tune.h"                     // The tuner being tested
+
+
+/// The synthetic oscillation's size in counts and its period in runs
+#define TEST_AMPLITUDE      200
+#define TEST_PERIOD         100
+
+/// The relay's power
+#define TEST_POWER          80
+
+
+//-------------------------------------------------------------------------------------
+/** This function gives the tuner a position which swings as a sine around where it
+ *  started, whatever the relay does, and checks that it finds the sine's period for
+ *  Tu and the relay's describing function, Ku = 4 d / (pi a), for Ku.
+ */
+
+void test_relay_tune (void)
+{
+	const int32_t center = 5000;
+	Relay_tune tuner;
+	tuner.begin (center, TEST_POWER);
+	CHECK (tuner.is_running ());
+
+	uint16_t run = 0;
+	while (tuner.is_running () && run < 10 * TEST_PERIOD)
+	{
+		int32_t position = center + lround (TEST_AMPLITUDE
+		                                    * sin (2.0 * M_PI * run / TEST_PERIOD));
+		int16_t power = tuner.step (position);
+		if (tuner.is_running ())
+		{
+			CHECK (power == TEST_POWER || power == -TEST_POWER);
+		}
+		run++;
+	}
+
+	const tune_result& result = tuner.get_result ();
+	CHECK (result.state == TUNE_DONE);
+	CHECK (result.t_u == TEST_PERIOD);
+	CHECK (result.amplitude == TEST_AMPLITUDE);
+	CHECK_NEAR (result.k_u, 256.0 * 4.0 * TEST_POWER / (M_PI * TEST_AMPLITUDE), 1.0);
+	CHECK (result.gains.k_p == result.k_u * TUNE_KP_NUM / TUNE_KP_DEN);
+	CHECK (tuner.step (center) == 0);
+}
@@ -0,0 +1,67 @@
+//*************************************************************************************
+/** @file host/test/test_sysid.cpp
+ *    This file contains a test of the system identification experiment's PRBS.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#include "check.h"                          // The checks
+#include "sysid.h"                          // The experiment being tested
+
+
+/// The PRBS's period; a 9-bit shift register with the right taps goes through every
+/// state but zero
+#define TEST_PRBS_PERIOD    ((1 << SYSID_LFSR_BITS) - 1)
+
+
+//-------------------------------------------------------------------------------------
+/** This function runs a PRBS with each bit held for one run through two periods, and
+ *  checks that it repeats after 511 bits and not after either of 511's factors, and
+ *  that each period has one more high bit than low, as a maximal length sequence does.
+ */
+
+void test_sysid (void)
+{
+	sysid_setup setup;
+	setup.signal = SYSID_PRBS;
+	setup.offset = 0;
+	setup.hold = 1;
+	setup.every = 4;
+	setup.chirp_hz = 1;
+	setup.loop_hz = 1000;
+
+	// With four runs in each sample, the buffer holds more than two periods
+	Sysid experiment;
+	experiment.begin (0, 100, setup);
+	CHECK (experiment.is_running ());
+
+	static int16_t powers[2 * TEST_PRBS_PERIOD];
+	for (uint16_t run = 0; run < 2 * TEST_PRBS_PERIOD; run++)
+	{
+		powers[run] = experiment.step (0);
+	}
+	CHECK (experiment.is_running ());
+	experiment.stop ();
+
+	uint16_t highs = 0;
+	uint16_t repeats = 0;
+	uint16_t repeats_7 = 0;
+	uint16_t repeats_73 = 0;
+	for (uint16_t run = 0; run < TEST_PRBS_PERIOD; run++)
+	{
+		CHECK (powers[run] == 100 || powers[run] == -100);
+		highs += (powers[run] > 0);
+		repeats += (powers[run] == powers[run + TEST_PRBS_PERIOD]);
+		repeats_7 += (powers[run] == powers[run + 7]);
+		repeats_73 += (powers[run] == powers[run + 73]);
+	}
+	CHECK (highs == (TEST_PRBS_PERIOD + 1) / 2);
+	CHECK (repeats == TEST_PRBS_PERIOD);
+	CHECK (repeats_7 < TEST_PRBS_PERIOD);
+	CHECK (repeats_73 < TEST_PRBS_PERIOD);
+}
@@ -0,0 +1,80 @@
+//*************************************************************************************
+/** @file host/test/test_telemetry.cpp
+ *    This file contains tests of the telemetry protocol's CRC and COBS framing, which
+ *    the AVR and the decoders share through telemetry.h.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#include <string.h>
+
+#include "check.h"                          // The checks
+#include "telemetry.h"                      // The CRC and the framing
+
+
+//-------------------------------------------------------------------------------------
+/** This function encodes a packet, checks that the frame has no zeros in it, and
+ *  checks that it decodes to the same packet.
+ *  @param p_packet The packet
+ *  @param length The number of bytes in it
+ */
+
+static void check_round_trip (const uint8_t* p_packet, uint8_t length)
+{
+	uint8_t frame[256];
+	uint8_t decoded[256];
+
+	uint8_t frame_size = telem_cobs_encode (p_packet, length, frame);
+	CHECK (frame_size == length + 1);
+	CHECK (memchr (frame, 0, frame_size) == NULL);
+
+	uint8_t decoded_size = telem_cobs_decode (frame, frame_size, decoded);
+	CHECK (decoded_size == length);
+	CHECK (memcmp (decoded, p_packet, length) == 0);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function tests the CRC against the standard check value, then sends packets
+ *  with no zeros, all zeros and zeros at the ends through the framing and back, and
+ *  checks that a damaged frame is refused.
+ */
+
+void test_telemetry (void)
+{
+	// CRC-CCITT from 0xFFFF, bit reversed as _crc_ccitt_update() does it, gives
+	// 0x6F91 for the usual check string
+	const uint8_t check_string[] = "123456789";
+	CHECK (telem_crc (check_string, 9) == 0x6F91);
+	CHECK (telem_crc (check_string, 0) == 0xFFFF);
+
+	uint8_t packet[TELEM_MAX_PACKET];
+	for (uint8_t index = 0; index < sizeof (packet); index++)
+	{
+		packet[index] = index + 1;
+	}
+	check_round_trip (packet, sizeof (packet));
+
+	memset (packet, 0, sizeof (packet));
+	check_round_trip (packet, sizeof (packet));
+
+	for (uint8_t index = 0; index < sizeof (packet); index++)
+	{
+		packet[index] = (index % 3 == 0) ? 0 : 0x55;
+	}
+	packet[sizeof (packet) - 1] = 0;
+	check_round_trip (packet, sizeof (packet));
+	check_round_trip (packet, 1);
+
+	// A frame whose first code points past its end isn't valid COBS
+	uint8_t frame[TELEM_MAX_FRAME];
+	uint8_t decoded[TELEM_MAX_FRAME];
+	uint8_t frame_size = telem_cobs_encode (packet, 6, frame);
+	frame[0] = frame_size + 1;
+	CHECK (telem_cobs_decode (frame, frame_size, decoded) == 0);
+}
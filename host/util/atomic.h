@@ -0,0 +1,31 @@
+//*************************************************************************************
+/** @file host/util/atomic.h
+ *    This file stands in for the avr-libc atomic block header on a Linux host. The
+ *    drivers' "interrupts" are called by the host program from the same thread as
+ *    the code they interrupt, so an atomic block only needs to clear the simulated
+ *    global interrupt enable bit and put it back afterwards.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#ifndef _HOST_UTIL_ATOMIC_H_
+#define _HOST_UTIL_ATOMIC_H_
+
+#include <avr/interrupt.h>
+
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_FORCEON
+#define NONATOMIC_RESTORESTATE
+#define NONATOMIC_FORCEOFF
+
+#define ATOMIC_BLOCK(type)      for (uint8_t _sreg_save = SREG, _todo = (cli (), 1); \
+                                     _todo; _todo = 0, SREG = _sreg_save)
+#define NONATOMIC_BLOCK(type)   for (uint8_t _sreg_save = SREG, _todo = (sei (), 1); \
+                                     _todo; _todo = 0, SREG = _sreg_save)
+
+#endif // _HOST_UTIL_ATOMIC_H_
@@ -0,0 +1,34 @@
+//*************************************************************************************
+/** @file host/util/crc16.h
+ *    This file stands in for the avr-libc CRC header on a Linux host. The function is
+ *    the C equivalent of avr-libc's inline assembly, as given in its documentation, so
+ *    the host computes the same CRC's as the AVR.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#ifndef _HOST_UTIL_CRC16_H_
+#define _HOST_UTIL_CRC16_H_
+
+#include <stdint.h>
+
+/** This function adds one byte to a CRC-CCITT (polynomial 0x8408, bits reflected).
+ *  @param crc The CRC so far
+ *  @param data The next byte
+ *  @return The updated CRC
+ */
+static inline uint16_t _crc_ccitt_update (uint16_t crc, uint8_t data)
+{
+	data ^= (uint8_t)(crc & 0xFF);
+	data ^= (uint8_t)(data << 4);
+
+	return ((((uint16_t)data << 8) | (crc >> 8)) ^ (uint8_t)(data >> 4)
+	        ^ ((uint16_t)data << 3));
+}
+
+#endif // _HOST_UTIL_CRC16_H_
@@ -0,0 +1,20 @@
+//*************************************************************************************
+/** @file host/util/delay.h
+ *    This file stands in for the avr-libc busy-wait delay header on a Linux host,
+ *    where a busy-wait delay would only slow down tests and benchmarks.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//*************************************************************************************
+
+#ifndef _HOST_UTIL_DELAY_H_
+#define _HOST_UTIL_DELAY_H_
+
+#define _delay_us(us)       ((void)(us))
+#define _delay_ms(ms)       ((void)(ms))
+
+#endif // _HOST_UTIL_DELAY_H_
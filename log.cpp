@@ -0,0 +1,145 @@
+//*************************************************************************************
+/** @file log.cpp
+ *    This file contains the buffer in which binary log messages wait for the
+ *    telemetry task to send them.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ */
+//*************************************************************************************
+
+#include <stdlib.h>                         // Include standard library header files
+#include <util/atomic.h>                    // For using the buffer from any task
+
+#include "FreeRTOS.h"                       // For the time of each message
+#include "task.h"
+#include "log.h"                            // Include header for logging
+
+
+/// The bytes in front of each message's arguments in the buffer: the size of the
+/// arguments, the time and the message's number
+#define LOG_HEADER_SIZE     5
+
+
+/// The buffer. Each message is its header followed by its arguments; the messages
+/// are put in at the head and taken out at the tail
+static uint8_t log_buffer[LOG_BUFFER_SIZE];
+static uint8_t log_head = 0;
+static uint8_t log_tail = 0;
+
+/// The number of messages which didn't fit in the buffer
+static uint16_t log_dropped = 0;
+
+
+//-------------------------------------------------------------------------------------
+/** This function puts a byte at the head of the buffer. It must only be called with
+ *  interrupts off, after checking that there's room.
+ *  @param a_byte The byte
+ */
+
+static inline void put_byte (uint8_t a_byte)
+{
+	log_buffer[log_head] = a_byte;
+	log_head = (log_head + 1) & (LOG_BUFFER_SIZE - 1);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function takes a byte from the tail of the buffer. It must only be called
+ *  with interrupts off, after checking that there's a message there.
+ *  @return The byte
+ */
+
+static inline uint8_t take_byte (void)
+{
+	uint8_t a_byte = log_buffer[log_tail];
+	log_tail = (log_tail + 1) & (LOG_BUFFER_SIZE - 1);
+	return a_byte;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This function puts a message into the buffer.
+ *  @details It's called by the @c LOG_ macros. Interrupts are off while the message
+ *           is copied, so any task can log; a message is a handful of bytes, so they
+ *           are off for well under ten microseconds. If the buffer is full, the new
+ *           message is dropped and counted, so logging never waits.
+ *  @param   id The message's number, which is its format string's address
+ *  @param   p_args The message's arguments
+ *  @param   size The number of bytes of arguments, at most @c LOG_MAX_ARGS
+ */
+
+void log_record (uint16_t id, const uint8_t* p_args, uint8_t size)
+{
+	uint16_t time_ms = (uint16_t)(xTaskGetTickCount () * (1000 / configTICK_RATE_HZ));
+
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		uint8_t used = (log_head - log_tail) & (LOG_BUFFER_SIZE - 1);
+		if (used + LOG_HEADER_SIZE + size >= LOG_BUFFER_SIZE)
+		{
+			log_dropped++;
+		}
+		else
+		{
+			put_byte (size);
+			put_byte ((uint8_t)time_ms);
+			put_byte ((uint8_t)(time_ms >> 8));
+			put_byte ((uint8_t)id);
+			put_byte ((uint8_t)(id >> 8));
+			for (uint8_t index = 0; index < size; index++)
+			{
+				put_byte (p_args[index]);
+			}
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function takes the oldest message out of the buffer.
+ *  @param entry The place to put the message
+ *  @return True if there was a message, false if the buffer was empty
+ */
+
+bool log_take (log_entry& entry)
+{
+	bool found = false;
+
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		if (log_head != log_tail)
+		{
+			entry.size = take_byte ();
+			entry.time_ms = take_byte ();
+			entry.time_ms |= (uint16_t)take_byte () << 8;
+			entry.id = take_byte ();
+			entry.id |= (uint16_t)take_byte () << 8;
+			for (uint8_t index = 0; index < entry.size; index++)
+			{
+				entry.args[index] = take_byte ();
+			}
+			found = true;
+		}
+	}
+	return found;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function gets the number of messages which have been dropped because the
+ *  buffer was full, which happens if messages are logged faster than they're sent
+ *  or while the telemetry stream is off.
+ *  @return The number of messages dropped since the program started
+ */
+
+uint16_t log_get_dropped (void)
+{
+	uint16_t count;
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		count = log_dropped;
+	}
+	return count;
+}
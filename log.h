@@ -0,0 +1,194 @@
+//======================================================================================
+/** @file log.h
+ *    This file contains the header for binary logging. A message is logged as a
+ *    number which identifies its format string and the raw bytes of its arguments;
+ *    nothing is formatted on the AVR. The format strings are put in the @c .logstr
+ *    section, which the linker script @c logstr.ld keeps out of flash, so the number
+ *    of a message is its string's address in that section. @c host/log_decode reads
+ *    the strings from the ELF file and turns the logged messages back into text.
+ *
+ *    The messages are put into a buffer in RAM, which takes a few dozen cycles, and
+ *    the telemetry task sends them in @c TELEM_LOG packets while the telemetry stream
+ *    is on. Messages below @c LOG_LEVEL aren't compiled at all.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//======================================================================================
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _LOG_H_
+#define _LOG_H_
+
+#include <stdint.h>                         // Fixed-size integer types
+#include <stdlib.h>                         // For NULL
+#include <string.h>                         // For memcpy()
+
+
+/// The levels of messages. A message is compiled if its level is at or below
+/// @c LOG_LEVEL, which can be set on the compiler's command line
+#define LOG_LEVEL_NONE      0
+#define LOG_LEVEL_ERROR     1
+#define LOG_LEVEL_WARN      2
+#define LOG_LEVEL_INFO      3
+#define LOG_LEVEL_DEBUG     4
+
+#ifndef LOG_LEVEL
+	#define LOG_LEVEL       LOG_LEVEL_INFO
+#endif
+
+/// The most bytes of arguments a message can have: three 32-bit numbers
+#define LOG_MAX_ARGS        12
+
+/// The size of the buffer in which messages wait to be sent. It must be a power of
+/// two, no more than 256
+#define LOG_BUFFER_SIZE     128
+
+
+/** @brief   This structure holds a message taken from the buffer to be sent.
+ */
+
+struct log_entry
+{
+	uint16_t time_ms;                       ///< When the message was logged
+	uint16_t id;                            ///< Address of the format string
+	uint8_t size;                           ///< Number of bytes of arguments
+	uint8_t args[LOG_MAX_ARGS];             ///< The arguments, least significant first
+};
+
+
+/** @brief   This class collects the arguments of a message as raw bytes.
+ *  @details Arguments are stored the way @c printf() would get them on the AVR: one
+ *           and two byte numbers as two bytes, and four byte numbers as four. So a
+ *           @c %d, @c %u or @c %x in the format string takes two bytes and a @c %ld,
+ *           @c %lu or @c %lx takes four, and the decoder can find each argument.
+ */
+
+class log_args
+{
+public:
+	uint8_t bytes[LOG_MAX_ARGS];            ///< The arguments so far
+	uint8_t size;                           ///< The number of bytes in them
+
+	/// The constructor starts with no arguments
+	log_args (void) : size (0) { }
+
+	/** This method adds an argument.
+	 *  @param value The argument, a number of up to 32 bits
+	 */
+	template <class Type> void add (Type value)
+	{
+		if (sizeof (Type) <= 2)
+		{
+			int16_t word = (int16_t)value;
+			memcpy (bytes + size, &word, 2);
+			size += 2;
+		}
+		else
+		{
+			int32_t dword = (int32_t)value;
+			memcpy (bytes + size, &dword, 4);
+			size += 4;
+		}
+	}
+};
+
+
+// Put a message into the buffer, or count it as dropped if there's no room
+void log_record (uint16_t id, const uint8_t* p_args, uint8_t size);
+
+// Take the oldest message out of the buffer
+bool log_take (log_entry& entry);
+
+// Get the number of messages dropped because the buffer was full
+uint16_t log_get_dropped (void);
+
+
+/// These functions log a message with up to three arguments
+inline void log_write (uint16_t id)
+{
+	log_record (id, NULL, 0);
+}
+
+template <class A> inline void log_write (uint16_t id, A a)
+{
+	log_args args;
+	args.add (a);
+	log_record (id, args.bytes, args.size);
+}
+
+template <class A, class B> inline void log_write (uint16_t id, A a, B b)
+{
+	log_args args;
+	args.add (a);
+	args.add (b);
+	log_record (id, args.bytes, args.size);
+}
+
+template <class A, class B, class C> inline void log_write (uint16_t id, A a, B b, C c)
+{
+	log_args args;
+	args.add (a);
+	args.add (b);
+	args.add (c);
+	log_record (id, args.bytes, args.size);
+}
+
+
+/** This function is never called. A call to it in dead code has the compiler check
+ *  a message's arguments against its format string, just as for @c printf(). On the
+ *  host the sizes of @c int and @c long aren't the AVR's, so there's no check there.
+ */
+#ifdef HOST_BUILD
+	inline void log_check_format (const char*, ...) { }
+#else
+	inline void log_check_format (const char*, ...) __attribute__ ((format (printf, 1, 2)));
+	inline void log_check_format (const char*, ...) { }
+#endif
+
+
+/// This macro puts a format string in the @c .logstr section and gives its address,
+/// which is the message's number. It must be used in a .cpp file, not in an inline
+/// function in a header
+#define LOG_ID(format) __extension__ ({                                            \
+	static const char _log_format[] __attribute__ ((section (".logstr"), used))    \
+		= format;                                                                  \
+	(uint16_t)(uintptr_t)_log_format; })
+
+/// This macro logs a message at a level, which is a one letter string put at the
+/// front of the format so the decoder can show it
+#define LOG_AT(level, format, ...)                                                 \
+	do {                                                                           \
+		if (0) log_check_format (format, ##__VA_ARGS__);                           \
+		log_write (LOG_ID (level format), ##__VA_ARGS__);                          \
+	} while (0)
+
+/// These macros log messages at each level, as in LOG_INFO ("Encoder %u OK", n)
+#if (LOG_LEVEL >= LOG_LEVEL_ERROR)
+	#define LOG_ERROR(format, ...)  LOG_AT ("E", format, ##__VA_ARGS__)
+#else
+	#define LOG_ERROR(format, ...)  do { } while (0)
+#endif
+
+#if (LOG_LEVEL >= LOG_LEVEL_WARN)
+	#define LOG_WARN(format, ...)   LOG_AT ("W", format, ##__VA_ARGS__)
+#else
+	#define LOG_WARN(format, ...)   do { } while (0)
+#endif
+
+#if (LOG_LEVEL >= LOG_LEVEL_INFO)
+	#define LOG_INFO(format, ...)   LOG_AT ("I", format, ##__VA_ARGS__)
+#else
+	#define LOG_INFO(format, ...)   do { } while (0)
+#endif
+
+#if (LOG_LEVEL >= LOG_LEVEL_DEBUG)
+	#define LOG_DEBUG(format, ...)  LOG_AT ("D", format, ##__VA_ARGS__)
+#else
+	#define LOG_DEBUG(format, ...)  do { } while (0)
+#endif
+
+#endif // _LOG_H_
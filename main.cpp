@@ -15,6 +15,21 @@
  *    \li 01-04-2015 JRR Names of share & queue classes changed; allocated with new now
  *    @li 01-26-2016 Updated main to include shared variables and run user interface with 
  * 		motor control
+ *    @li 10-17-2026 Added setpoint shares for closed-loop motor control
+ *    @li 10-17-2026 Added the telemetry task; serial port sped up to 57600 baud
+ *    @li 10-17-2026 Serial port is now run by Serial_dr, which wakes the user task
+ *    @li 10-17-2026 Starts the timer used by the tasks' loop profiles
+ *    @li 10-17-2026 Motor task, now paced by a timer, has the highest priority
+ *    @li 10-17-2026 Motor shares are made in a loop over the axes
+ *    @li 10-17-2026 Added the odometry task and its pose share
+ *    @li 10-17-2026 Objects are made in static memory when STATIC_ALLOCATION is set
+ *    @li 10-17-2026 Added the motor trace queue and the switch which turns it on;
+ *                   the motor and telemetry tasks' stacks have room for a trace
+ *    @li 10-17-2026 Serial port sped up to 500000 baud, sending from a buffer
+ *    @li 10-17-2026 Added the motor command queue
+ *    @li 10-17-2026 Added the share holding the autotuning result
+ *    @li 10-17-2026 Added the share holding the system identification state
+ *    @li 10-17-2026 Tasks waiting to print sleep on the serial port's semaphore
  *
  *  License:
  *		This file is copyright 2015 by JR Ridgely and released under the Lesser GNU
@@ -43,16 +58,25 @@
 #include "queue.h"                          // FreeRTOS inter-task communication queues
 #include "croutine.h"                       // Header for co-routines and such
 
-#include "rs232int.h"                       // ME405/507 library for serial comm.
+#include "semphr.h"                         // Header for FreeRTOS semaphores
+#include "static_alloc.h"                   // Static memory for objects made once
+
+#include "serial_dr.h"                      // Interrupt-driven serial port driver
+#include "wakequeue.h"                      // Text queue which wakes its reader
+#include "profiler.h"                       // Loop timing profiler
 #include "time_stamp.h"                     // Class to implement a microsecond timer
 #include "taskbase.h"                       // Header of wrapper for FreeRTOS tasks
 #include "textqueue.h"                      // Wrapper for FreeRTOS character queues
 #include "taskqueue.h"                      // Header of wrapper for FreeRTOS queues
 #include "taskshare.h"                      // Header for thread-safe shared data
+#include "seqshare.h"                       // Header for sequence-locked shares
 #include "shares.h"                         // Global ('extern') queue declarations
+#include "params.h"                         // Parameters which can be changed
 #include "task_motor.h"                     // Header for the data acquisition task
 #include "task_user.h"                      // Header for user interface task
 #include "task_encoder.h"
+#include "task_telemetry.h"                 // Header for the telemetry streaming task
+#include "task_odometry.h"                  // Header for the odometry task
 
 
 // Declare the queues which are used by tasks to communicate with each other here.
@@ -69,17 +93,50 @@
  */
 TextQueue* p_print_ser_queue;
 
-/**
- * Initiate 4 shared pointers that task users controls and task motor uses to control
- * multiple motors.  These pointers represent the power value and motor control state
- * for two motors
+/** This semaphore wakes the user interface task. The serial port's receive ISR gives
+ *  it when the user types a character, and the print queue gives it when a task puts
+ *  something in the queue to be printed.
+ */
+SemaphoreHandle_t user_wakeup;
+
+/** The queue of commands to the motor task. The user interface task sends a command
+ *  for each change to an axis's mode, power or setpoint, and the motor task applies
+ *  all the commands which are waiting at the start of each run.
+ */
+TaskQueue<motor_cmd>* p_motor_cmd_queue;
+
+/** The commands for the axes, one share for each. The motor task puts each axis's
+ *  mode, power and setpoint here once it has applied the queued commands, so other
+ *  tasks can see what the axis is doing.
  */
-TaskShare<int16_t>* p_motor_power;
-TaskShare<uint8_t>* p_motor_state;
-TaskShare<int16_t>* p_motor_power2;
-TaskShare<uint8_t>* p_motor_state2;
-TaskShare<uint8_t>* p_encoder_count;
-TaskShare<uint8_t>* p_encoder_state;
+TaskShare<axis_command>* p_axis_command[NUM_AXES];
+
+/// The result of the latest autotuning experiment, which the user interface saves
+TaskShare<tune_result>* p_tune_result;
+
+/// The state of the latest system identification experiment
+TaskShare<uint8_t>* p_sysid_state;
+
+/// The motor task's snapshot of all the axes, which the telemetry task streams
+SeqShare<motor_status>* p_motor_status;
+
+/// Whether telemetry is being streamed; the user interface turns it on and off
+TaskShare<bool>* p_telemetry_on;
+
+/** What each run of the motor task's loop read, while tracing is on. The motor task
+ *  puts a run in without waiting, and the telemetry task sends them all each time it
+ *  runs, so the trace can be replayed on a PC.
+ */
+TaskQueue<motor_trace>* p_motor_trace;
+
+/// Whether the motor task is tracing its runs; the user interface turns it on and off
+TaskShare<bool>* p_trace_on;
+
+/// Positions of the axes' encoders, published by the encoder task
+TaskShare<int32_t>* p_encoder_count[NUM_AXES];
+
+/// The vehicle's pose, worked out by the odometry task from the wheel encoders
+SeqShare<odo_pose>* p_pose;
 
 //=====================================================================================
 /** The main function sets up the RTOS.  Some test tasks are created. Then the
@@ -98,27 +155,83 @@ int main (void)
 	// Configure a serial port which can be used by a task to print debugging infor-
 	// mation, or to allow user interaction, or for whatever use is appropriate.  The
 	// serial port will be used by the user interface task after setup is complete and
-	// the task scheduler has been started by the function vTaskStartScheduler()
-	rs232* p_ser_port = new rs232 (9600, 1);
+	// the task scheduler has been started by the function vTaskStartScheduler().
+	// 500000 baud is exact at 16 MHz. Characters are sent from a buffer by an ISR;
+	// when it's full the printing task sleeps on a semaphore which the ISR gives as
+	// it makes room, so nothing is lost and the other tasks run while it waits
+	Serial_dr* p_ser_port = STATIC_NEW (Serial_dr, (500000, 1));
+	p_ser_port->set_overflow (SERIAL_BLOCK);
+	p_ser_port->set_tx_signal (STATIC_SEMAPHORE_BINARY ());
 	*p_ser_port << clrscr << PMS ("ME405 Lab 1 Starting Program") << endl;
 
-	// Create the queues and other shared data items here
-	p_print_ser_queue = new TextQueue (32, "Print", p_ser_port, 10);
-	p_motor_power = new TaskShare<int16_t> ("Motor Power");
-	p_motor_state = new TaskShare<uint8_t> ("Motor State"); 
-	p_motor_power2 = new TaskShare<int16_t> ("Motor Power 2");
-	p_motor_state2 = new TaskShare<uint8_t> ("Motor State 2"); 
-	p_encoder_count = new TaskShare<uint8_t> ("Encoder Count");
-	p_encoder_state = new TaskShare<uint8_t> ("Encoder State");
+	// Load the parameters saved in the EEPROM before any task reads them
+	if (param_load ())
+	{
+		*p_ser_port << PMS ("Parameters loaded from EEPROM") << endl;
+	}
+	else
+	{
+		*p_ser_port << PMS ("No parameters in EEPROM; using initial values") << endl;
+	}
+
+	// The user interface task sleeps until it's woken by a typed character or by
+	// something to print, so it doesn't have to check for them every millisecond
+	user_wakeup = STATIC_SEMAPHORE_BINARY ();
+	p_ser_port->set_rx_signal (user_wakeup);
+
+	// Create the queues and other shared data items here. These objects, the tasks
+	// and the serial port last for ever, so with STATIC_ALLOCATION they're put in
+	// static memory instead of on the heap
+	p_print_ser_queue = STATIC_NEW (WakeTextQueue,
+	                                (32, "Print", p_ser_port, 10, user_wakeup));
+	p_motor_cmd_queue = STATIC_NEW (TaskQueue<motor_cmd>,
+	                                (MOTOR_CMD_QUEUE_SIZE, "Motor Cmds", MOTOR_CMD_WAIT));
+	axis_command stopped = { AXIS_POT, 0, 0 };
+	for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+	{
+		p_axis_command[axis] = STATIC_NEW_ONE_OF (TaskShare<axis_command>, NUM_AXES,
+		                                          axis, (axis_table[axis].name));
+		p_axis_command[axis]->put (stopped);
+		p_encoder_count[axis] = STATIC_NEW_ONE_OF (TaskShare<int32_t>, NUM_AXES,
+		                                           axis, (axis_table[axis].count_name));
+	}
+	p_tune_result = STATIC_NEW (TaskShare<tune_result>, ("Autotune"));
+	tune_result no_result = { TUNE_IDLE, 0, 0, 0, 0, { 0, 0, 0 } };
+	p_tune_result->put (no_result);
+	p_sysid_state = STATIC_NEW (TaskShare<uint8_t>, ("System ID"));
+	p_sysid_state->put (SYSID_IDLE);
+	p_motor_status = STATIC_NEW (SeqShare<motor_status>, ("Motor Status"));
+	p_telemetry_on = STATIC_NEW (TaskShare<bool>, ("Telemetry On"));
+	p_telemetry_on->put (false);
+	p_motor_trace = STATIC_NEW (TaskQueue<motor_trace>,
+	                            (MOTOR_TRACE_QUEUE_SIZE, "Motor Trace", 0));
+	p_trace_on = STATIC_NEW (TaskShare<bool>, ("Trace On"));
+	p_trace_on->put (false);
+	p_pose = STATIC_NEW (SeqShare<odo_pose>, ("Pose"));
 	
 	// The user interface is at low priority; it could have been run in the idle task
 	// but it is desired to exercise the RTOS more thoroughly in this test program
-	new task_user ("UserInt", task_priority (1), 260, p_ser_port);
+	STATIC_NEW (task_user, ("UserInt", task_priority (1), 260, p_ser_port));
 
-	// Create a task which sets up and runs motors
-	new task_motor ("MotorDrive", task_priority (2), 280, p_ser_port);
+	// Create a task which sets up and runs motors. Its runs are started by a timer
+	// interrupt, so it has the highest priority in order to start without delay. Its
+	// stack has room for the trace of a run
+	STATIC_NEW (task_motor, ("MotorDrive", task_priority (3), 360, p_ser_port));
 	
-	new task_encoder ("Encoder Drive", task_priority (3), 280, p_ser_port);
+	// The encoder task only copies counts from the encoder ISR's, so it's quick and
+	// doesn't disturb the tasks below it
+	STATIC_NEW (task_encoder, ("Encoder Drive", task_priority (2), 280, p_ser_port));
+
+	// The odometry task keeps up with the control loop, so it runs every millisecond
+	// at the encoder task's priority; each run is a few hundred cycles
+	STATIC_NEW (task_odometry, ("Odometry", task_priority (2), 200, p_ser_port));
+
+	// The telemetry task waits on the serial port as it sends, so it runs at the
+	// user interface's low priority; its stack has room for a trace and its frame
+	STATIC_NEW (task_telemetry, ("Telemetry", task_priority (1), 240, p_ser_port));
+
+	// Start the timer which the tasks' loop profiles use to measure time
+	LoopProfile::start_timer ();
 
 	// Here's where the RTOS scheduler is started up. It should never exit as long as
 	// power is on and the microcontroller isn't rebooted
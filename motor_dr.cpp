@@ -5,15 +5,40 @@
  *
  *  Revisions:
  *    @li 1/19/2016 Original creation of the basic motor driver
+ *    @li 10-17-2026 Pin directions are set once, in the constructor
+ *    @li 10-17-2026 Added Timer 1 setup; power is scaled to the timer's TOP
+ *    @li 10-17-2026 Debugging message is logged in binary rather than printed
+ *    @li 10-17-2026 Added Motor_group and Timer 1's TOP interrupt, which changes all
+ *                   the motors together
  *
  */
 //*************************************************************************************
 
 #include <stdlib.h>                         // Include standard library header files
 #include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>                    // Macros for interrupt-safe blocks
 
 #include "rs232int.h"                       // Include header for serial port class
 #include "motor_dr.h"                       // Include header for the A/D class
+#include "log.h"                            // Binary log messages
+
+
+// Until Timer 1 is set up otherwise, it's assumed to be in 8-bit PWM mode, in which
+// the power is the duty cycle
+uint16_t Motor_driver::pwm_top = 255;
+uint16_t Motor_driver::pwm_scale = 256;
+
+// The motor group's changes; none are staged or waiting at first
+Motor_group::motor_change Motor_group::staged[MOTOR_GROUP_SIZE];
+uint8_t Motor_group::num_staged = 0;
+Motor_group::motor_change Motor_group::waiting[MOTOR_GROUP_SIZE];
+uint8_t Motor_group::num_waiting = 0;
+volatile bool Motor_group::change_waiting = false;
+Motor_group::motor_change Motor_group::active[MOTOR_GROUP_SIZE];
+uint8_t Motor_group::num_active = 0;
+volatile bool Motor_group::pins_due = false;
+uint8_t Motor_group::top_bit = TOIE1;
 
 
 //-------------------------------------------------------------------------------------
@@ -51,33 +76,35 @@ Motor_driver::Motor_driver(emstream* p_serial_port,
 	pwm_pin = my_pwm_pin;
 	duty_OCR = my_duty_OCR;
 
-	DBG (ptr_to_serial, "Motor Driver constructor OK" << endl);
+	// The pins' directions never change, so they're set here rather than each time
+	// the power is changed
+	*ina_DDR |= (1 << ina_pin) | (1 << (ina_pin + 1));
+	//ina_DDR sets both the INA and INB pins as outputs
+	*diag_DDR &= ~(1 << diag_pin);
+	//clears the diagnostics DDR to ensure pin is an input
+	*diag_PORT |= (1 << diag_pin);
+	//sets the diagnostics pin pull up resistor
+	*pwm_DDR |= (1 << pwm_pin);
+	// sets the pwm pin as an output
+
+	LOG_INFO ("Motor driver constructor OK");
 }
 /** This method sets the power/speed of the motor. A positive number causes a clockwise
- *   torque and a negative number causes a counter clockwise torque. It also initiates
- *   and configures the proper data registers and pin-outs to control the motor
+ *   torque and a negative number causes a counter clockwise torque. The pins were
+ *   made outputs by the constructor
  *
  *  @param power_in signed variable that allows the motors speed/power to be set
  *
  */
 void Motor_driver::set_power(int16_t power_in)
 {
-    *ina_DDR |= (1 << ina_pin) | (1 << (ina_pin + 1));
-    //ina_DDR sets both the INA and INB pins as outputs
-    *diag_DDR &= ~(1 << diag_pin);
-    //clears the diagnostics DDR to ensure pin is an input
-    *diag_PORT |= (1 << diag_pin);
-    //sets the diagnostics pin pull up resistor
-    *pwm_DDR |= (1 << pwm_pin);
-    // sets the pwm pin as an output
-
     if(power_in >= 0)
     {
         *ina_PORT |= (1 << ina_pin);
         //sets INA to HIGH
         *ina_PORT &= ~(1 << (ina_pin +1));
         //sets INB to LOW
-        *duty_OCR = abs(power_in);
+        *duty_OCR = duty_from_power(power_in);
         // places power in data into the comparators config register for the duty
 
     }
@@ -87,7 +114,7 @@ void Motor_driver::set_power(int16_t power_in)
         //sets INB to HIGH
         *ina_PORT &= ~(1 << (ina_pin));
         //sets INA to LOW
-        *duty_OCR = abs(power_in);
+        *duty_OCR = duty_from_power(power_in);
         // places power in data into the comparators config register for the duty
     }
     else{}
@@ -96,32 +123,211 @@ void Motor_driver::set_power(int16_t power_in)
 }
 
 /** This method allows the motor to be braked by setting both INA and INB to high logic
- *   values. It also initiates and configures the proper data registers and pin-outs
- *   to control the motor
+ *   values. The pins were made outputs by the constructor
  *
  *  @param power_in signed variable that allows the motors speed/power to be set
  */
 
 void Motor_driver::brake(int16_t power_in)
 {
-    *ina_DDR |= (1 << ina_pin) | (1 << (ina_pin + 1));
-    //ina_DDR sets both the INA and INB pins as outputs
-    *diag_DDR &= ~(1 << diag_pin);
-    //clears the diagnostics DDR to ensure pin is an input
-    *diag_PORT |= (1 << diag_pin);
-    //sets the diagnostics pin pull up resistor
-    *pwm_DDR |= (1 << pwm_pin);
-    // sets the pwm pin as an output
-
     *ina_PORT |= (1 << ina_pin)|(1 << (ina_pin +1));
     //sets both INA and INB to HIGH
-    *duty_OCR = abs(power_in);
+    *duty_OCR = duty_from_power(power_in);
     // places power in data into the comparators config register for the duty
 
 }
 
 
 
+//-------------------------------------------------------------------------------------
+/** \brief   This method sets up Timer 1 to make the PWM signals for the motors on
+ *           OC1A and OC1B, and works out how powers are scaled to duty cycles.
+ *  \details The timer is stopped while it's changed, and both duty cycles are set to
+ *           zero. In @c MOTOR_PWM_PHASE_CORRECT mode the output compare registers are
+ *           only loaded at TOP, so a new duty cycle never cuts a pulse short.
+ *  @param   mode The PWM mode, one of the @c motor_pwm_mode values
+ */
+
+void Motor_driver::setup_timer1 (motor_pwm_mode mode)
+{
+	TCCR1B = 0;
+	OCR1A = 0;
+	OCR1B = 0;
+
+	if (mode == MOTOR_PWM_PHASE_CORRECT)
+	{
+		// Mode 10, phase correct PWM with ICR1 as TOP, non-inverting on both
+		// channels, at the CPU clock
+		pwm_top = MOTOR_PWM_TOP;
+		ICR1 = pwm_top;
+		TCNT1 = 0;
+		TCCR1A = (1 << WGM11) | (1 << COM1A1) | (1 << COM1B1);
+		TCCR1B = (1 << WGM13) | (1 << CS10);
+	}
+	else
+	{
+		//set up for the 8-bit fast pwm mode timer/counter
+		//COMnx1 is for setting it to a pin out as non-inverting
+		//WGM sets mode for PWM
+		//CS sets the prescalar to 8
+		pwm_top = 255;
+		TCCR1A = (1 << WGM10) | (1 << COM1A1) | (1 << COM1B1);
+		TCCR1B = (1 << WGM12) | (1 << CS11);
+	}
+
+	// The scale is rounded up, so that full power gives a duty cycle of exactly TOP
+	pwm_scale = (uint16_t)(((uint32_t)pwm_top * 256 + MOTOR_POWER_MAX - 1)
+	                       / MOTOR_POWER_MAX);
+
+	// The compare registers are loaded at TOP, which is the input capture event in
+	// phase correct mode with ICR1 as TOP, and just after the overflow in fast mode
+	Motor_group::set_top_interrupt ((mode == MOTOR_PWM_PHASE_CORRECT) ? ICIE1 : TOIE1);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method stages a change to a motor. Nothing is changed until @c commit() is
+ *  called; if the same motor is staged again before then, the later change is used.
+ *  Only the task which commits the changes should stage them.
+ *  @param p_port The port which holds the motor's direction pins
+ *  @param pin_mask The bits of the direction pins in the port
+ *  @param pin_bits The new states of the direction pins
+ *  @param p_ocr The compare register which sets the motor's duty cycle
+ *  @param duty The new duty cycle, from 0 to Timer 1's TOP
+ */
+
+void Motor_group::stage (volatile uint8_t* p_port, uint8_t pin_mask, uint8_t pin_bits,
+                         volatile uint16_t* p_ocr, uint16_t duty)
+{
+	uint8_t index = 0;
+	while (index < num_staged && staged[index].p_ocr != p_ocr)
+	{
+		index++;
+	}
+	if (index >= MOTOR_GROUP_SIZE)
+	{
+		return;
+	}
+	staged[index].p_port = p_port;
+	staged[index].pin_mask = pin_mask;
+	staged[index].pin_bits = pin_bits;
+	staged[index].p_ocr = p_ocr;
+	staged[index].duty = duty;
+	if (index == num_staged)
+	{
+		num_staged++;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method hands all the staged changes to Timer 1's TOP interrupt.
+ *  @details The interrupt writes the duty cycles at the next TOP and sets the pins at
+ *           the one after, when the timer loads the new duty cycles. If changes
+ *           committed earlier are still waiting for the first of those TOPs, these
+ *           ones replace them; if they're waiting for the second, these follow on
+ *           right after it. Either way, the motors always switch together.
+ */
+
+void Motor_group::commit (void)
+{
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		for (uint8_t index = 0; index < num_staged; index++)
+		{
+			waiting[index] = staged[index];
+		}
+		num_waiting = num_staged;
+		change_waiting = true;
+
+		// If the interrupt is off, a flag left from an earlier TOP is cleared first,
+		// so the duty cycles are written just after a TOP and not just before one
+		if (!pins_due)
+		{
+			TIFR1 = (1 << top_bit);
+			TIMSK1 |= (1 << top_bit);
+		}
+	}
+	num_staged = 0;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method chooses Timer 1's interrupt which comes at TOP. The flag's bit in
+ *  @c TIFR1 is the same as the enable bit in @c TIMSK1.
+ *  @param bit @c ICIE1 in phase correct mode or @c TOIE1 in fast PWM mode
+ */
+
+void Motor_group::set_top_interrupt (uint8_t bit)
+{
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		TIMSK1 &= ~((1 << ICIE1) | (1 << TOIE1));
+		top_bit = bit;
+		if (change_waiting || pins_due)
+		{
+			TIFR1 = (1 << top_bit);
+			TIMSK1 |= (1 << top_bit);
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method makes the changes which are due at a TOP. First the direction pins of
+ *  the changes whose duty cycles the timer has just loaded are set; then the duty
+ *  cycles of any changes waiting are written, to be loaded at the next TOP. When
+ *  nothing is left to do, the interrupt turns itself off. It's only called by the
+ *  interrupt, so interrupts are already off.
+ */
+
+void Motor_group::at_top (void)
+{
+	if (pins_due)
+	{
+		for (uint8_t index = 0; index < num_active; index++)
+		{
+			volatile uint8_t* p_port = active[index].p_port;
+			*p_port = (*p_port & ~active[index].pin_mask) | active[index].pin_bits;
+		}
+		pins_due = false;
+	}
+
+	if (change_waiting)
+	{
+		for (uint8_t index = 0; index < num_waiting; index++)
+		{
+			active[index] = waiting[index];
+			*active[index].p_ocr = active[index].duty;
+		}
+		num_active = num_waiting;
+		change_waiting = false;
+		pins_due = true;
+	}
+	else
+	{
+		TIMSK1 &= ~(1 << top_bit);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This interrupt service routine runs at Timer 1's TOP in phase correct mode, and
+ *  only while the motor group has changes to make.
+ */
+
+ISR (TIMER1_CAPT_vect)
+{
+	Motor_group::at_top ();
+}
+
+/** This interrupt service routine does the same in fast PWM mode, in which the
+ *  overflow comes at TOP.
+ */
+
+ISR (TIMER1_OVF_vect, ISR_ALIASOF (TIMER1_CAPT_vect));
+
+
 //-------------------------------------------------------------------------------------
 /** \brief  This method provides access to serial port prints
  *  \details allows messages to be printed to serial port for debugging purposes
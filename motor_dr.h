@@ -5,6 +5,12 @@
  *
  *  Revisions:
  *    @li 1/19/2016 created first instance of the motor driver class
+ *    @li 10-17-2026 Added MOTOR_POWER_MAX, the limit of set_power()'s range
+ *    @li 10-17-2026 Added Motor_driver_fixed, a template for motors on fixed pins
+ *    @li 10-17-2026 Timer 1 setup with a 20 kHz phase correct PWM mode; power is
+ *                   scaled to the timer's TOP
+ *    @li 10-17-2026 Added Motor_group, which changes all the motors at one TOP
+ *    @li 10-17-2026 Says that the Motor_group only drives Timer 1's three outputs
  *
  */
 
@@ -14,6 +20,8 @@
 #ifndef MOTOR_DR
 #define MOTOR_DR
 
+#include <avr/io.h>                         // Port and timer registers
+
 #include "emstream.h"                       // Header for serial ports and devices
 #include "FreeRTOS.h"                       // Header for the FreeRTOS RTOS
 #include "task.h"                           // Header for FreeRTOS task functions
@@ -21,6 +29,38 @@
 #include "semphr.h"                         // Header for FreeRTOS semaphores
 
 
+/// The largest power setting for @c set_power() and @c brake(), which gives a 100%
+/// duty cycle whatever PWM mode Timer 1 is in
+#define MOTOR_POWER_MAX     255
+
+/// The PWM frequency in @c MOTOR_PWM_PHASE_CORRECT mode, in Hz. It's above the range
+/// of hearing, so the motors don't whine
+#define MOTOR_PWM_HZ        20000UL
+
+/// Timer 1's TOP in @c MOTOR_PWM_PHASE_CORRECT mode. The timer runs at the CPU clock
+/// and counts up and then down each period, so at 16 MHz this is 400 duty steps
+#define MOTOR_PWM_TOP       (F_CPU / 2 / MOTOR_PWM_HZ)
+
+/// The most motors whose changes can be staged in a @c Motor_group at once. Timer 1
+/// has three compare registers, OCR1A to OCR1C, and the group only drives Timer 1,
+/// so raising this doesn't make room for a fourth motor
+#define MOTOR_GROUP_SIZE    3
+
+
+/// The ways in which Timer 1 can make the motors' PWM signals
+enum motor_pwm_mode
+{
+	/// 8-bit fast PWM with a prescaler of 8: 7.8 kHz and 256 duty steps, as the
+	/// motors were first run
+	MOTOR_PWM_FAST_8BIT,
+
+	/// Phase correct PWM with ICR1 as TOP and no prescaler: @c MOTOR_PWM_HZ and
+	/// @c MOTOR_PWM_TOP duty steps. The pulses of both motors are centered in the
+	/// period, and the higher frequency cuts the ripple in the motors' current
+	MOTOR_PWM_PHASE_CORRECT
+};
+
+
 //-------------------------------------------------------------------------------------
 /** @brief   This constructor creates a motor driver that is able to driver multiple
  *              motors at a single time
@@ -48,6 +88,12 @@ protected:
     uint8_t pwm_pin;
     volatile uint16_t* duty_OCR;
 
+    /// Timer 1's TOP, which gives a 100% duty cycle
+    static uint16_t pwm_top;
+
+    /// The factor which scales a power to a duty cycle, times 256
+    static uint16_t pwm_scale;
+
 public:
     Motor_driver(emstream* p_serial_port,
 		 volatile uint8_t* my_ina_PORT, uint8_t my_ina_pin,
@@ -58,8 +104,234 @@ public:
     void set_power (int16_t);
 
     void brake (int16_t);
+
+    // Set up Timer 1 to make the motors' PWM signals in one of the PWM modes
+    static void setup_timer1 (motor_pwm_mode mode);
+
+    /// Get Timer 1's TOP, the largest duty cycle setting
+    static uint16_t get_pwm_top (void) { return pwm_top; }
+
+    /** This method converts a power, whose size can be up to @c MOTOR_POWER_MAX, to
+     *  a duty cycle for Timer 1 as it has been set up. The scale factor is rounded
+     *  up so that full power gives exactly TOP, and the result is limited to TOP.
+     *  @param power_in The power; only its size matters
+     *  @return The setting for the output compare register
+     */
+    static uint16_t duty_from_power (int16_t power_in)
+    {
+        uint16_t magnitude = (power_in < 0) ? -power_in : power_in;
+        uint16_t duty = (uint16_t)(((uint32_t)magnitude * pwm_scale + 128) >> 8);
+        return (duty > pwm_top) ? pwm_top : duty;
+    }
 };
 
 emstream& operator << (emstream&, Motor_driver&);
 
+
+//-------------------------------------------------------------------------------------
+/** @brief   This class changes the direction pins and duty cycles of all the motors
+ *           on Timer 1 at the same point in a PWM period.
+ *  @details Setting one motor after another changes each duty cycle at the next TOP,
+ *           when Timer 1 loads its compare registers, but changes the direction pins
+ *           at once; for part of a period a motor can run the new way at the old duty
+ *           cycle, and the motors change at different times. Instead, the new power
+ *           or brake of each motor is staged with @c stage(), which touches no
+ *           hardware, and then @c commit() hands all of them to Timer 1's interrupt
+ *           at once. At the first TOP after that, the interrupt writes the duty
+ *           cycles, which the timer loads at the following TOP; at that TOP the
+ *           interrupt sets the direction pins. So every motor switches direction and
+ *           duty cycle together, no more than two periods after @c commit().
+ *
+ *           In @c MOTOR_PWM_PHASE_CORRECT mode each pulse is centered on BOTTOM and
+ *           the outputs are low around TOP, so the pins change while no pulse is
+ *           being sent unless the duty cycle is nearly 100%. In
+ *           @c MOTOR_PWM_FAST_8BIT mode the pulses start just after TOP, so the
+ *           first microseconds of a pulse can go out with the old directions. The
+ *           interrupt is only turned on while a change is waiting, so it runs twice
+ *           for each @c commit() rather than at the PWM rate.
+ *
+ *           Everything is static, as there's one Timer 1. Only the motors whose PWM
+ *           comes from OC1A, OC1B or OC1C can be in the group, so it holds at most
+ *           @c MOTOR_GROUP_SIZE of them; a fourth motor would need its PWM from
+ *           another timer, and another group keyed to that timer's TOP and
+ *           interrupt. Motors are usually staged through
+ *           @c Motor_driver_fixed::stage_power() and @c stage_brake().
+ */
+
+class Motor_group
+{
+protected:
+	/** @brief   This structure holds the change to be made to one motor.
+	 */
+	struct motor_change
+	{
+		volatile uint8_t* p_port;           ///< The port with the direction pins
+		uint8_t pin_mask;                   ///< The direction pins' bits in the port
+		uint8_t pin_bits;                   ///< The new states of those bits
+		volatile uint16_t* p_ocr;           ///< The motor's compare register
+		uint16_t duty;                      ///< The new duty cycle
+	};
+
+	/// The changes being staged, which no interrupt looks at
+	static motor_change staged[MOTOR_GROUP_SIZE];
+	static uint8_t num_staged;
+
+	/// The changes committed, waiting for the interrupt to start on them
+	static motor_change waiting[MOTOR_GROUP_SIZE];
+	static uint8_t num_waiting;
+	static volatile bool change_waiting;
+
+	/// The changes whose duty cycles have been written; their pins are set at TOP
+	static motor_change active[MOTOR_GROUP_SIZE];
+	static uint8_t num_active;
+	static volatile bool pins_due;
+
+	/// The bit in @c TIMSK1 and @c TIFR1 of the interrupt which comes at TOP in the
+	/// mode Timer 1 has been set up in
+	static uint8_t top_bit;
+
+public:
+	// Stage a change to a motor's direction pins and duty cycle
+	static void stage (volatile uint8_t* p_port, uint8_t pin_mask, uint8_t pin_bits,
+	                   volatile uint16_t* p_ocr, uint16_t duty);
+
+	// Hand all the staged changes to the interrupt, to be made at the coming TOPs
+	static void commit (void);
+
+	// Choose the interrupt which comes at TOP; it's called by setup_timer1()
+	static void set_top_interrupt (uint8_t bit);
+
+	// Make the changes which are due at a TOP; it's called by Timer 1's interrupt
+	static void at_top (void);
+};
+
+
+//-------------------------------------------------------------------------------------
+/** This macro declares a struct which names one of the AVR's I/O ports, for use as a
+ *  parameter of the @c Motor_driver_fixed template. The registers are returned by
+ *  inline functions rather than being stored, because a register's address can't be
+ *  a template parameter; once the functions are inlined, the compiler sees constant
+ *  addresses and can set or clear each bit with one @c sbi or @c cbi instruction.
+ *  @param letter The port's letter, such as B for @c PORTB
+ */
+
+#define MOTOR_PORT(letter) \
+	struct motor_port_##letter \
+	{ \
+		static volatile uint8_t& port (void) { return PORT##letter; } \
+		static volatile uint8_t& ddr (void) { return DDR##letter; } \
+	}
+
+/** This macro declares a struct which names an output compare register, for use as
+ *  the duty cycle parameter of the @c Motor_driver_fixed template.
+ *  @param timer_channel The timer and channel, such as 1A for @c OCR1A
+ */
+
+#define MOTOR_OCR(timer_channel) \
+	struct motor_ocr_##timer_channel \
+	{ \
+		static volatile uint16_t& ocr (void) { return OCR##timer_channel; } \
+	}
+
+// The ports and compare registers used by the motors on the ME405 board
+MOTOR_PORT (B);
+MOTOR_PORT (C);
+MOTOR_PORT (D);
+MOTOR_OCR (1A);
+MOTOR_OCR (1B);
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This class template drives a motor whose pins are fixed when the program
+ *           is compiled.
+ *  @details It does the same job as @c Motor_driver, with the same pins: INA on
+ *           @c ina_pin and INB on the pin above it, a diagnostic input, a PWM output,
+ *           and the output compare register which sets the duty cycle. Because the
+ *           ports and pins are template parameters, each bit is set or cleared by a
+ *           single @c sbi or @c cbi instruction and no RAM is used to store them; all
+ *           the methods are static, so no object is needed at all. The pins are set
+ *           up once by @c init() rather than every time the power is changed.
+ *
+ *           Each motor is a different type, so a program which picks motors at run
+ *           time, or reads its pin assignments from somewhere, should use
+ *           @c Motor_driver instead. A motor is usually given a name with a typedef:
+ *           @code
+ *           typedef Motor_driver_fixed<motor_port_C, PC0, motor_port_C, PC2,
+ *                                      motor_port_B, PB6, motor_ocr_1B> motor_a;
+ *           motor_a::init ();
+ *           motor_a::set_power (-100);
+ *           @endcode
+ */
+
+template <class INA_PORT, uint8_t ina_pin, class DIAG_PORT, uint8_t diag_pin,
+          class PWM_PORT, uint8_t pwm_pin, class DUTY_OCR>
+class Motor_driver_fixed
+{
+public:
+	/** This method makes INA, INB and the PWM pin outputs, and makes the diagnostic
+	 *  pin an input with its pull-up resistor on. It must be called before the motor
+	 *  is used.
+	 */
+	static void init (void)
+	{
+		INA_PORT::ddr () |= (1 << ina_pin);
+		INA_PORT::ddr () |= (1 << (ina_pin + 1));
+		DIAG_PORT::ddr () &= ~(1 << diag_pin);
+		DIAG_PORT::port () |= (1 << diag_pin);
+		PWM_PORT::ddr () |= (1 << pwm_pin);
+	}
+
+	/** This method sets the motor's power. A positive number or zero gives clockwise
+	 *  torque and a negative number counterclockwise torque.
+	 *  @param power_in The power, from -MOTOR_POWER_MAX to MOTOR_POWER_MAX
+	 */
+	static void set_power (int16_t power_in)
+	{
+		// Each bit is changed on its own, so that each change is one instruction
+		if (power_in >= 0)
+		{
+			INA_PORT::port () |= (1 << ina_pin);
+			INA_PORT::port () &= ~(1 << (ina_pin + 1));
+			DUTY_OCR::ocr () = Motor_driver::duty_from_power (power_in);
+		}
+		else
+		{
+			INA_PORT::port () |= (1 << (ina_pin + 1));
+			INA_PORT::port () &= ~(1 << ina_pin);
+			DUTY_OCR::ocr () = Motor_driver::duty_from_power (power_in);
+		}
+	}
+
+	/** This method brakes the motor by setting both INA and INB high.
+	 *  @param power_in The braking strength; only its size matters
+	 */
+	static void brake (int16_t power_in)
+	{
+		INA_PORT::port () |= (1 << ina_pin);
+		INA_PORT::port () |= (1 << (ina_pin + 1));
+		DUTY_OCR::ocr () = Motor_driver::duty_from_power (power_in);
+	}
+
+	/** This method stages a new power in the @c Motor_group, to be set along with the
+	 *  other motors' when @c Motor_group::commit() is called.
+	 *  @param power_in The power, from -MOTOR_POWER_MAX to MOTOR_POWER_MAX
+	 */
+	static void stage_power (int16_t power_in)
+	{
+		uint8_t pin_bits = (power_in >= 0) ? (1 << ina_pin) : (1 << (ina_pin + 1));
+		Motor_group::stage (&INA_PORT::port (), 3 << ina_pin, pin_bits,
+		                    &DUTY_OCR::ocr (), Motor_driver::duty_from_power (power_in));
+	}
+
+	/** This method stages braking in the @c Motor_group, to be started along with the
+	 *  other motors' changes when @c Motor_group::commit() is called.
+	 *  @param power_in The braking strength; only its size matters
+	 */
+	static void stage_brake (int16_t power_in)
+	{
+		Motor_group::stage (&INA_PORT::port (), 3 << ina_pin, 3 << ina_pin,
+		                    &DUTY_OCR::ocr (), Motor_driver::duty_from_power (power_in));
+	}
+};
+
 #endif // MOTOR_DR
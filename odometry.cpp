@@ -0,0 +1,111 @@
+//*************************************************************************************
+/** @file odometry.cpp
+ *    This file contains dead reckoning for a differential drive vehicle, done in
+ *    fixed point from the counts of its two wheel encoders.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ */
+//*************************************************************************************
+
+#include <stdlib.h>                         // Include standard library header files
+
+#include "odometry.h"                       // Include header for the odometry class
+
+
+//-------------------------------------------------------------------------------------
+/** This constructor puts the vehicle at the origin, facing along the x axis.
+ *  @param left The left wheel's encoder count now
+ *  @param right The right wheel's encoder count now
+ */
+
+Odometry::Odometry (int32_t left, int32_t right)
+{
+	reset (left, right);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method puts the vehicle back at the origin, facing along the x axis. The
+ *  next update measures the wheels' movement from the counts given here.
+ *  @param left The left wheel's encoder count now
+ *  @param right The right wheel's encoder count now
+ */
+
+void Odometry::reset (int32_t left, int32_t right)
+{
+	last_left = left;
+	last_right = right;
+	x = y = 0;
+	x_remainder = y_remainder = 0;
+	heading = 0;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method moves the pose by the change in the wheels' counts.
+ *  @details The distance moved is found in sixteenths of a micrometre, so that its
+ *           product with a Q2.14 cosine fits in 32 bits. The products are added to
+ *           the remainders, and whole micrometres are moved from the remainders into
+ *           the position; the arithmetic shift rounds down, so the remainders are
+ *           never negative.
+ *  @param   left The left wheel's encoder count now
+ *  @param   right The right wheel's encoder count now
+ */
+
+void Odometry::update (int32_t left, int32_t right)
+{
+	int32_t delta_left = left - last_left;
+	int32_t delta_right = right - last_right;
+	last_left = left;
+	last_right = right;
+
+	// The turn this update, and the heading half way through it
+	int32_t turn = (delta_right - delta_left) * ODO_BRAD_PER_COUNT;
+	uint16_t middle = (uint16_t)((heading + (uint32_t)(turn / 2)) >> 16);
+	heading += (uint32_t)turn;
+
+	// The distance moved by the centre of the vehicle, which is the average of the
+	// wheels' distances, in sixteenths of a micrometre
+	int32_t distance = ((delta_left + delta_right) * ODO_UM_PER_COUNT_Q7 + 8) >> 4;
+
+	x_remainder += distance * fix_cos (middle);
+	y_remainder += distance * fix_sin (middle);
+	x += x_remainder >> ODO_FRAC_BITS;
+	y += y_remainder >> ODO_FRAC_BITS;
+	x_remainder &= (1L << ODO_FRAC_BITS) - 1;
+	y_remainder &= (1L << ODO_FRAC_BITS) - 1;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method returns the present pose.
+ *  @return The position in micrometres and the heading in 65536ths of a turn
+ */
+
+odo_pose Odometry::get_pose (void)
+{
+	odo_pose pose;
+	pose.x = x;
+	pose.y = y;
+	pose.heading = (uint16_t)(heading >> 16);
+	return pose;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This operator prints a pose on one line, so the pose share can be shown in the
+ *  list of shares.
+ *  @param serpt Reference to a serial port to which the printout will be printed
+ *  @param pose Reference to the pose which is being printed
+ *  @return A reference to the same serial device on which we write information.
+ *          This is used to string together things to write with @c << operators
+ */
+
+emstream& operator << (emstream& serpt, const odo_pose& pose)
+{
+	serpt << pose.x << ',' << pose.y << PMS (" um ") << pose.heading << PMS ("/65536");
+
+	return (serpt);
+}
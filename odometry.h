@@ -0,0 +1,114 @@
+//======================================================================================
+/** @file odometry.h
+ *    This file contains the header for dead reckoning of a differential drive vehicle
+ *    from its two wheel encoders. All the arithmetic is done in integers, with the
+ *    sines and cosines from the table in @c fixtrig.cpp, so an update is quick enough
+ *    to be run at the rate of the motor control loop.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//======================================================================================
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _ODOMETRY_H_
+#define _ODOMETRY_H_
+
+#include <stdint.h>                         // Fixed-size integer types
+
+#include "emstream.h"                       // Header for serial ports and devices
+#include "fixtrig.h"                        // Fixed-point sine and cosine
+
+
+/// Encoder counts in one turn of a wheel, counting all four edges of each cycle
+#define ODO_COUNTS_PER_REV  1440L
+
+/// The diameter of the wheels in micrometres
+#define ODO_WHEEL_DIA_UM    65000L
+
+/// The distance between the centres of the wheels' contact patches, in micrometres
+#define ODO_TRACK_UM        150000L
+
+/// The distance a wheel moves for one count, in micrometres with seven fractional
+/// bits. The floating point arithmetic is done by the compiler, not the AVR
+#define ODO_UM_PER_COUNT_Q7 ((int32_t)(3.14159265 * ODO_WHEEL_DIA_UM * 128.0       \
+                                       / ODO_COUNTS_PER_REV + 0.5))
+
+/// The turn of the vehicle for one count of difference between the wheels, as a
+/// 32-bit binary angle (2^32 is a whole turn)
+#define ODO_BRAD_PER_COUNT  ((int32_t)(4294967296.0 * ODO_WHEEL_DIA_UM               \
+                                       / (2.0 * ODO_TRACK_UM * ODO_COUNTS_PER_REV)  \
+                                       + 0.5))
+
+/// The number of fractional bits in the position's remainders: micrometres in Q4
+/// times a Q2.14 cosine
+#define ODO_FRAC_BITS       (4 + FIX_TRIG_BITS)
+
+
+/** @brief   This structure holds the vehicle's pose, which the odometry task publishes
+ *           in a @c SeqShare.
+ */
+
+struct odo_pose
+{
+	int32_t x;                              ///< Distance forward from the start, in um
+	int32_t y;                              ///< Distance left of the start, in um
+	uint16_t heading;                       ///< Turn to the left, 65536 per turn
+};
+
+// This operator prints a pose on one line
+emstream& operator << (emstream&, const odo_pose&);
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This class works out where a differential drive vehicle is from how far
+ *           its wheels have turned.
+ *  @details Each update takes the change in each wheel's count since the last one.
+ *           The vehicle moves forward by the average of the wheels' distances and
+ *           turns by their difference over the track width; the move is taken along
+ *           the heading half way through the turn, which is exact for a circular arc
+ *           to second order. The heading is a 32-bit binary angle, so it wraps around
+ *           with no checks, and the position is kept in micrometres with the parts
+ *           of a micrometre carried from one update to the next, so no distance is
+ *           lost to rounding however often it's updated.
+ *
+ *           The wheels may move up to about 8 mm in one update. The position wraps
+ *           around after about 2 km.
+ */
+
+class Odometry
+{
+protected:
+	/// The wheels' counts at the last update
+	int32_t last_left;
+	int32_t last_right;
+
+	/// The position, in micrometres
+	int32_t x;
+	int32_t y;
+
+	/// The parts of a micrometre left over from the updates so far
+	int32_t x_remainder;
+	int32_t y_remainder;
+
+	/// The heading as a 32-bit binary angle; the top 16 bits are the pose's heading
+	uint32_t heading;
+
+public:
+	// The constructor puts the vehicle at the origin, facing along the x axis
+	Odometry (int32_t left, int32_t right);
+
+	// Move the pose by the change in the wheels' counts
+	void update (int32_t left, int32_t right);
+
+	// Put the vehicle back at the origin, facing along the x axis
+	void reset (int32_t left, int32_t right);
+
+	// Get the present pose
+	odo_pose get_pose (void);
+};
+
+#endif // _ODOMETRY_H_
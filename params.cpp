@@ -0,0 +1,310 @@
+//*************************************************************************************
+/** @file params.cpp
+ *    This file contains the table of parameters which can be changed while the
+ *    program runs, and the functions which set them, look them up by name, print
+ *    them, and keep them in the EEPROM.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Added the system identification experiment's settings
+ *
+ */
+//*************************************************************************************
+
+#include <stdlib.h>                         // Include standard library header files
+#include <stddef.h>                         // For offsetof()
+#include <avr/pgmspace.h>                   // For the table, which is kept in flash
+#include <avr/eeprom.h>                     // For saving the parameters
+#include <util/crc16.h>                     // CRC-CCITT update function
+
+#include "params.h"                         // Include header for the parameters
+#include "task_motor.h"                     // The motor task's default settings
+#include "sysid.h"                          // The kinds of excitation
+
+
+/// The version of the layout of the parameters in the EEPROM. It must be raised if
+/// the parameters are put in a different order, so old values aren't loaded into
+/// the wrong ones; adding a parameter at the end is noticed without it
+#define PARAM_VERSION       1
+
+/// The slowest and fastest rates the motor control loop can be set to
+#if MOTOR_USE_CONTROL_TIMER
+	#define PARAM_LOOP_HZ_MIN   1000
+	#define PARAM_LOOP_HZ_MAX   2000
+#else
+	#define PARAM_LOOP_HZ_MIN   1
+	#define PARAM_LOOP_HZ_MAX   1000
+#endif
+
+
+// The names of the parameters, kept in flash
+static const char name_pot_deadband[] PROGMEM = "pot_deadband";
+static const char name_pot_divisor[] PROGMEM = "pot_divisor";
+static const char name_pot_gain[] PROGMEM = "pot_gain";
+static const char name_pos_kp[] PROGMEM = "pos_kp";
+static const char name_pos_ki[] PROGMEM = "pos_ki";
+static const char name_pos_kd[] PROGMEM = "pos_kd";
+static const char name_vel_kp[] PROGMEM = "vel_kp";
+static const char name_vel_ki[] PROGMEM = "vel_ki";
+static const char name_vel_kd[] PROGMEM = "vel_kd";
+static const char name_loop_hz[] PROGMEM = "loop_hz";
+static const char name_sysid_signal[] PROGMEM = "sysid_signal";
+static const char name_sysid_offset[] PROGMEM = "sysid_offset";
+static const char name_sysid_hold[] PROGMEM = "sysid_hold";
+static const char name_sysid_chirp_hz[] PROGMEM = "sysid_chirp_hz";
+static const char name_sysid_every[] PROGMEM = "sysid_every";
+
+/** The descriptions of the parameters, in order of number. The initial values are
+ *  the ones the program used before the parameters could be changed. The gains are
+ *  per run of the control loop, so they must be changed along with @c loop_hz. The
+ *  system identification settings hold each PRBS bit for 8 runs and put 11 runs in
+ *  each sample, so a capture of 4400 runs holds the PRBS's whole 4088-run period.
+ */
+
+static const param_info param_table[NUM_PARAMS] PROGMEM =
+{
+	{ name_pot_deadband, PARAM_INT16, 0, 0, 170, 43 },
+	{ name_pot_divisor, PARAM_INT16, 0, 1, 16, 3 },
+	{ name_pot_gain, PARAM_INT16, 0, 0, 16, 2 },
+	{ name_pos_kp, PARAM_INT16, 0, 0, 32767, MOTOR_POS_KP },
+	{ name_pos_ki, PARAM_INT16, 0, 0, 32767, MOTOR_POS_KI },
+	{ name_pos_kd, PARAM_INT16, 0, 0, 32767, MOTOR_POS_KD },
+	{ name_vel_kp, PARAM_INT16, 0, 0, 32767, MOTOR_VEL_KP },
+	{ name_vel_ki, PARAM_INT16, 0, 0, 32767, MOTOR_VEL_KI },
+	{ name_vel_kd, PARAM_INT16, 0, 0, 32767, MOTOR_VEL_KD },
+	{ name_loop_hz, PARAM_UINT16, PARAM_AT_BOOT, PARAM_LOOP_HZ_MIN, PARAM_LOOP_HZ_MAX,
+	  MOTOR_LOOP_HZ },
+	{ name_sysid_signal, PARAM_INT16, 0, SYSID_PRBS, SYSID_CHIRP, SYSID_PRBS },
+	{ name_sysid_offset, PARAM_INT16, 0, -MOTOR_POWER_MAX, MOTOR_POWER_MAX, 0 },
+	{ name_sysid_hold, PARAM_INT16, 0, 1, 255, 8 },
+	{ name_sysid_chirp_hz, PARAM_UINT16, 0, 1, PARAM_LOOP_HZ_MAX / 2, 20 },
+	{ name_sysid_every, PARAM_INT16, 0, 1, 50, 11 }
+};
+
+
+/** @brief   This structure is the layout of the parameters in the EEPROM.
+ */
+
+struct param_record
+{
+	uint8_t version;                        ///< @c PARAM_VERSION when it was saved
+	uint8_t count;                          ///< @c NUM_PARAMS when it was saved
+	int32_t values[NUM_PARAMS];             ///< The values
+	uint16_t crc;                           ///< CRC-CCITT of everything above
+};
+
+/// The saved parameters, in the EEPROM
+static param_record EEMEM saved_params;
+
+
+/// The values of the parameters, which are set by param_load() at startup
+int32_t param_values[NUM_PARAMS];
+
+/// A count of changes, which wraps around; the motor task rereads its gains when it
+/// sees the count change
+volatile uint8_t param_change_count = 0;
+
+
+//-------------------------------------------------------------------------------------
+/** This function copies a parameter's description out of flash.
+ *  @param id The parameter's number
+ *  @return The description
+ */
+
+static param_info info_of (uint8_t id)
+{
+	param_info info;
+	memcpy_P (&info, &param_table[id], sizeof (info));
+	return info;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function checks whether a value is allowed for a parameter, both by the
+ *  parameter's limits and by its type.
+ *  @param info The parameter's description
+ *  @param value The value to check
+ *  @return True if the parameter can be set to the value
+ */
+
+static bool in_range (const param_info& info, int32_t value)
+{
+	if (value < info.minimum || value > info.maximum)
+	{
+		return false;
+	}
+	switch (info.type)
+	{
+		case (PARAM_INT16):
+			return (value >= -32768L && value <= 32767L);
+		case (PARAM_UINT16):
+			return (value >= 0 && value <= 65535L);
+		default:
+			return true;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function finds the CRC of the parameters in a record, as the telemetry
+ *  packets' CRC is found.
+ *  @param record The record
+ *  @return The CRC of everything in the record but the CRC itself
+ */
+
+static uint16_t record_crc (const param_record& record)
+{
+	const uint8_t* p_byte = (const uint8_t*)&record;
+	uint16_t crc = 0xFFFF;
+	for (uint8_t count = 0; count < offsetof (param_record, crc); count++)
+	{
+		crc = _crc_ccitt_update (crc, *p_byte++);
+	}
+	return crc;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function sets a parameter, if the value is allowed.
+ *  @param id The parameter's number
+ *  @param value The new value
+ *  @return True if the parameter was set, false if the value is out of its range
+ */
+
+bool param_set (param_id id, int32_t value)
+{
+	if (!in_range (info_of (id), value))
+	{
+		return false;
+	}
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		param_values[id] = value;
+		param_change_count++;
+	}
+	return true;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function finds a parameter by name. It compares strings, so it's for the
+ *  user interface; the control loop uses the parameters' numbers.
+ *  @param p_name The name, in RAM
+ *  @return The parameter's number, or -1 if there's no such parameter
+ */
+
+int8_t param_find (const char* p_name)
+{
+	for (uint8_t id = 0; id < NUM_PARAMS; id++)
+	{
+		const char* p_table_name = (const char*)pgm_read_ptr (&param_table[id].name);
+		if (strcmp_P (p_name, p_table_name) == 0)
+		{
+			return id;
+		}
+	}
+	return -1;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function puts every parameter back to its initial value.
+ */
+
+void param_defaults (void)
+{
+	for (uint8_t id = 0; id < NUM_PARAMS; id++)
+	{
+		param_set ((param_id)id, info_of (id).initial);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This function loads the parameters from the EEPROM.
+ *  @details If the EEPROM has never been written, or was written by a version of the
+ *           program with different parameters, or its CRC is wrong, every parameter
+ *           gets its initial value. A saved value which is out of its parameter's
+ *           present range is replaced by the initial value as well. It's called by
+ *           @c main() before the tasks are made.
+ *  @return  True if the parameters came from the EEPROM
+ */
+
+bool param_load (void)
+{
+	param_defaults ();
+
+	param_record record;
+	eeprom_read_block (&record, &saved_params, sizeof (record));
+	if (record.version != PARAM_VERSION || record.count != NUM_PARAMS
+		|| record.crc != record_crc (record))
+	{
+		return false;
+	}
+
+	for (uint8_t id = 0; id < NUM_PARAMS; id++)
+	{
+		param_set ((param_id)id, record.values[id]);
+	}
+	return true;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function saves the parameters in the EEPROM. Only the bytes which have
+ *  changed are written, and each takes about 3.4 ms, so it can take a while; it's
+ *  meant to be called by the user interface, not by the control loop.
+ */
+
+void param_save (void)
+{
+	param_record record;
+	record.version = PARAM_VERSION;
+	record.count = NUM_PARAMS;
+	for (uint8_t id = 0; id < NUM_PARAMS; id++)
+	{
+		record.values[id] = param_get ((param_id)id);
+	}
+	record.crc = record_crc (record);
+	eeprom_update_block (&record, &saved_params, sizeof (record));
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function prints a parameter's name, value and range on one line.
+ *  @param p_ser The serial device on which to print
+ *  @param id The parameter's number
+ */
+
+void param_print (emstream* p_ser, param_id id)
+{
+	param_info info = info_of (id);
+
+	// The name is in flash, so it's printed one character at a time
+	char a_char;
+	for (const char* p_char = info.name; (a_char = pgm_read_byte (p_char)); p_char++)
+	{
+		*p_ser << a_char;
+	}
+	*p_ser << PMS (" = ") << param_get (id) << PMS ("  (") << info.minimum
+	       << PMS (" to ") << info.maximum << ')';
+	if (info.flags & PARAM_AT_BOOT)
+	{
+		*p_ser << PMS (", at reset");
+	}
+	*p_ser << endl;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function prints every parameter, one on each line.
+ *  @param p_ser The serial device on which to print
+ */
+
+void param_print_all (emstream* p_ser)
+{
+	for (uint8_t id = 0; id < NUM_PARAMS; id++)
+	{
+		param_print (p_ser, (param_id)id);
+	}
+}
@@ -0,0 +1,121 @@
+//======================================================================================
+/** @file params.h
+ *    This file contains the header for the registry of parameters which can be
+ *    changed while the program runs, such as the potentiometer's dead band and the
+ *    controllers' gains. Each parameter has a number, a name, a type and a range. The
+ *    control loop reads a parameter by its number, which is an index into an array,
+ *    so no strings are involved; the user interface finds parameters by name. The
+ *    whole set can be saved in EEPROM with a CRC and is loaded from there at startup.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Added the system identification experiment's settings
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//======================================================================================
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _PARAMS_H_
+#define _PARAMS_H_
+
+#include <stdint.h>                         // Fixed-size integer types
+#include <util/atomic.h>                    // For reading values the loop can't tear
+
+#include "emstream.h"                       // Header for serial ports and devices
+
+
+/// The numbers of the parameters. A new parameter needs a number here, before
+/// @c NUM_PARAMS, and a line in @c param_table in params.cpp, in the same order
+enum param_id
+{
+	PARAM_POT_DEADBAND,                     ///< Half the knob's dead band, scaled
+	PARAM_POT_DIVISOR,                      ///< A/D counts per step of knob travel
+	PARAM_POT_GAIN,                         ///< Power per step outside the dead band
+	PARAM_POS_KP,                           ///< Position control proportional gain
+	PARAM_POS_KI,                           ///< Position control integral gain
+	PARAM_POS_KD,                           ///< Position control derivative gain
+	PARAM_VEL_KP,                           ///< Velocity control proportional gain
+	PARAM_VEL_KI,                           ///< Velocity control integral gain
+	PARAM_VEL_KD,                           ///< Velocity control derivative gain
+	PARAM_LOOP_HZ,                          ///< Runs of the motor control loop a second
+	PARAM_SYSID_SIGNAL,                     ///< System identification: 0 PRBS, 1 chirp
+	PARAM_SYSID_OFFSET,                     ///< Power around which it drives the motor
+	PARAM_SYSID_HOLD,                       ///< Runs for which each PRBS bit is held
+	PARAM_SYSID_CHIRP_HZ,                   ///< Frequency at which the chirp ends
+	PARAM_SYSID_EVERY,                      ///< Runs which go into each recorded sample
+	NUM_PARAMS
+};
+
+/// The types a parameter can have. Every value is kept as an @c int32_t; the type
+/// limits the range it can be set to, on top of the parameter's own limits
+enum param_type
+{
+	PARAM_INT16,                            ///< From -32768 to 32767
+	PARAM_UINT16,                           ///< From 0 to 65535
+	PARAM_INT32                             ///< Any 32-bit signed number
+};
+
+/// A flag for parameters which are only read when the program starts, so a change
+/// takes effect once it's saved and the AVR is reset
+#define PARAM_AT_BOOT       0x01
+
+
+/** @brief   This structure describes a parameter. The descriptions are kept in flash.
+ */
+
+struct param_info
+{
+	const char* name;                       ///< Name, a string in flash
+	uint8_t type;                           ///< One of the @c param_type values
+	uint8_t flags;                          ///< @c PARAM_AT_BOOT, or zero
+	int32_t minimum;                        ///< Smallest value allowed
+	int32_t maximum;                        ///< Largest value allowed
+	int32_t initial;                        ///< Value used if the EEPROM has none
+};
+
+
+// The values of the parameters, in order of number. Use param_get() to read them
+extern int32_t param_values[NUM_PARAMS];
+
+// A count of the changes made, so a task can see that it should reread its values
+extern volatile uint8_t param_change_count;
+
+
+/** This function reads a parameter. It's quick enough for the control loop: the
+ *  value is copied with interrupts off, so a change made by another task can't be
+ *  seen half done.
+ *  @param id The parameter's number
+ *  @return The parameter's value
+ */
+inline int32_t param_get (param_id id)
+{
+	int32_t value;
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		value = param_values[id];
+	}
+	return value;
+}
+
+// Set a parameter, if the value is in its range
+bool param_set (param_id id, int32_t value);
+
+// Find a parameter's number from its name
+int8_t param_find (const char* p_name);
+
+// Put every parameter back to its initial value
+void param_defaults (void);
+
+// Load the parameters from the EEPROM, or use the initial values if it has none
+bool param_load (void);
+
+// Save the parameters in the EEPROM
+void param_save (void);
+
+// Print one parameter, or all of them
+void param_print (emstream* p_ser, param_id id);
+void param_print_all (emstream* p_ser);
+
+#endif // _PARAMS_H_
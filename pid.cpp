@@ -0,0 +1,148 @@
+//*************************************************************************************
+/** @file pid.cpp
+ *    This file contains a fixed-point PID controller. The gains are Q8.8 numbers and
+ *    the internal sums are 32-bit numbers with eight fractional bits, so the controller
+ *    runs on the AVR without any floating point code.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ */
+//*************************************************************************************
+
+#include <stdlib.h>                         // Include standard library header files
+
+#include "pid.h"                            // Include header for the PID class
+
+
+//-------------------------------------------------------------------------------------
+/** This function limits a number to the range from -limit to +limit.
+ *  @param value The number to be limited
+ *  @param limit The largest magnitude the result may have
+ *  @return The number, limited
+ */
+
+static inline int32_t clamp (int32_t value, int32_t limit)
+{
+	if (value > limit)
+	{
+		return limit;
+	}
+	if (value < -limit)
+	{
+		return -limit;
+	}
+	return value;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This constructor sets up a PID controller.
+ *  @param   a_k_p The proportional gain in Q8.8 format (256 means 1.0)
+ *  @param   a_k_i The integral gain per update in Q8.8 format
+ *  @param   a_k_d The derivative gain per update in Q8.8 format
+ *  @param   a_filter_shift The derivative filter's shift; larger means smoother and
+ *                          slower (default: 2)
+ *  @param   an_output_limit The output is saturated to plus or minus this number
+ *                           (default: @c MOTOR_POWER_MAX)
+ */
+
+PID::PID (int16_t a_k_p, int16_t a_k_i, int16_t a_k_d, uint8_t a_filter_shift,
+          int16_t an_output_limit)
+{
+	set_gains (a_k_p, a_k_i, a_k_d);
+	filter_shift = a_filter_shift;
+	output_limit = an_output_limit;
+	reset (0);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method runs one step of the controller.
+ *  @details It must be called at a steady rate, because the integral and derivative
+ *           gains are per update rather than per second.
+ *  @param   setpoint The value the measurement should have
+ *  @param   measurement The latest measurement, such as an encoder position
+ *  @return  The new output, between -limit and +limit
+ */
+
+int16_t PID::update (int32_t setpoint, int32_t measurement)
+{
+	int32_t limit = (int32_t)output_limit << PID_Q_BITS;
+	int32_t error = clamp (setpoint - measurement, PID_ERROR_MAX);
+
+	// Proportional term
+	int32_t p_term = clamp ((int32_t)k_p * error, PID_TERM_MAX);
+
+	// Derivative term, from the change in the measurement, low-pass filtered
+	int32_t change = clamp (measurement - last_measurement, PID_ERROR_MAX);
+	last_measurement = measurement;
+	int32_t raw_derivative = clamp (-(int32_t)k_d * change, PID_TERM_MAX);
+	derivative += (raw_derivative - derivative) >> filter_shift;
+
+	// Integral term. The error is only added in if it won't push the output further
+	// into saturation; this keeps the integral from winding up
+	int32_t step = clamp ((int32_t)k_i * error, limit);
+	int32_t sum = p_term + integral + derivative;
+	if (!((sum >= limit && step > 0) || (sum <= -limit && step < 0)))
+	{
+		integral = clamp (integral + step, limit);
+		sum = p_term + integral + derivative;
+	}
+
+	// Saturate, then round from Q8.8 to a whole number of output units
+	sum = clamp (sum, limit);
+	output = (int16_t)((sum + (1L << (PID_Q_BITS - 1))) >> PID_Q_BITS);
+
+	return output;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method clears the controller's integral and derivative.
+ *  @details It should be called whenever closed-loop control is started, with the
+ *           present measurement, so that the first update doesn't see a false jump
+ *           in the measurement.
+ *  @param   measurement The present value of the measurement
+ */
+
+void PID::reset (int32_t measurement)
+{
+	integral = 0;
+	derivative = 0;
+	last_measurement = measurement;
+	output = 0;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method changes the controller's gains.
+ *  @param   a_k_p The proportional gain in Q8.8 format
+ *  @param   a_k_i The integral gain per update in Q8.8 format
+ *  @param   a_k_d The derivative gain per update in Q8.8 format
+ */
+
+void PID::set_gains (int16_t a_k_p, int16_t a_k_i, int16_t a_k_d)
+{
+	k_p = a_k_p;
+	k_i = a_k_i;
+	k_d = a_k_d;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** \brief   This overloaded operator prints the controller's gains and state.
+ *  @param   serpt Reference to a serial port to which the printout will be printed
+ *  @param   pid   Reference to the controller which is being printed
+ *  @return  A reference to the same serial device on which we write information.
+ *           This is used to string together things to write with @c << operators
+ */
+
+emstream& operator << (emstream& serpt, PID& pid)
+{
+	serpt << PMS ("PID Kp/Ki/Kd (Q8.8): ") << pid.k_p << '/' << pid.k_i << '/'
+	      << pid.k_d << PMS (" I: ") << pid.get_integral () << PMS (" out: ")
+	      << pid.output << endl;
+
+	return (serpt);
+}
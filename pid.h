@@ -0,0 +1,122 @@
+//======================================================================================
+/** @file pid.h
+ *    This file contains the header for a fixed-point PID controller which is used to
+ *    run the motors in closed loop from encoder feedback. All the arithmetic is done
+ *    in integers, so no floating point library is needed on the AVR.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Added a structure which holds a set of gains
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//======================================================================================
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _PID_H_
+#define _PID_H_
+
+#include <stdint.h>                         // Fixed-size integer types
+
+#include "emstream.h"                       // Header for serial ports and devices
+#include "motor_dr.h"                       // For the range of motor power settings
+
+
+/// The number of fractional bits in the gains and in the internal sums. Gains are in
+/// Q8.8 format, so a gain of 256 means 1.0; the smallest nonzero gain is 1/256
+#define PID_Q_BITS          8
+
+/// Errors and changes in measurement are limited to this size so that the product of
+/// a 16-bit gain and an error always fits in 32 bits
+#define PID_ERROR_MAX       32767L
+
+/// The proportional and derivative terms are each limited to this size so that the
+/// sum of all three terms can't overflow; it's far beyond any output that's allowed
+#define PID_TERM_MAX        (1L << 24)
+
+
+/// A set of gains for the controller, each in Q8.8 format and per update
+struct pid_gains
+{
+	int16_t k_p;                            ///< Proportional gain
+	int16_t k_i;                            ///< Integral gain
+	int16_t k_d;                            ///< Derivative gain
+};
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This class implements a PID controller in Q8.8 fixed point.
+ *  @details The controller is run by calling @c update() at a fixed rate with the
+ *           setpoint and the latest measurement; the gains are per update, so they
+ *           must be changed if the rate is changed. The three terms are:
+ *           \li Proportional: @c k_p times the error
+ *           \li Integral: the sum of @c k_i times the error. The sum is only allowed to
+ *               grow while the output isn't saturated in the same direction
+ *               (conditional integration), and it's clamped to the output range, so
+ *               it can't wind up while the motor is stalled
+ *           \li Derivative: @c k_d times the change in the measurement, not in the
+ *               error, so a step in the setpoint doesn't kick the motor. It's passed
+ *               through a first order low-pass filter, @c d += (raw - d) >> shift, to
+ *               keep encoder quantization from turning into noise at the output
+ *
+ *           The output is saturated to +/- the limit given to the constructor, which
+ *           is normally @c MOTOR_POWER_MAX, the range of @c Motor_driver::set_power().
+ *           One object is needed for each motor. An update takes three 32-bit
+ *           multiplications and a few additions; @c make @c bench reports its cost in
+ *           cycles, which hasn't yet been recorded here.
+ */
+
+class PID
+{
+protected:
+	/// The proportional, integral and derivative gains, in Q8.8 format
+	int16_t k_p, k_i, k_d;
+
+	/// The derivative filter's shift; each update moves the filtered derivative
+	/// 1 / 2^shift of the way to the latest raw derivative. Zero turns the filter off
+	uint8_t filter_shift;
+
+	/// The output is saturated to plus or minus this number
+	int16_t output_limit;
+
+	/// The integral term, in Q8.8 output units
+	int32_t integral;
+
+	/// The filtered derivative term, in Q8.8 output units
+	int32_t derivative;
+
+	/// The measurement at the previous update, used to compute the derivative
+	int32_t last_measurement;
+
+	/// The most recently computed output
+	int16_t output;
+
+public:
+	// The constructor saves the gains and clears the controller's state
+	PID (int16_t a_k_p, int16_t a_k_i, int16_t a_k_d, uint8_t a_filter_shift = 2,
+	     int16_t an_output_limit = MOTOR_POWER_MAX);
+
+	// Run one step of the controller and return the new output
+	int16_t update (int32_t setpoint, int32_t measurement);
+
+	// Clear the integral and derivative so the controller starts smoothly
+	void reset (int32_t measurement);
+
+	// Change the gains; the controller's state is kept
+	void set_gains (int16_t a_k_p, int16_t a_k_i, int16_t a_k_d);
+
+	/// Get the output computed by the most recent update
+	int16_t get_output (void) { return output; }
+
+	/// Get the integral term, rounded to output units
+	int16_t get_integral (void) { return (int16_t)(integral >> PID_Q_BITS); }
+
+	// The printing operator needs to see the gains and state
+	friend emstream& operator << (emstream&, PID&);
+};
+
+// This operator prints the controller's gains and state
+emstream& operator << (emstream&, PID&);
+
+#endif // _PID_H_
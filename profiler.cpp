@@ -0,0 +1,310 @@
+//*************************************************************************************
+/** @file profiler.cpp
+ *    This file contains a profiler which measures the run time, lateness and processor
+ *    use of the tasks' loops, using Timer/Counter 4 as a free-running clock.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Periods can be set in microseconds; skipped runs count as misses
+ *
+ */
+//*************************************************************************************
+
+#include <stdlib.h>                         // Include standard library header files
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+#include "profiler.h"                       // Include header for the profiler
+
+
+/// The number of times Timer 4 has overflowed; it's the high half of the time
+static volatile uint16_t overflows = 0;
+
+// The list of profiles starts out empty
+LoopProfile* LoopProfile::p_first = NULL;
+
+
+//-------------------------------------------------------------------------------------
+/** This constructor creates a profile and puts it at the end of the list of profiles,
+ *  so that they're printed in the order in which they were made.
+ *  @param p_name The name printed in the table, usually the name of the task
+ *  @param period_ms The task's period in milliseconds, or zero if the task isn't run
+ *                   periodically; lateness and deadlines aren't measured for such a
+ *                   task (default: 0)
+ */
+
+LoopProfile::LoopProfile (const char* p_name, uint16_t period_ms)
+{
+	name = p_name;
+	period = (uint32_t)period_ms * PROF_TICKS_PER_MS;
+	created = now ();
+	release = created;
+	start = created;
+
+	stats.busy = 0;
+	stats.loops = 0;
+	stats.last_exec = 0;
+	stats.max_exec = 0;
+	stats.max_late = 0;
+	stats.misses = 0;
+	for (uint8_t bin = 0; bin < PROF_JITTER_BINS; bin++)
+	{
+		stats.jitter[bin] = 0;
+	}
+
+	p_next = NULL;
+	if (p_first == NULL)
+	{
+		p_first = this;
+	}
+	else
+	{
+		LoopProfile* p_last = p_first;
+		while (p_last->p_next != NULL)
+		{
+			p_last = p_last->p_next;
+		}
+		p_last->p_next = this;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method sets the task's period in microseconds. It's for a loop which is run
+ *  by something other than the RTOS tick, such as a timer interrupt, and must be
+ *  called before the loop's first run.
+ *  @param period_us The period in microseconds; a multiple of @c PROF_US_PER_TICK
+ *                   is measured exactly
+ */
+
+void LoopProfile::set_period_us (uint16_t period_us)
+{
+	period = period_us / PROF_US_PER_TICK;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method starts Timer 4 counting freely at the CPU clock divided by
+ *  @c PROF_PRESCALER, with an interrupt on overflow which counts the high half of the
+ *  time. It must be called before any task runs.
+ */
+
+void LoopProfile::start_timer (void)
+{
+	TCCR4A = 0;
+	TCCR4B = (1 << CS41) | (1 << CS40);
+	TIMSK4 |= (1 << TOIE4);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method reads the time from Timer 4 and the count of its overflows. If the
+ *  timer has overflowed but the interrupt hasn't yet been serviced, the overflow is
+ *  counted here, so the time never goes backwards.
+ *  @return The time in timer counts, each @c PROF_US_PER_TICK microseconds
+ */
+
+uint32_t LoopProfile::now (void)
+{
+	uint16_t low;
+	uint16_t high;
+
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		low = TCNT4;
+		high = overflows;
+		if ((TIFR4 & (1 << TOV4)) && low < 0x8000)
+		{
+			high++;
+		}
+	}
+
+	return ((uint32_t)high << 16) | low;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method is called at the top of the task's loop. It notes the time and, for a
+ *  periodic task, works out how late the run started and puts that in the histogram.
+ *  The first run is started when the task starts rather than by the schedule, so the
+ *  schedule is set by the second run. If a run starts earlier than the schedule says,
+ *  the schedule is moved to it, so lateness is always counted from the earliest start.
+ *  If a whole period or more has been skipped, as happens when a timer interrupt
+ *  wakes the task and a tick comes while the task is still busy, the schedule moves
+ *  on to the run which is starting and each skipped run counts as a missed deadline.
+ */
+
+void LoopProfile::begin (void)
+{
+	start = now ();
+
+	if (period == 0)
+	{
+		return;
+	}
+
+	if (stats.loops < 2)
+	{
+		release = start;
+		return;
+	}
+
+	release += period;
+	int32_t late = (int32_t)(start - release);
+	if (late < 0)
+	{
+		release = start;
+		late = 0;
+	}
+	else if ((uint32_t)late >= period)
+	{
+		uint32_t skipped = (uint32_t)late / period;
+		release += skipped * period;
+		late -= skipped * period;
+		stats.misses += skipped;
+	}
+
+	uint16_t late_ticks = (late > 0xFFFF) ? 0xFFFF : (uint16_t)late;
+	if (late_ticks > stats.max_late)
+	{
+		stats.max_late = late_ticks;
+	}
+
+	// Find the histogram bin; each bin is twice as wide as the one before
+	uint16_t width = PROF_BIN_US / PROF_US_PER_TICK;
+	uint8_t bin = 0;
+	while (bin < PROF_JITTER_BINS - 1 && late_ticks >= width)
+	{
+		bin++;
+		width <<= 1;
+	}
+	stats.jitter[bin]++;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method is called at the end of the task's loop, just before the task waits.
+ *  It adds the run's time to the totals and checks whether the run finished before
+ *  the next one was due.
+ */
+
+void LoopProfile::end (void)
+{
+	uint32_t finish = now ();
+	uint32_t exec = finish - start;
+
+	stats.busy += exec;
+	stats.loops++;
+	stats.last_exec = (exec > 0xFFFF) ? 0xFFFF : (uint16_t)exec;
+	if (stats.last_exec > stats.max_exec)
+	{
+		stats.max_exec = stats.last_exec;
+	}
+
+	if (period != 0 && stats.loops > 2 && finish - release > period)
+	{
+		stats.misses++;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method copies the measurements with interrupts off, so that a task which
+ *  preempts the caller can't change them halfway through the copy.
+ *  @param copy A reference to the structure into which the measurements are copied
+ */
+
+void LoopProfile::get_stats (loop_stats& copy)
+{
+	ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+	{
+		copy = stats;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method works out how much of the processor's time the task has used since the
+ *  profile was made. The time is divided down before the busy time is, so that
+ *  nothing overflows.
+ *  @return The task's share of the processor, in tenths of a percent
+ */
+
+uint16_t LoopProfile::get_cpu_permille (void)
+{
+	loop_stats copy;
+	get_stats (copy);
+
+	uint32_t elapsed = (now () - created) / 1000;
+	if (elapsed == 0)
+	{
+		return 0;
+	}
+	uint32_t permille = copy.busy / elapsed;
+	return (permille > 1000) ? 1000 : (uint16_t)permille;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method prints a table of all the profiles. Each line shows the number of
+ *  runs, the share of the processor used, the latest and longest run times, the
+ *  latest start and the number of missed deadlines, and then the histogram of how
+ *  late the runs started. Times are in microseconds.
+ *  @param p_ser_dev The serial device on which to print
+ */
+
+void LoopProfile::print_all (emstream* p_ser_dev)
+{
+	*p_ser_dev << PMS ("Times in us; the last columns count runs by how late they started")
+	           << endl << PMS ("Loop            Runs\tCPU%\tLast\tMax\tLate\tMisses");
+	for (uint8_t bin = 0; bin < PROF_JITTER_BINS - 1; bin++)
+	{
+		*p_ser_dev << PMS ("\t<") << ((uint16_t)PROF_BIN_US << bin);
+	}
+	*p_ser_dev << PMS ("\tmore") << endl;
+
+	for (LoopProfile* p_prof = p_first; p_prof != NULL; p_prof = p_prof->p_next)
+	{
+		loop_stats copy;
+		p_prof->get_stats (copy);
+		uint16_t permille = p_prof->get_cpu_permille ();
+
+		// Print the name, padded to 16 characters so the columns line up
+		uint8_t slen = 0;
+		for (const char* p_char = p_prof->name; p_char && *p_char; p_char++, slen++)
+		{
+			*p_ser_dev << *p_char;
+		}
+		for ( ; slen < 16; slen++)
+		{
+			*p_ser_dev << ' ';
+		}
+
+		*p_ser_dev << copy.loops << '\t' << permille / 10 << '.' << permille % 10
+		           << '\t' << to_us (copy.last_exec)
+		           << '\t' << to_us (copy.max_exec);
+		if (p_prof->period == 0)
+		{
+			*p_ser_dev << PMS ("\t-\t-") << endl;
+			continue;
+		}
+		*p_ser_dev << '\t' << to_us (copy.max_late)
+		           << '\t' << copy.misses;
+		for (uint8_t bin = 0; bin < PROF_JITTER_BINS; bin++)
+		{
+			*p_ser_dev << '\t' << copy.jitter[bin];
+		}
+		*p_ser_dev << endl;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This ISR counts overflows of Timer 4, which happen every 65536 timer counts.
+ */
+
+ISR (TIMER4_OVF_vect)
+{
+	overflows++;
+}
@@ -0,0 +1,158 @@
+//======================================================================================
+/** @file profiler.h
+ *    This file contains the header for a profiler which measures how long each task's
+ *    loop takes to run, how late it starts compared with its schedule, and how much of
+ *    the processor's time the task uses. Times are taken from Timer/Counter 4, which
+ *    the profiler runs freely so that measurements don't depend on the RTOS tick.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Periods can be set in microseconds; skipped runs count as misses
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//======================================================================================
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include <stdint.h>                         // Fixed-size integer types
+
+#include "emstream.h"                       // Header for serial ports and devices
+
+
+/// Timer 4 counts at the CPU clock divided by this number. At 16 MHz each count is
+/// 4 microseconds and the 32-bit time wraps after about four and three quarter hours
+#define PROF_PRESCALER      64
+
+/// The number of timer counts in a millisecond
+#define PROF_TICKS_PER_MS   (F_CPU / PROF_PRESCALER / 1000UL)
+
+/// The number of microseconds in a timer count
+#define PROF_US_PER_TICK    (1000UL / PROF_TICKS_PER_MS)
+
+/// The number of bins in the histogram of how late each loop starts. The first bin
+/// holds starts less than @c PROF_BIN_US late; each of the others is twice as wide as
+/// the one before, and the last holds everything later than that
+#define PROF_JITTER_BINS    6
+
+/// The width of the first bin of the lateness histogram, in microseconds
+#define PROF_BIN_US         64
+
+
+/// The measurements kept for each task's loop. Times are in timer counts
+struct loop_stats
+{
+	uint32_t busy;                          ///< Total time spent in the loop
+	uint32_t loops;                         ///< Number of times through the loop
+	uint16_t last_exec;                     ///< Run time of the latest loop
+	uint16_t max_exec;                      ///< Longest run time of any loop
+	uint16_t max_late;                      ///< Latest that any loop has started
+	uint16_t misses;                        ///< Loops which ran past their deadline
+	uint16_t jitter[PROF_JITTER_BINS];      ///< Histogram of how late loops started
+};
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This class measures the timing of one task's loop.
+ *  @details A task calls @c begin() at the top of its loop and @c end() just before it
+ *           waits for its next run. For a periodic task, @c begin() compares the time
+ *           with the time at which the run was due, which advances by one period each
+ *           run, just as @c delay_from_for_ms() advances it. How late each run starts
+ *           is put into a histogram, and a run which hasn't finished by the time the
+ *           next one is due counts as a missed deadline. The first run sets the
+ *           schedule, so lateness is measured from the delay with which the first run
+ *           started, and the constant time taken by the RTOS to switch to the task
+ *           isn't counted as jitter.
+ *
+ *           The time from @c begin() to @c end() is counted as the task's run time.
+ *           This includes any time taken by interrupts or by tasks of higher priority
+ *           which preempt it, so the busy time of a low priority task is an upper
+ *           bound; for the highest priority task it's accurate.
+ *
+ *           Every profile is put in a list, so @c print_all() can print them all as a
+ *           table, as the ME405 library's @c print_all_shares() does for shares.
+ */
+
+class LoopProfile
+{
+protected:
+	/// The first profile in the list of all profiles
+	static LoopProfile* p_first;
+
+	/// The next profile in the list
+	LoopProfile* p_next;
+
+	/// The name printed in the table, usually the name of the task
+	const char* name;
+
+	/// The task's period in timer counts, or zero for a task which isn't periodic
+	uint32_t period;
+
+	/// When the profile was created, from which the processor use is worked out
+	uint32_t created;
+
+	/// When the current run was due to start
+	uint32_t release;
+
+	/// When the current run did start
+	uint32_t start;
+
+	/// The measurements
+	loop_stats stats;
+
+public:
+	// The constructor makes a profile and puts it in the list
+	LoopProfile (const char* p_name, uint16_t period_ms = 0);
+
+	// Start the timer which the profiler uses. It's called once, in main()
+	static void start_timer (void);
+
+	// Get the time from the profiler's timer, in timer counts
+	static uint32_t now (void);
+
+	// Set the period in microseconds, for a loop that's faster than once a millisecond
+	void set_period_us (uint16_t period_us);
+
+	// The task calls this method at the top of its loop
+	void begin (void);
+
+	// The task calls this method at the end of its loop
+	void end (void);
+
+	/** This method converts a time in timer counts to microseconds.
+	 *  @param ticks The time in timer counts
+	 *  @return The time in microseconds, limited to 65535
+	 */
+	static uint16_t to_us (uint16_t ticks)
+	{
+		uint32_t time_us = (uint32_t)ticks * PROF_US_PER_TICK;
+		return (time_us > 0xFFFF) ? 0xFFFF : (uint16_t)time_us;
+	}
+
+	/// Get the run time of the latest loop in microseconds; the task calls this itself
+	/// after @c end(), so no copy is needed
+	uint16_t get_last_us (void) { return to_us (stats.last_exec); }
+
+	// Get a consistent copy of the measurements
+	void get_stats (loop_stats& copy);
+
+	// Get the share of the processor's time the task has used, in tenths of a percent
+	uint16_t get_cpu_permille (void);
+
+	/// Get the profile's name
+	const char* get_name (void) { return name; }
+
+	/// Get the next profile in the list, or NULL at the end of the list
+	LoopProfile* get_next (void) { return p_next; }
+
+	/// Get the first profile in the list, or NULL if there are none
+	static LoopProfile* get_first (void) { return p_first; }
+
+	// Print a table with a line for each profile
+	static void print_all (emstream* p_ser_dev);
+};
+
+#endif // _PROFILER_H_
@@ -0,0 +1,186 @@
+//*************************************************************************************
+/** @file relay_tune.cpp
+ *    This file contains a relay feedback autotuner, which drives an axis into a
+ *    steady oscillation and works out PID gains for position control from it.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ */
+//*************************************************************************************
+
+#include <stdlib.h>                         // Include standard library header files
+
+#include "relay_tune.h"                     // Include header for the autotuner
+
+
+//-------------------------------------------------------------------------------------
+/** This constructor makes a tuner which isn't running; @c begin() starts it.
+ */
+
+Relay_tune::Relay_tune (void)
+{
+	result.state = TUNE_IDLE;
+	result.axis = 0;
+	result.k_u = 0;
+	result.t_u = 0;
+	result.amplitude = 0;
+	result.gains.k_p = result.gains.k_i = result.gains.k_d = 0;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method starts an experiment. The relay first drives the axis the positive
+ *  way, and it oscillates around the position it's at now.
+ *  @param position The axis's present position, in encoder counts
+ *  @param relay_power The relay's power; only its size is used, and zero means
+ *                     @c TUNE_POWER
+ */
+
+void Relay_tune::begin (int32_t position, int16_t relay_power)
+{
+	center = position;
+	power = (relay_power < 0) ? -relay_power : relay_power;
+	if (power == 0)
+	{
+		power = TUNE_POWER;
+	}
+	if (power > MOTOR_POWER_MAX)
+	{
+		power = MOTOR_POWER_MAX;
+	}
+	direction = 1;
+	runs = 0;
+	cycle_start = 0;
+	since_switch = 0;
+	highest = lowest = position;
+	cycles = 0;
+	period_sum = 0;
+	swing_sum = 0;
+	result.state = TUNE_RUNNING;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method runs one step of the experiment.
+ *  @details The relay switches to negative power once the position is more than
+ *           @c TUNE_HYSTERESIS counts above the center, and back to positive power
+ *           once it's that far below. Each switch to positive power ends a cycle;
+ *           after the first @c TUNE_SKIP_CYCLES, the cycles' lengths and swings are
+ *           added up, and after @c TUNE_CYCLES more the gains are worked out. If the
+ *           axis runs away or stops oscillating, the experiment fails. The power is
+ *           zero once the experiment is over.
+ *  @param   position The axis's position from its encoder, in counts
+ *  @return  The power to give the motor
+ */
+
+int16_t Relay_tune::step (int32_t position)
+{
+	if (result.state != TUNE_RUNNING)
+	{
+		return 0;
+	}
+
+	runs++;
+	since_switch++;
+	int32_t error = position - center;
+	if (error > TUNE_MAX_ERROR || error < -TUNE_MAX_ERROR)
+	{
+		result.state = TUNE_RUNAWAY;
+		return 0;
+	}
+	if (since_switch > TUNE_TIMEOUT_RUNS)
+	{
+		result.state = TUNE_NO_OSCILLATION;
+		return 0;
+	}
+
+	if (position > highest)
+	{
+		highest = position;
+	}
+	if (position < lowest)
+	{
+		lowest = position;
+	}
+
+	if (direction > 0 && error > TUNE_HYSTERESIS)
+	{
+		direction = -1;
+		since_switch = 0;
+	}
+	else if (direction < 0 && error < -TUNE_HYSTERESIS)
+	{
+		// A cycle ends here; the first switch only starts one
+		direction = 1;
+		since_switch = 0;
+		if (cycles > TUNE_SKIP_CYCLES)
+		{
+			period_sum += (uint16_t)(runs - cycle_start);
+			swing_sum += (uint32_t)(highest - lowest);
+		}
+		cycle_start = runs;
+		highest = lowest = position;
+		if (++cycles > TUNE_SKIP_CYCLES + TUNE_CYCLES)
+		{
+			finish ();
+			return 0;
+		}
+	}
+
+	return direction * power;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method works out the ultimate gain and period from the measured cycles, and
+ *  the gains from them. In Q8.8, Ku = 4 d / (pi a) is 1024 d / (pi a), and pi is
+ *  taken as 355 / 113. The integral gain per run is Kp / Ti and the derivative gain
+ *  per run is Kp Td, with Ti and Td in runs. Gains too big for 16 bits are limited.
+ */
+
+void Relay_tune::finish (void)
+{
+	result.t_u = (uint16_t)((period_sum + TUNE_CYCLES / 2) / TUNE_CYCLES);
+	result.amplitude = (uint16_t)((swing_sum + TUNE_CYCLES) / (2 * TUNE_CYCLES));
+	if (result.amplitude == 0)
+	{
+		result.amplitude = 1;
+	}
+	if (result.t_u == 0)
+	{
+		result.t_u = 1;
+	}
+
+	int32_t k_u = ((int32_t)power * 1024L * 113L) / (355L * result.amplitude);
+	result.k_u = (k_u > 32767L) ? 32767 : (int16_t)k_u;
+
+	int32_t k_p = (int32_t)result.k_u * TUNE_KP_NUM / TUNE_KP_DEN;
+	int32_t ti_runs = (int32_t)result.t_u * TUNE_TI_NUM;
+	int32_t k_i = (k_p * TUNE_TI_DEN + ti_runs / 2) / ti_runs;
+	int32_t k_d = k_p * TUNE_TD_NUM * result.t_u / TUNE_TD_DEN;
+
+	result.gains.k_p = (int16_t)k_p;
+	result.gains.k_i = (k_i > 32767L) ? 32767 : (int16_t)k_i;
+	result.gains.k_d = (k_d > 32767L) ? 32767 : (int16_t)k_d;
+	result.state = TUNE_DONE;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This operator prints a tuning result on one line.
+ *  @param serpt Reference to a serial port to which the printout will be printed
+ *  @param result Reference to the result which is being printed
+ *  @return A reference to the same serial device on which we write information.
+ *          This is used to string together things to write with @c << operators
+ */
+
+emstream& operator << (emstream& serpt, const tune_result& result)
+{
+	serpt << PMS ("Ku ") << result.k_u << PMS ("/256 Tu ") << result.t_u
+	      << PMS (" runs amp ") << result.amplitude << PMS (" -> Kp ")
+	      << result.gains.k_p << PMS (" Ki ") << result.gains.k_i << PMS (" Kd ")
+	      << result.gains.k_d;
+
+	return (serpt);
+}
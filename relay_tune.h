@@ -0,0 +1,149 @@
+//======================================================================================
+/** @file relay_tune.h
+ *    This file contains the header for a relay feedback autotuner, which finds PID
+ *    gains for an axis's position control from an experiment on the motor itself.
+ *    The motor is driven by a relay, full power one way or the other depending on
+ *    which side of the starting position the encoder is on; that makes the axis
+ *    oscillate at the frequency where its phase lag is 180 degrees. The size and
+ *    period of the oscillation give the ultimate gain and period, from which the
+ *    gains are worked out with the Ziegler-Nichols "no overshoot" rule.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//======================================================================================
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _RELAY_TUNE_H_
+#define _RELAY_TUNE_H_
+
+#include <stdint.h>                         // Fixed-size integer types
+
+#include "emstream.h"                       // Header for serial ports and devices
+#include "pid.h"                            // For the gains which are worked out
+
+
+/// The relay's power when the axis's command doesn't give one
+#define TUNE_POWER          80
+
+/// The relay only switches when the position is this many counts past the starting
+/// position, so noise in the encoder's count can't make it chatter
+#define TUNE_HYSTERESIS     4
+
+/// The number of cycles of oscillation which are let go by while it settles, and
+/// the number which are then measured and averaged
+#define TUNE_SKIP_CYCLES    2
+#define TUNE_CYCLES         4
+
+/// The experiment fails if the relay hasn't switched in this many runs of the loop,
+/// or if the axis gets this many counts from where it started
+#define TUNE_TIMEOUT_RUNS   5000
+#define TUNE_MAX_ERROR      20000L
+
+/// The "no overshoot" rule, as fractions: Kp = Ku / 5, Ti = Tu / 2, Td = Tu / 3.
+/// The classic rule is Kp = 3 Ku / 5, Ti = Tu / 2, Td = Tu / 8
+#define TUNE_KP_NUM         1
+#define TUNE_KP_DEN         5
+#define TUNE_TI_NUM         1
+#define TUNE_TI_DEN         2
+#define TUNE_TD_NUM         1
+#define TUNE_TD_DEN         3
+
+
+/// The stages of an autotuning experiment
+enum tune_state
+{
+	TUNE_IDLE,                              ///< No experiment has been started
+	TUNE_RUNNING,                           ///< The axis is oscillating
+	TUNE_DONE,                              ///< The gains have been worked out
+	TUNE_NO_OSCILLATION,                    ///< The relay stopped switching
+	TUNE_RUNAWAY                            ///< The axis went too far from its start
+};
+
+
+/** @brief   This structure holds what an autotuning experiment found.
+ */
+
+struct tune_result
+{
+	uint8_t state;                          ///< One of the @c tune_state values
+	uint8_t axis;                           ///< The axis which was tuned
+	int16_t k_u;                            ///< Ultimate gain, Q8.8 power per count
+	uint16_t t_u;                           ///< Ultimate period, in runs of the loop
+	uint16_t amplitude;                     ///< Half the swing of the oscillation
+	pid_gains gains;                        ///< Gains for position control, per run
+};
+
+// This operator prints a tuning result on one line
+emstream& operator << (emstream&, const tune_result&);
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This class runs a relay feedback experiment on one axis.
+ *  @details @c begin() starts it at the axis's present position, and @c step() is
+ *           called every run of the control loop with the encoder's position, giving
+ *           the power for the motor. The relay switches with a little hysteresis;
+ *           each time it switches to positive power a cycle ends, and the cycle's
+ *           length and the swing of the position during it are measured. Once
+ *           enough cycles have been measured, the ultimate gain is found from the
+ *           describing function of a relay, Ku = 4 d / (pi a), where d is the relay's
+ *           power and a is half the swing, and the ultimate period is the average
+ *           cycle length. The gains are per run of the loop, like all the gains.
+ *
+ *           Everything is done in integers and no hardware is touched, so the tuner
+ *           can run in @c Axis::step() on the AVR or in the replay program.
+ */
+
+class Relay_tune
+{
+protected:
+	/// The position the axis oscillates around, and the relay's power
+	int32_t center;
+	int16_t power;
+
+	/// The relay's present output, +1 or -1
+	int8_t direction;
+
+	/// Runs since the experiment started, and the run at which the last cycle ended
+	uint16_t runs;
+	uint16_t cycle_start;
+
+	/// Runs since the relay last switched, to notice when it has stopped
+	uint16_t since_switch;
+
+	/// The highest and lowest positions seen during the present cycle
+	int32_t highest;
+	int32_t lowest;
+
+	/// Cycles ended so far, and the sums of the measured cycles' lengths and swings
+	uint8_t cycles;
+	uint32_t period_sum;
+	uint32_t swing_sum;
+
+	/// What has been found
+	tune_result result;
+
+	// Work out the ultimate gain and period and the gains from the sums
+	void finish (void);
+
+public:
+	// The constructor makes a tuner which isn't running
+	Relay_tune (void);
+
+	// Start an experiment at a position with a relay of some power
+	void begin (int32_t position, int16_t relay_power);
+
+	// Run one step of the experiment and return the motor's power
+	int16_t step (int32_t position);
+
+	/// Get what the experiment has found so far; the state says whether it's done
+	const tune_result& get_result (void) { return result; }
+
+	/// Find whether the experiment is still going
+	bool is_running (void) { return result.state == TUNE_RUNNING; }
+};
+
+#endif // _RELAY_TUNE_H_
@@ -0,0 +1,218 @@
+//======================================================================================
+/** @file seqshare.h
+ *    This file contains a template for a shared data item which one writer, often an
+ *    interrupt service routine, can update without disabling interrupts, and which
+ *    any number of tasks can read. A sequence counter tells the readers when a read
+ *    overlapped a write, and they try again.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Sequence number widened to 16 bits, read a byte at a time
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//======================================================================================
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _SEQSHARE_H_
+#define _SEQSHARE_H_
+
+#include <string.h>                         // For strlen() when printing the name
+
+#include "emstream.h"                       // Header for serial ports and devices
+#include "baseshare.h"                      // Base class for shared data items
+
+
+/// This macro keeps the compiler from moving memory accesses across it; the AVR has
+/// only one core and doesn't reorder memory accesses, so this is all the barrier
+/// that's needed
+#define SEQ_BARRIER()       asm volatile ("" ::: "memory")
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This class holds data which one writer updates and many tasks read,
+ *           without any critical sections.
+ *  @details The writer makes the sequence number odd, copies the data in, then makes
+ *           it even again. A reader notes the sequence number, copies the data out,
+ *           and checks that the number was even and hasn't changed; if not, the copy
+ *           may be torn, and it's made again. Readers never disable interrupts, and
+ *           neither does the writer, so an ISR can publish a multi-byte item like a
+ *           position and timestamp for the cost of a copy and two increments.
+ *
+ *           The sequence number is 16 bits, so a reader is only fooled if it's held
+ *           up for 32768 writes and then finds the number where it started; with 8
+ *           bits, 128 writes would do it, which an encoder ISR can make while a
+ *           low priority task waits. The AVR reads 16 bits one byte at a time, so
+ *           the number is read with @c read_sequence(), which reads the high byte
+ *           again after the low one and starts over if it changed.
+ *
+ *           There must be only one writer, and it must not be preempted by a reader
+ *           while it writes, because a reader would then retry for ever. An ISR, or a
+ *           task with a higher priority than any of the readers, is fine. Readers may
+ *           not run in an ISR which can interrupt the writer, for the same reason.
+ *
+ *           Objects of this class are in the list of shared data items, so
+ *           @c print_all_shares() prints them. Printing uses @c operator<< for the
+ *           data type, so a struct needs its own operator to be printed.
+ */
+
+template <class DataType> class SeqShare : public BaseShare
+{
+protected:
+	/// The sequence number, odd while a write is under way
+	volatile uint16_t sequence;
+
+	/// The data itself
+	DataType the_data;
+
+	/// The number of reads which had to be repeated because of a write. Readers in
+	/// different tasks can count at the same moment and lose a count, so it's only
+	/// approximate; it's for tuning, and making it exact would take a critical section
+	uint16_t retries;
+
+	// Read the sequence number without tearing it
+	uint16_t read_sequence (void);
+
+public:
+	// The constructor creates a shared data item with a name
+	SeqShare (const char* p_name = NULL);
+
+	// The writer calls this method to publish new data
+	void put (const DataType& new_data);
+
+	/// An ISR publishes data the same way a task does; this method is here so that a
+	/// @c SeqShare can be used in place of a @c TaskShare
+	void ISR_put (const DataType& new_data) { put (new_data); }
+
+	// Readers call this method to get a consistent copy of the data
+	void get (DataType& copy);
+
+	/** This method returns a consistent copy of the data.
+	 *  @return A copy of the most recently published data
+	 */
+	DataType get (void)
+	{
+		DataType copy;
+		get (copy);
+		return copy;
+	}
+
+	/// Get the number of reads which have had to be repeated, for tuning; the count
+	/// is approximate when several tasks read the item
+	uint16_t get_retries (void) { return retries; }
+
+	// Print the name, sequence number, retries, and data in the list of shares
+	void print_in_list (emstream* p_ser_dev);
+};
+
+
+//-------------------------------------------------------------------------------------
+/** This constructor creates a sequence-locked shared data item.
+ *  @param p_name A name for the item, printed in the list of shares (default: NULL)
+ */
+
+template <class DataType>
+SeqShare<DataType>::SeqShare (const char* p_name)
+	: BaseShare (p_name)
+{
+	sequence = 0;
+	retries = 0;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method publishes new data. Only one task or ISR may call it.
+ *  @param new_data The data to be copied into the shared item
+ */
+
+template <class DataType>
+void SeqShare<DataType>::put (const DataType& new_data)
+{
+	sequence++;
+	SEQ_BARRIER ();
+	the_data = new_data;
+	SEQ_BARRIER ();
+	sequence++;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method reads the sequence number. The AVR reads the two bytes separately, and
+ *  a write between them could pair a low byte with the wrong high byte, so the high
+ *  byte is read on both sides of the low one and the read is repeated if it changed.
+ *  Both the AVR and the PC are little-endian, so the low byte comes first.
+ *  @return The sequence number, as it was when its low byte was read
+ */
+
+template <class DataType>
+uint16_t SeqShare<DataType>::read_sequence (void)
+{
+	const volatile uint8_t* p_bytes = (const volatile uint8_t*)&sequence;
+	uint8_t high;
+	uint8_t low;
+	do
+	{
+		high = p_bytes[1];
+		low = p_bytes[0];
+	}
+	while (high != p_bytes[1]);
+
+	return ((uint16_t)high << 8) | low;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method copies the data out, repeating the copy until it didn't overlap a write.
+ *  @param copy A reference to the variable into which the data will be copied
+ */
+
+template <class DataType>
+void SeqShare<DataType>::get (DataType& copy)
+{
+	for (;;)
+	{
+		uint16_t before = read_sequence ();
+		SEQ_BARRIER ();
+		copy = the_data;
+		SEQ_BARRIER ();
+		if (!(before & 1) && before == read_sequence ())
+		{
+			return;
+		}
+		retries++;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method prints the item's name, sequence number, the number of repeated reads,
+ *  and the data. Then it asks the next item in the list of shares to print itself.
+ *  @param p_ser_dev The serial device on which to print
+ */
+
+template <class DataType>
+void SeqShare<DataType>::print_in_list (emstream* p_ser_dev)
+{
+	// Print the name, padded to 16 characters so the columns line up
+	uint8_t slen = 0;
+	if (name != NULL)
+	{
+		*p_ser_dev << name;
+		slen = strlen (name);
+	}
+	for ( ; slen < 16; slen++)
+	{
+		*p_ser_dev << ' ';
+	}
+
+	*p_ser_dev << PMS ("seqlock\t") << sequence << '/' << retries << '\t'
+	           << get () << endl;
+
+	if (p_next != NULL)
+	{
+		p_next->print_in_list (p_ser_dev);
+	}
+}
+
+#endif // _SEQSHARE_H_
@@ -0,0 +1,428 @@
+//*************************************************************************************
+/** @file serial_dr.cpp
+ *    This file contains a serial port driver for the AVR's two USART's. Received
+ *    characters are buffered by interrupt service routines, which can also wake up a
+ *    task that's waiting for input, and characters to be sent are buffered and fed to
+ *    the USART by its data register empty interrupt.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Interrupt-driven transmit buffer with an overflow setting
+ *    @li 10-17-2026 Tasks waiting for room in the transmit buffer sleep on a semaphore
+ *    @li 10-17-2026 Added write_block() for frames which must be sent whole
+ *
+ */
+//*************************************************************************************
+
+#include <stdlib.h>                         // Include standard library header files
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>                    // For changing the transmit buffer safely
+
+#include "serial_dr.h"                      // Include header for the serial port class
+
+
+/// The receive buffers, one for each USART. The ISR's write at the heads and tasks
+/// read at the tails; each index is one byte, so it's read and written atomically
+static volatile char rx_buffer[2][SERIAL_RX_SIZE];
+static volatile uint8_t rx_head[2];
+static volatile uint8_t rx_tail[2];
+
+/// The semaphores which the receive ISR's give when characters arrive, or NULL
+static SemaphoreHandle_t rx_signal[2];
+
+/// The transmit buffers. Tasks put characters in at the heads with interrupts off,
+/// since more than one task may print, and the ISR's take them out at the tails
+static volatile char tx_buffer[2][SERIAL_TX_SIZE];
+static volatile uint8_t tx_head[2];
+static volatile uint8_t tx_tail[2];
+
+/// The semaphores which the transmit ISR's give when they make room, or NULL, and
+/// the number of tasks waiting on each. The ISR's only give while a task waits
+static SemaphoreHandle_t tx_signal[2];
+static volatile uint8_t tx_waiting[2];
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This constructor sets up a USART as a serial port.
+ *  @details The baud rate divisor is computed for double speed mode and rounded to
+ *           the nearest whole number, which keeps the error small at high rates.
+ *           The port starts out waiting when its transmit buffer is full.
+ *  @param   baud_rate The baud rate, from 115200 to 1000000 at 16 MHz
+ *  @param   port_number Which USART to use, 0 or 1 (default: 1)
+ */
+
+Serial_dr::Serial_dr (uint32_t baud_rate, uint8_t port_number)
+	: emstream ()
+{
+	port = (port_number == 0) ? 0 : 1;
+	p_UCSRA = (port == 0) ? &UCSR0A : &UCSR1A;
+	p_UCSRB = p_UCSRA + 1;                  // UCSRnB is just above UCSRnA
+	p_UDR = p_UCSRA + 6;                    // and UDRn is six above it
+
+	rx_head[port] = 0;
+	rx_tail[port] = 0;
+	rx_signal[port] = NULL;
+	tx_head[port] = 0;
+	tx_tail[port] = 0;
+	tx_signal[port] = NULL;
+	tx_waiting[port] = 0;
+	overflow = SERIAL_BLOCK;
+	dropped = 0;
+
+	// UBRRn is at offsets 4 and 5; UCSRnC, at offset 2, sets 8 data bits
+	uint16_t divisor = (uint16_t)((F_CPU + 4UL * baud_rate) / (8UL * baud_rate) - 1);
+	*(p_UCSRA + 5) = (uint8_t)(divisor >> 8);
+	*(p_UCSRA + 4) = (uint8_t)divisor;
+	*p_UCSRA = (1 << U2X0);
+	*(p_UCSRA + 2) = (1 << UCSZ01) | (1 << UCSZ00);
+	*p_UCSRB = (1 << RXEN0) | (1 << TXEN0) | (1 << RXCIE0);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method checks if the transmit buffer has room for another character.
+ *  @return True if a character can be put in the buffer without waiting
+ */
+
+bool Serial_dr::ready_to_send (void)
+{
+	return ((tx_head[port] + 1) & (SERIAL_TX_SIZE - 1)) != tx_tail[port];
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method puts one character into the transmit buffer.
+ *  @details The character is sent by the ISR when the ones ahead of it have gone. If
+ *           the buffer is full, what happens depends on the overflow setting: the
+ *           task waits for the ISR to make room, or the character is thrown away, or
+ *           the oldest character in the buffer is thrown away to make room for it.
+ *  @param   a_char The character to be sent
+ *  @return  True if the character was put in the buffer, false if it was thrown away
+ */
+
+bool Serial_dr::putchar (char a_char)
+{
+	for (;;)
+	{
+		bool stored = false;
+		bool thrown_away = false;
+		ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+		{
+			uint8_t head = tx_head[port];
+			uint8_t next = (head + 1) & (SERIAL_TX_SIZE - 1);
+			if (next == tx_tail[port] && overflow == SERIAL_DROP_OLDEST)
+			{
+				tx_tail[port] = (tx_tail[port] + 1) & (SERIAL_TX_SIZE - 1);
+				dropped++;
+			}
+			if (next != tx_tail[port])
+			{
+				tx_buffer[port][head] = a_char;
+				tx_head[port] = next;
+				*p_UCSRB |= (1 << UDRIE0);
+				stored = true;
+			}
+			else if (overflow == SERIAL_DROP_NEWEST)
+			{
+				dropped++;
+				thrown_away = true;
+			}
+		}
+		if (stored || thrown_away)
+		{
+			return stored;
+		}
+
+		wait_for_room ();
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method puts a block of bytes into the transmit buffer at once.
+ *  @details The bytes are only copied when there's room for all of them, and they're
+ *           copied with interrupts off, so characters which other tasks print go
+ *           before or after the block, never into it. Until there's room, the task
+ *           waits as @c putchar() does; if the overflow setting drops characters,
+ *           the whole block is thrown away, or enough of the oldest characters to
+ *           make room for it. A block too big for the buffer is sent a character at
+ *           a time, and could then be split.
+ *  @param   p_bytes The bytes to be sent
+ *  @param   length The number of bytes
+ *  @return  True if the block was put in the buffer, false if it was thrown away
+ */
+
+bool Serial_dr::write_block (const uint8_t* p_bytes, uint8_t length)
+{
+	if (length >= SERIAL_TX_SIZE)
+	{
+		bool stored = true;
+		for (uint8_t index = 0; index < length; index++)
+		{
+			stored = putchar ((char)p_bytes[index]) && stored;
+		}
+		return stored;
+	}
+
+	for (;;)
+	{
+		bool stored = false;
+		bool thrown_away = false;
+		ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+		{
+			uint8_t head = tx_head[port];
+			uint8_t room = (tx_tail[port] - head - 1) & (SERIAL_TX_SIZE - 1);
+			if (room < length && overflow == SERIAL_DROP_OLDEST)
+			{
+				tx_tail[port] = (tx_tail[port] + length - room) & (SERIAL_TX_SIZE - 1);
+				dropped += length - room;
+				room = length;
+			}
+			if (room >= length)
+			{
+				for (uint8_t index = 0; index < length; index++)
+				{
+					tx_buffer[port][head] = p_bytes[index];
+					head = (head + 1) & (SERIAL_TX_SIZE - 1);
+				}
+				tx_head[port] = head;
+				*p_UCSRB |= (1 << UDRIE0);
+				stored = true;
+			}
+			else if (overflow == SERIAL_DROP_NEWEST)
+			{
+				dropped += length;
+				thrown_away = true;
+			}
+		}
+		if (stored || thrown_away)
+		{
+			return stored;
+		}
+
+		wait_for_room ();
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method waits until the ISR has taken a character out of the full
+ *           transmit buffer.
+ *  @details With a semaphore set, the task is counted as waiting and sleeps on it;
+ *           the ISR gives it for each character it sends while anyone waits, so
+ *           each waiting task gets its turn and a give that comes before the take
+ *           isn't lost. Without one, the task yields to others of its priority. If
+ *           interrupts are off, which before the scheduler starts they are, the ISR
+ *           can't make room, so a character is sent from here.
+ */
+
+void Serial_dr::wait_for_room (void)
+{
+	if (!(SREG & (1 << SREG_I)))
+	{
+		send_oldest ();
+	}
+	else if (tx_signal[port] != NULL)
+	{
+		ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+		{
+			tx_waiting[port]++;
+		}
+		xSemaphoreTake (tx_signal[port], portMAX_DELAY);
+		ATOMIC_BLOCK (ATOMIC_RESTORESTATE)
+		{
+			tx_waiting[port]--;
+		}
+	}
+	else
+	{
+		taskYIELD ();
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method sends the oldest character in the transmit buffer by waiting until the
+ *  USART can take it. It's only called with interrupts off, so the ISR can't be
+ *  sending from the buffer at the same time.
+ */
+
+void Serial_dr::send_oldest (void)
+{
+	uint8_t tail = tx_tail[port];
+	if (tail != tx_head[port])
+	{
+		while (!(*p_UCSRA & (1 << UDRE0)))
+		{
+		}
+		*p_UDR = tx_buffer[port][tail];
+		tx_tail[port] = (tail + 1) & (SERIAL_TX_SIZE - 1);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method chooses what @c putchar() does when the transmit buffer is full. A
+ *  port which is shared by a task that mustn't be held up should drop characters;
+ *  one which carries frames that must arrive whole, such as telemetry, should wait.
+ *  @param a_policy @c SERIAL_BLOCK, @c SERIAL_DROP_NEWEST or @c SERIAL_DROP_OLDEST
+ */
+
+void Serial_dr::set_overflow (serial_overflow a_policy)
+{
+	overflow = a_policy;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method checks if a character has been received and is waiting to be read.
+ *  @return True if there's a character in the receive buffer
+ */
+
+bool Serial_dr::check_for_char (void)
+{
+	return rx_head[port] != rx_tail[port];
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method gets a character from the receive buffer. If the buffer is empty, it
+ *  waits for one, so it should normally be called after @c check_for_char().
+ *  @return The character
+ */
+
+char Serial_dr::getchar (void)
+{
+	while (rx_head[port] == rx_tail[port])
+	{
+	}
+	uint8_t tail = rx_tail[port];
+	char a_char = rx_buffer[port][tail];
+	rx_tail[port] = (tail + 1) & (SERIAL_RX_SIZE - 1);
+	return a_char;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method sets a semaphore which the receive ISR will give each time a character
+ *  arrives. It's usually a binary semaphore which one task takes to wait for input.
+ *  @param a_semaphore The semaphore, or NULL to stop giving one
+ */
+
+void Serial_dr::set_rx_signal (SemaphoreHandle_t a_semaphore)
+{
+	rx_signal[port] = a_semaphore;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method sets a semaphore on which a task waits when the transmit buffer is
+ *  full and the overflow setting is @c SERIAL_BLOCK. It should be a binary semaphore
+ *  which only this port uses.
+ *  @param a_semaphore The semaphore, or NULL to wait by yielding instead
+ */
+
+void Serial_dr::set_tx_signal (SemaphoreHandle_t a_semaphore)
+{
+	tx_signal[port] = a_semaphore;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function does the work of both receive ISR's: it puts a character into the
+ *  port's buffer, or drops it if the buffer is full, then gives the port's semaphore.
+ *  If that wakes a task of higher priority than the one which was interrupted, the
+ *  ISR switches to it straight away.
+ *  @param a_port The number of the USART which received the character
+ *  @param a_char The character
+ */
+
+static inline void receive (uint8_t a_port, char a_char)
+{
+	uint8_t head = rx_head[a_port];
+	uint8_t next = (head + 1) & (SERIAL_RX_SIZE - 1);
+	if (next != rx_tail[a_port])
+	{
+		rx_buffer[a_port][head] = a_char;
+		rx_head[a_port] = next;
+	}
+
+	if (rx_signal[a_port] != NULL)
+	{
+		BaseType_t woken = pdFALSE;
+		xSemaphoreGiveFromISR (rx_signal[a_port], &woken);
+		if (woken != pdFALSE)
+		{
+			taskYIELD ();
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** These ISR's are run when a character has been received by USART 0 or USART 1.
+ */
+
+ISR (USART0_RX_vect)
+{
+	receive (0, UDR0);
+}
+
+ISR (USART1_RX_vect)
+{
+	receive (1, UDR1);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function does the work of both data register empty ISR's: it sends the next
+ *  character from the port's transmit buffer, and turns the interrupt off when the
+ *  buffer is empty. @c putchar() turns it back on. If a task is waiting for room, the
+ *  port's semaphore is given, and the ISR switches to that task if it's of higher
+ *  priority than the one which was interrupted.
+ *  @param a_port The number of the USART which can take another character
+ *  @param p_UDR A pointer to the USART's data register
+ *  @param p_UCSRB A pointer to the USART's control register B
+ */
+
+static inline void transmit (uint8_t a_port, volatile uint8_t* p_UDR,
+                             volatile uint8_t* p_UCSRB)
+{
+	uint8_t tail = tx_tail[a_port];
+	if (tail != tx_head[a_port])
+	{
+		*p_UDR = tx_buffer[a_port][tail];
+		tail = (tail + 1) & (SERIAL_TX_SIZE - 1);
+		tx_tail[a_port] = tail;
+	}
+	if (tail == tx_head[a_port])
+	{
+		*p_UCSRB &= ~(1 << UDRIE0);
+	}
+
+	if (tx_waiting[a_port] && tx_signal[a_port] != NULL)
+	{
+		BaseType_t woken = pdFALSE;
+		xSemaphoreGiveFromISR (tx_signal[a_port], &woken);
+		if (woken != pdFALSE)
+		{
+			taskYIELD ();
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** These ISR's are run when USART 0 or USART 1 can take another character to send.
+ */
+
+ISR (USART0_UDRE_vect)
+{
+	transmit (0, &UDR0, &UCSR0B);
+}
+
+ISR (USART1_UDRE_vect)
+{
+	transmit (1, &UDR1, &UCSR1B);
+}
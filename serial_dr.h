@@ -0,0 +1,137 @@
+//======================================================================================
+/** @file serial_dr.h
+ *    This file contains the header for a serial port driver for the AVR's USART's.
+ *    Characters are received by an interrupt service routine into a ring buffer, and
+ *    the ISR can wake a task through a semaphore, so a task which waits for the user
+ *    to type something doesn't have to poll the port. Characters to be sent go into
+ *    another ring buffer which the data register empty interrupt sends, so printing
+ *    doesn't wait for the port unless the buffer is full.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Transmitting is interrupt driven, with a choice of what to do
+ *                   when the transmit buffer is full
+ *    @li 10-17-2026 A task waiting for room sleeps on a semaphore given by the ISR
+ *    @li 10-17-2026 Added write_block(), which puts a frame in the buffer all at once
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//======================================================================================
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _SERIAL_DR_H_
+#define _SERIAL_DR_H_
+
+#include <stdint.h>                         // Fixed-size integer types
+
+#include "emstream.h"                       // Header for serial ports and devices
+#include "FreeRTOS.h"                       // Header for the FreeRTOS RTOS
+#include "task.h"                           // Header for FreeRTOS task functions
+#include "queue.h"                          // Header for FreeRTOS queues
+#include "semphr.h"                         // Header for FreeRTOS semaphores
+
+
+/// The size of each port's receive buffer. It must be a power of two
+#define SERIAL_RX_SIZE      32
+
+/// The size of each port's transmit buffer. It must be a power of two, no more than
+/// 256; a full buffer takes 1.3 ms to send at 1 Mbaud and 11 ms at 115200 baud
+#define SERIAL_TX_SIZE      128
+
+
+/// What @c putchar() does when the transmit buffer is full
+enum serial_overflow
+{
+	SERIAL_BLOCK,                           ///< Wait until there's room
+	SERIAL_DROP_NEWEST,                     ///< Throw away the new character
+	SERIAL_DROP_OLDEST                      ///< Throw away the oldest waiting one
+};
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This class runs one of the AVR's two USART's as a serial port.
+ *  @details The port runs in double speed mode, 8 data bits, no parity, 1 stop bit.
+ *           At 16 MHz the rates from 115200 baud (2.1% fast) to 1 Mbaud can be
+ *           used; 250000, 500000 and 1000000 baud are exact.
+ *
+ *           Sending puts each character into a ring buffer and turns on the data
+ *           register empty interrupt, whose ISR feeds the buffer to the USART, so
+ *           a task which prints returns at once unless the buffer is full. What
+ *           happens then is set by @c set_overflow(): the task waits, or the new
+ *           character or the oldest waiting one is thrown away and counted. A task
+ *           which waits sleeps on the semaphore set with @c set_tx_signal(), which
+ *           the ISR gives each time it takes a character out of the buffer, so the
+ *           other tasks run meanwhile; without a semaphore, it gives up the
+ *           processor to tasks of its own priority until there's room. While
+ *           interrupts are off, as they are before the scheduler starts, a full
+ *           buffer is emptied by waiting on the USART instead.
+ *
+ *           Receiving is done by the receive complete interrupt, which puts each
+ *           character into a ring buffer and then gives the semaphore set with
+ *           @c set_rx_signal(), if there is one. A task can take that semaphore to
+ *           sleep until there's input, instead of waking up every millisecond to
+ *           check.
+ *
+ *           Only one object should be made for each port, and the ME405 library's
+ *           @c rs232 class must not be used in the same program, because it has
+ *           receive ISR's of its own.
+ */
+
+class Serial_dr : public emstream
+{
+protected:
+	/// Which USART this object runs, 0 or 1
+	uint8_t port;
+
+	/// The USART's registers. The others are found at fixed offsets from UCSRnA
+	volatile uint8_t* p_UCSRA;
+	volatile uint8_t* p_UCSRB;
+	volatile uint8_t* p_UDR;
+
+	/// What to do when the transmit buffer is full, a @c serial_overflow value
+	uint8_t overflow;
+
+	/// The number of characters thrown away because the transmit buffer was full
+	uint16_t dropped;
+
+	// Send the oldest character in the transmit buffer by waiting on the USART
+	void send_oldest (void);
+
+	// Wait for the ISR to make room in the transmit buffer
+	void wait_for_room (void);
+
+public:
+	// The constructor sets up the USART and turns on its receive interrupt
+	Serial_dr (uint32_t baud_rate, uint8_t port_number = 1);
+
+	// Check if the transmit buffer has room for another character
+	bool ready_to_send (void);
+
+	// Put one character in the transmit buffer, as the overflow setting says
+	bool putchar (char a_char);
+
+	// Put a block of bytes in the transmit buffer all at once, so nothing which
+	// another task prints can land in the middle of it
+	bool write_block (const uint8_t* p_bytes, uint8_t length);
+
+	// Choose what happens when the transmit buffer is full
+	void set_overflow (serial_overflow a_policy);
+
+	/// Get the number of characters thrown away because the buffer was full
+	uint16_t get_dropped (void) { return dropped; }
+
+	// Check if a character has been received
+	bool check_for_char (void);
+
+	// Get a received character, waiting until there is one
+	char getchar (void);
+
+	// Set a semaphore which the receive ISR gives whenever a character arrives
+	void set_rx_signal (SemaphoreHandle_t a_semaphore);
+
+	// Set a semaphore on which tasks wait for room in the transmit buffer
+	void set_tx_signal (SemaphoreHandle_t a_semaphore);
+};
+
+#endif // _SERIAL_DR_H_
@@ -9,6 +9,17 @@
  *    @li 10-29-2012 JRR Reorganized with global queue and shared data references
  *    @li 01-04-2014 JRR Re-reorganized, allocating shares with new now
  *    @Li 01-26-2016 Added chared pointers for motor powers and motor state control
+ *    @li 10-17-2026 Added setpoints for closed-loop motor control
+ *    @li 10-17-2026 Added the motor status snapshot and the telemetry switch
+ *    @li 10-17-2026 Added the semaphore which wakes the user interface task
+ *    @li 10-17-2026 Each motor's power, state and setpoint replaced by one command
+ *                   share per axis; encoder counts are an array by axis too
+ *    @li 10-17-2026 Added the vehicle's pose from odometry
+ *    @li 10-17-2026 Added the trace of each control loop run, and its switch
+ *    @li 10-17-2026 Motor commands are sent through a queue; the command shares now
+ *                   show the commands the motor task has applied
+ *    @li 10-17-2026 Added the result of the latest autotuning experiment
+ *    @li 10-17-2026 Added the state of the latest system identification experiment
  *
  *  License:
  *		This file is copyright 2015 by JR Ridgely and released under the Lesser GNU
@@ -30,6 +41,12 @@
 #ifndef _SHARES_H_
 #define _SHARES_H_
 
+#include "semphr.h"                         // Header for FreeRTOS semaphores
+#include "taskqueue.h"                      // Header of wrapper for FreeRTOS queues
+#include "seqshare.h"                       // Header for sequence-locked shares
+#include "task_motor.h"                     // For the motor status structure
+#include "odometry.h"                       // For the pose structure
+
 //-------------------------------------------------------------------------------------
 // Externs:  In this section, we declare variables and functions that are used in all
 // (or at least two) of the files in the data acquisition project. Each of these items
@@ -39,12 +56,38 @@
 // This queue allows tasks to send characters to the user interface task for display.
 extern TextQueue* p_print_ser_queue;
 
-//variables for motor parameters
-extern TaskShare<int16_t>* p_motor_power;
-extern TaskShare<uint8_t>* p_motor_state;
-extern TaskShare<int16_t>* p_motor_power2;
-extern TaskShare<uint8_t>* p_motor_state2;
-extern TaskShare<uint8_t>* p_encoder_count;
-extern TaskShare<uint8_t>* p_encoder_state;
+// The semaphore which wakes the user interface task when there's input or output
+extern SemaphoreHandle_t user_wakeup;
+
+// Commands to the motor task, which it applies at the start of each run
+extern TaskQueue<motor_cmd>* p_motor_cmd_queue;
+
+// The mode, power and setpoint each axis is following, published by the motor task
+extern TaskShare<axis_command>* p_axis_command[NUM_AXES];
+
+// What the latest autotuning experiment found, published by the motor task
+extern TaskShare<tune_result>* p_tune_result;
+
+// The state of the latest system identification experiment, one of the sysid_state
+// values; the user interface sets it running and the motor task says how it ended
+extern TaskShare<uint8_t>* p_sysid_state;
+
+// A snapshot of all the axes, published by the motor task every run
+extern SeqShare<motor_status>* p_motor_status;
+
+// Whether the telemetry task is streaming packets
+extern TaskShare<bool>* p_telemetry_on;
+
+// What each run of the motor task's loop read, which the telemetry task sends on
+extern TaskQueue<motor_trace>* p_motor_trace;
+
+// Whether the motor task is putting its runs in the trace queue
+extern TaskShare<bool>* p_trace_on;
+
+// Positions of the axes' encoders, copied from the encoder ISR's by task_encoder
+extern TaskShare<int32_t>* p_encoder_count[NUM_AXES];
+
+// The vehicle's position and heading, published by the odometry task
+extern SeqShare<odo_pose>* p_pose;
 
 #endif // _SHARES_H_
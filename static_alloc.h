@@ -0,0 +1,92 @@
+//======================================================================================
+/** @file static_alloc.h
+ *    This file contains macros which make the objects that are created once at
+ *    startup, such as tasks, shares and drivers, in static memory rather than on the
+ *    heap when the program is built with @c -DSTATIC_ALLOCATION. Each object then
+ *    has its own place in the @c .bss section, so the size printed by the linker is
+ *    the RAM the program really uses, and no heap bookkeeping is needed for them.
+ *    Without the define, the macros use @c new just as before.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//======================================================================================
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _STATIC_ALLOC_H_
+#define _STATIC_ALLOC_H_
+
+#include <stdint.h>                         // Fixed-size integer types
+#include <stdlib.h>                         // For size_t
+
+#include "FreeRTOS.h"                       // Primary header for FreeRTOS
+#include "semphr.h"                         // Header for FreeRTOS semaphores
+
+
+#ifdef STATIC_ALLOCATION
+
+	// The host's C++ library declares placement new; avr-libc has no C++ library,
+	// so it's declared here
+	#ifdef HOST_BUILD
+		#include <new>
+	#else
+		/** This operator constructs an object in memory which has already been found
+		 *  for it.
+		 *  @param p_where Where the object goes
+		 *  @return The same pointer
+		 */
+		inline void* operator new (size_t, void* p_where) { return p_where; }
+	#endif
+
+	namespace
+	{
+		/** @brief   This template holds the static memory for the objects made at one
+		 *           place in the program.
+		 *  @details Each use of a macro below is a different instantiation, because
+		 *           @c __COUNTER__ gives each one a different number, so each gets its
+		 *           own memory. The template is in an unnamed namespace, so the
+		 *           numbers in different files can't clash.
+		 */
+		template <class Type, int site, uint8_t count = 1> struct static_slot
+		{
+			/// Room for @c count objects, aligned for any type
+			static uint8_t storage[count][sizeof (Type)] __attribute__ ((aligned));
+		};
+
+		template <class Type, int site, uint8_t count>
+		uint8_t static_slot<Type, site, count>::storage[count][sizeof (Type)];
+	}
+
+	/// Make an object of a type with the constructor arguments in parentheses, as
+	/// in @c STATIC_NEW (TaskShare<bool>, ("Flag")). This line of code always makes
+	/// the same object, so it must only run once
+	#define STATIC_NEW(type, args) \
+		(new (static_slot<type, __COUNTER__>::storage[0]) type args)
+
+	/// Make object number @c index of up to @c count objects which are made by the
+	/// same line of code, such as one for each axis in a loop
+	#define STATIC_NEW_ONE_OF(type, count, index, args) \
+		(new (static_slot<type, __COUNTER__, (count)>::storage[index]) type args)
+
+	#if (configSUPPORT_STATIC_ALLOCATION == 1)
+		/// Make a binary semaphore whose memory is static too
+		#define STATIC_SEMAPHORE_BINARY() xSemaphoreCreateBinaryStatic \
+			((StaticSemaphore_t*)(static_slot<StaticSemaphore_t, __COUNTER__>::storage[0]))
+	#endif
+
+#else
+
+	#define STATIC_NEW(type, args) (new type args)
+	#define STATIC_NEW_ONE_OF(type, count, index, args) (new type args)
+
+#endif // STATIC_ALLOCATION
+
+// Without static allocation in the RTOS as well, a semaphore is made on the heap
+#ifndef STATIC_SEMAPHORE_BINARY
+	#define STATIC_SEMAPHORE_BINARY() xSemaphoreCreateBinary ()
+#endif
+
+#endif // _STATIC_ALLOC_H_
@@ -0,0 +1,236 @@
+//*************************************************************************************
+/** @file sysid.cpp
+ *    This file contains system identification experiments, which drive an axis with
+ *    a PRBS or a chirp and record what its encoder sees in a buffer in RAM.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Each sample is the mean over a window of runs
+ *
+ */
+//*************************************************************************************
+
+#include <stdlib.h>                         // Include standard library header files
+
+#include "sysid.h"                          // Include header for the experiments
+#include "fixtrig.h"                        // For the chirp's sine
+#include "motor_dr.h"                       // For the largest power
+
+
+// The buffer and the experiment which is filling it or last filled it
+sysid_sample Sysid::samples[SYSID_SAMPLES];
+uint16_t Sysid::count = 0;
+uint8_t Sysid::every = 1;
+Sysid* Sysid::p_owner = NULL;
+volatile bool Sysid::complete = false;
+
+
+//-------------------------------------------------------------------------------------
+/** This constructor makes an experiment which isn't running; @c begin() starts it.
+ */
+
+Sysid::Sysid (void)
+{
+	setup.signal = SYSID_PRBS;
+	setup.offset = 0;
+	setup.hold = 1;
+	setup.every = 1;
+	setup.chirp_hz = 1;
+	setup.loop_hz = 1;
+	amplitude = 0;
+	lfsr = 1;
+	hold_left = 0;
+	phase = phase_step = phase_accel = 0;
+	window_start = 0;
+	window = 0;
+	power_sum = 0;
+	pending = false;
+	state = SYSID_IDLE;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method starts an experiment, emptying the buffer.
+ *  @details The chirp's phase moves a little more each run, so its frequency rises
+ *           steadily. It ends at @c chirp_hz after the @c SYSID_SAMPLES @c every runs
+ *           of the capture, so each run the step grows by 2^32 chirp_hz / (loop_hz
+ *           SYSID_SAMPLES every); that's worked out in two parts so it fits in 32
+ *           bits. The chirp can go no higher than half the rate at which samples
+ *           are taken, so the record can show it.
+ *  @param   position The axis's present position, in encoder counts
+ *  @param   size The size of the excitation; only its size is used, and zero means
+ *                @c SYSID_POWER
+ *  @param   a_setup The kind of excitation and how it's shaped
+ */
+
+void Sysid::begin (int32_t position, int16_t size, const sysid_setup& a_setup)
+{
+	// If another axis is filling the buffer, this one can't run
+	if (p_owner != NULL && p_owner != this && p_owner->is_running ())
+	{
+		state = SYSID_BUSY;
+		return;
+	}
+
+	setup = a_setup;
+	if (setup.hold == 0)
+	{
+		setup.hold = 1;
+	}
+	if (setup.every == 0)
+	{
+		setup.every = 1;
+	}
+	if (setup.loop_hz == 0)
+	{
+		setup.loop_hz = 1;
+	}
+	if (setup.chirp_hz > setup.loop_hz / (2 * setup.every))
+	{
+		setup.chirp_hz = setup.loop_hz / (2 * setup.every);
+	}
+
+	amplitude = (size < 0) ? -size : size;
+	if (amplitude == 0)
+	{
+		amplitude = SYSID_POWER;
+	}
+	if (amplitude > MOTOR_POWER_MAX)
+	{
+		amplitude = MOTOR_POWER_MAX;
+	}
+
+	lfsr = (1 << SYSID_LFSR_BITS) - 1;
+	hold_left = setup.hold;
+	phase = 0;
+	phase_step = 0;
+	phase_accel = ((((uint32_t)setup.chirp_hz << 16) / setup.loop_hz) << 16)
+	              / ((uint32_t)SYSID_SAMPLES * setup.every);
+	window_start = position;
+	window = 0;
+	power_sum = 0;
+	pending = false;
+
+	complete = false;
+	count = 0;
+	every = setup.every;
+	p_owner = this;
+	state = SYSID_RUNNING;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method works out the excitation for this run and moves the PRBS or the chirp
+ *  along to the next one. The power is limited to the motor's range, so an offset
+ *  near full power clips the excitation.
+ *  @return The power to give the motor
+ */
+
+int16_t Sysid::excite (void)
+{
+	int16_t power;
+
+	if (setup.signal == SYSID_CHIRP)
+	{
+		int32_t wave = ((int32_t)amplitude * fix_sin ((uint16_t)(phase >> 16)))
+		               >> FIX_TRIG_BITS;
+		power = setup.offset + (int16_t)wave;
+		phase_step += phase_accel;
+		phase += phase_step;
+	}
+	else
+	{
+		power = (lfsr & 1) ? setup.offset + amplitude : setup.offset - amplitude;
+		if (--hold_left == 0)
+		{
+			hold_left = setup.hold;
+			uint16_t feedback = (lfsr >> (SYSID_LFSR_BITS - 1))
+			                    ^ (lfsr >> (SYSID_LFSR_TAP - 1));
+			lfsr = ((lfsr << 1) | (feedback & 1)) & ((1 << SYSID_LFSR_BITS) - 1);
+		}
+	}
+
+	if (power > MOTOR_POWER_MAX)
+	{
+		power = MOTOR_POWER_MAX;
+	}
+	else if (power < -MOTOR_POWER_MAX)
+	{
+		power = -MOTOR_POWER_MAX;
+	}
+	return power;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method runs one step of the experiment.
+ *  @details At the first run of each window, the sample for the window before it is
+ *           finished with the counts moved since that window started; a move too
+ *           big for 16 bits is limited, which would take an encoder far faster than
+ *           the motors can turn. At the last run of a window, the mean of its
+ *           powers is recorded, rounded to the nearest. Once the last sample has
+ *           been finished the experiment is over and the power is zero.
+ *  @param   position The axis's position from its encoder, in counts
+ *  @return  The power to give the motor
+ */
+
+int16_t Sysid::step (int32_t position)
+{
+	if (state != SYSID_RUNNING)
+	{
+		return 0;
+	}
+
+	if (window == 0)
+	{
+		if (pending)
+		{
+			int32_t moved = position - window_start;
+			if (moved > 32767L)
+			{
+				moved = 32767L;
+			}
+			else if (moved < -32767L)
+			{
+				moved = -32767L;
+			}
+			samples[count].moved = (int16_t)moved;
+			count++;
+			pending = false;
+		}
+		if (count >= SYSID_SAMPLES)
+		{
+			state = SYSID_DONE;
+			complete = true;
+			return 0;
+		}
+		window_start = position;
+		power_sum = 0;
+	}
+
+	int16_t power = excite ();
+	power_sum += power;
+	if (++window >= setup.every)
+	{
+		int32_t half = (power_sum < 0) ? -(setup.every / 2) : setup.every / 2;
+		samples[count].power = (int16_t)((power_sum + half) / setup.every);
+		pending = true;
+		window = 0;
+	}
+	return power;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method stops an experiment which is running, as when the axis is put in
+ *  another mode before the buffer is full. The buffer keeps what was recorded, but
+ *  isn't complete, so it isn't printed; another axis can then use it.
+ */
+
+void Sysid::stop (void)
+{
+	if (state == SYSID_RUNNING)
+	{
+		state = SYSID_IDLE;
+	}
+}
@@ -0,0 +1,182 @@
+//======================================================================================
+/** @file sysid.h
+ *    This file contains the header for system identification experiments, which
+ *    record how an axis answers a known excitation so a model of its motor can be
+ *    fitted on a PC. The motor is driven at the control rate with a pseudo-random
+ *    binary sequence (PRBS) or a chirp, a sine whose frequency sweeps up from zero.
+ *    Every @c every runs, the mean power and the encoder counts moved over those
+ *    runs are put in a buffer in RAM. Nothing is printed or sent while the
+ *    experiment runs; the user interface prints the buffer once it's full.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Samples are taken every few runs, so a capture can hold a whole
+ *                   PRBS period
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//======================================================================================
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _SYSID_H_
+#define _SYSID_H_
+
+#include <stdint.h>                         // Fixed-size integer types
+
+
+/// The number of samples which are recorded. Each takes four bytes of RAM, so the
+/// buffer, which all the axes share, takes 1600 bytes of the ATmega1281's 8 KB. A
+/// capture lasts @c SYSID_SAMPLES times @c every runs of the control loop
+#define SYSID_SAMPLES       400
+
+/// The excitation's size when the axis's command doesn't give one
+#define SYSID_POWER         100
+
+/// The PRBS comes from a 9-bit linear feedback shift register with taps for
+/// x^9 + x^5 + 1, whose sequence repeats every 511 bits
+#define SYSID_LFSR_BITS     9
+#define SYSID_LFSR_TAP      5
+
+
+/// The excitations which can be used; the number is the @c sysid_signal parameter
+enum sysid_signal
+{
+	SYSID_PRBS = 0,                         ///< Full power one way or the other
+	SYSID_CHIRP = 1                         ///< A sine swept up from zero frequency
+};
+
+/// The stages of an experiment
+enum sysid_state
+{
+	SYSID_IDLE,                             ///< No experiment has been started
+	SYSID_RUNNING,                          ///< The buffer is being filled
+	SYSID_DONE,                             ///< The buffer is full
+	SYSID_BUSY                              ///< Another axis was using the buffer
+};
+
+
+/** @brief   This structure holds how an experiment is to be run. The motor task
+ *           fills it in from the parameters when an axis starts one.
+ */
+
+struct sysid_setup
+{
+	uint8_t signal;                         ///< One of the @c sysid_signal values
+	int16_t offset;                         ///< Power around which the motor is driven
+	uint8_t hold;                           ///< Runs for which each PRBS bit is held
+	uint8_t every;                          ///< Runs which go into each sample
+	uint16_t chirp_hz;                      ///< Frequency at which the chirp ends
+	uint16_t loop_hz;                       ///< Runs of the control loop a second
+};
+
+
+/** @brief   This structure holds one sample of a recorded experiment, which covers
+ *           @c every runs of the control loop.
+ */
+
+struct sysid_sample
+{
+	int16_t power;                          ///< The mean power the motor was given
+	int16_t moved;                          ///< Encoder counts moved meanwhile
+};
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This class runs a system identification experiment on one axis.
+ *  @details @c begin() starts it, and @c step() is called every run of the control
+ *           loop with the encoder's position, giving the power for the motor. For a
+ *           PRBS, the power is the offset plus or minus the size given to
+ *           @c begin(), changing as the shift register says every @c hold runs. For
+ *           a chirp it's the offset plus the size times a sine whose frequency rises
+ *           steadily from zero to @c chirp_hz over the experiment. The runs are
+ *           taken in windows of @c every; each sample holds the mean power of the
+ *           runs in one window and the counts the encoder moved from the start of
+ *           that window to the start of the next, so the motion is that which
+ *           followed the power. Once @c SYSID_SAMPLES samples are recorded the power
+ *           is zero.
+ *
+ *           The PRBS repeats every 511 @c hold runs, so a capture holds a whole
+ *           period when @c SYSID_SAMPLES @c every is at least that. The mean over
+ *           each window keeps the power which went in when a bit changes within it.
+ *
+ *           The buffer is shared by all the axes, so only one can run an experiment
+ *           at a time; an axis which starts one while another's is running records
+ *           nothing and isn't driven. The buffer can be read once the experiment is
+ *           done, until another is started. Everything is done in integers with no
+ *           hardware touched, so it runs in @c Axis::step() at the control rate and
+ *           its timing is that of the control loop.
+ */
+
+class Sysid
+{
+protected:
+	/// How the experiment is run, and the size of the excitation
+	sysid_setup setup;
+	int16_t amplitude;
+
+	/// The shift register which makes the PRBS, and the runs left in this bit
+	uint16_t lfsr;
+	uint8_t hold_left;
+
+	/// The chirp's phase, whose upper 16 bits are a binary angle, the amount it
+	/// moves each run, and the amount that grows each run
+	uint32_t phase;
+	uint32_t phase_step;
+	uint32_t phase_accel;
+
+	/// The position at the start of the present window, the runs in it so far, the
+	/// sum of their powers, and whether a sample is waiting for its motion
+	int32_t window_start;
+	uint8_t window;
+	int32_t power_sum;
+	bool pending;
+
+	/// The state of this axis's experiment
+	uint8_t state;
+
+	/// The buffer, the number of samples in it, and the experiment which owns it.
+	/// The user interface task reads them once @c complete is set, which is a single
+	/// byte so it can be read while the motor task runs
+	static sysid_sample samples[SYSID_SAMPLES];
+	static uint16_t count;
+	static uint8_t every;
+	static Sysid* p_owner;
+	static volatile bool complete;
+
+	// Work out the excitation for this run
+	int16_t excite (void);
+
+public:
+	// The constructor makes an experiment which isn't running
+	Sysid (void);
+
+	// Start an experiment at a position with an excitation of some size
+	void begin (int32_t position, int16_t size, const sysid_setup& a_setup);
+
+	// Record one run of the experiment and return the motor's power
+	int16_t step (int32_t position);
+
+	// Stop the experiment before the buffer is full
+	void stop (void);
+
+	/// Find whether this axis's experiment is still going
+	bool is_running (void) { return state == SYSID_RUNNING; }
+
+	/// Get the state of this axis's experiment
+	uint8_t get_state (void) { return state; }
+
+	/// Find whether the buffer holds a finished experiment
+	static bool is_complete (void) { return complete; }
+
+	/// Get the number of samples in the buffer
+	static uint16_t get_count (void) { return count; }
+
+	/// Get the number of runs in each sample in the buffer
+	static uint8_t get_every (void) { return every; }
+
+	/// Get a sample from the buffer, which must be less than @c get_count()
+	static const sysid_sample& get_sample (uint16_t index) { return samples[index]; }
+};
+
+#endif // _SYSID_H_
@@ -14,6 +14,7 @@
  *    @li 11-04-2012 JRR Altered again into the multi-task monstrosity
  *    @li 12-13-2012 JRR Yet again transmogrified; now it controls LED brightness
  *    @li 1/19/2016 added motor driving and a timer for the same purpose
+ *    @li 10-17-2026 Timer 1 is set up by Motor_driver::setup_timer1()
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU
@@ -103,12 +104,8 @@ void task_brightness::run (void)
 	// This is the task loop for the brightness control task. This loop runs until the
 	// power is turned off or something equally dramatic occurs
 
-	//set up for the 8-bit fast pwm mode timer/counter
-	//COMnx1 is for setting it to a pin out as non-inverting
-	//WGM sets mode for PWM
-	//CS sets the prescalar to 8
-	TCCR1A = (1 << WGM10) | (1 << COM1A1) | (1 << COM1B1);
-	TCCR1B = (1 << WGM12) | (1 << CS11);
+	// Set up Timer 1 for 8-bit fast PWM, as this task has always run the motors
+	Motor_driver::setup_timer1 (MOTOR_PWM_FAST_8BIT);
 
 	for (;;)
 	{
@@ -1,7 +1,37 @@
+//**************************************************************************************
+/** @file task_encoder.cpp
+ *    This file contains a task which runs the quadrature encoder drivers and copies
+ *    the wheel positions into shares for the other tasks.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Task filled in; publishes 32-bit positions of both encoders
+ *    @li 10-17-2026 Loop timing is measured by the profiler
+ *    @li 10-17-2026 Publishes the position of each axis's encoder
+ *    @li 10-17-2026 Objects are made in static memory when STATIC_ALLOCATION is set
+ *
+ *  License:
+ *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU
+ *    Public License, version 2. It intended for educational use only, but its use
+ *    is not limited thereto. */
+//**************************************************************************************
+
 #include "textqueue.h"                      // Header for text queue class
-#include "task_motor.h"                // Header for this task
+#include "task_encoder.h"                   // Header for this task
 #include "shares.h"                         // Shared inter-task communications
+#include "static_alloc.h"                   // Static memory for objects made once
+
 
+//-------------------------------------------------------------------------------------
+/** This constructor creates the encoder task. The main job of this constructor is to
+ *  call the constructor of parent class (\c frt_task ); the parent's constructor the
+ *  work.
+ *  @param a_name A character string which will be the name of this task
+ *  @param a_priority The priority at which this task will initially run (default: 0)
+ *  @param a_stack_size The size of this task's stack in bytes
+ *                      (default: configMINIMAL_STACK_SIZE)
+ *  @param p_ser_dev Pointer to a serial device (port, radio, SD card, etc.) which can
+ *                   be used by this task to communicate (default: NULL)
+ */
 
 task_encoder::task_encoder (const char* a_name,
 				unsigned portBASE_TYPE a_priority,
@@ -15,10 +45,41 @@ task_encoder::task_encoder (const char* a_name,
 
 
 //-------------------------------------------------------------------------------------
+/** This method is called once by the RTOS scheduler. It sets up both encoders, then
+ *  each time around the for (;;) loop it copies their positions into the shares.
+ */
 
-
-void task_motor::run (void)
+void task_encoder::run (void)
 {
-	
-}
+	// Make a variable which will hold times to use for precise task scheduling
+	TickType_t previousTicks = xTaskGetTickCount ();
+
+	// Encoder 0 is on PE5 and PE6, which are external interrupts INT5 and INT6
+	STATIC_NEW (Encoder_dr, (p_serial, 0, &EICRB, ISC50, ISC60, &EIMSK, INT5, INT6,
+	                         &PORTE, PE5));
 
+	// Encoder 1 is on PD0 and PD1, which are external interrupts INT0 and INT1
+	STATIC_NEW (Encoder_dr, (p_serial, 1, &EICRA, ISC00, ISC10, &EIMSK, INT0, INT1,
+	                         &PORTD, PD0));
+
+	LoopProfile* p_profile = STATIC_NEW (LoopProfile, ("Encoder Drive", 5));
+
+	for (;;)
+	{
+		p_profile->begin ();
+
+		// The ISR's keep the counts; all this task has to do is publish them
+		for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+		{
+			p_encoder_count[axis]->put (Encoder_dr::position_of (axis_table[axis].encoder));
+		}
+
+		// Increment the run counter. This counter belongs to the parent class and can
+		// be printed out for debugging purposes
+		runs++;
+		p_profile->end ();
+
+		// Publish the positions every few milliseconds
+		delay_from_for_ms (previousTicks, 5);
+	}
+}
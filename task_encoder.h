@@ -1,3 +1,18 @@
+//**************************************************************************************
+/** @file task_encoder.h
+ *    This file contains the header for a task class which runs the quadrature encoder
+ *    drivers and makes the wheel positions available to other tasks through shares.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Task filled in; publishes 32-bit positions of both encoders
+ *
+ *  License:
+ *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU
+ *    Public License, version 2. It intended for educational use only, but its use
+ *    is not limited thereto. */
+//**************************************************************************************
+
+// This define prevents this .h file from being included multiple times in a .cpp file
 #ifndef _TASK_encoder_H_
 #define _TASK_encoder_H_
 
@@ -15,11 +30,17 @@
 #include "taskshare.h"                      // Header for thread-safe shared data
 
 #include "rs232int.h"                       // ME405/507 library for serial comm.
-#include "adc.h"                            // Header for A/D converter driver class
-#include "motor_dr.h"
-
+#include "encoder_dr.h"                     // Header for quadrature encoder driver
+#include "profiler.h"                       // Header for the loop timing profiler
 
 
+//-------------------------------------------------------------------------------------
+/** @brief   This task runs the wheel encoders.
+ *  @details The counting is done by interrupt service routines in the encoder driver
+ *           in @c encoder_dr.cpp. This task creates the drivers and then periodically
+ *           copies each encoder's position into a share, so that other tasks never
+ *           need to touch the encoder hardware or the ISR's data.
+ */
 
 class task_encoder : public TaskBase
 {
@@ -30,9 +51,11 @@ protected:
 	// No protected variables or methods for this class
 
 public:
+	// This constructor creates the encoder task
 	task_encoder (const char*, unsigned portBASE_TYPE, size_t, emstream*);
 
+	// This method is called by the RTOS once to run the task loop for ever and ever.
 	void run (void);
 };
 
-#endif // _TASK_encoder_H_
\ No newline at end of file
+#endif // _TASK_encoder_H_
@@ -14,6 +14,26 @@
  *    @li 12-13-2012 JRR Yet again transmogrified; now it controls LED brightness
  *    @li 1/10/2016  added motor driving
  *    @Li 1/26/2016  created multiple states for motor control to be opperated by a user
+ *    @li 10-17-2026 Closed-loop position and velocity control with a PID per motor,
+ *                   run every 2 ms; each motor now follows its own state
+ *    @li 10-17-2026 Publishes positions, readings, powers and loop time for telemetry
+ *    @li 10-17-2026 Loop timing is measured by the profiler
+ *    @li 10-17-2026 Motors are driven through the fixed-pin Motor_driver_fixed
+ *    @li 10-17-2026 Motor PWM runs at 20 kHz in phase correct mode
+ *    @li 10-17-2026 Loop can be woken by a 1-2 kHz timer interrupt instead of a delay
+ *    @li 10-17-2026 Velocity comes from the encoders' M/T estimate, not a difference
+ *    @li 10-17-2026 Each motor is run by an Axis, in a loop over a fixed array of them
+ *    @li 10-17-2026 Objects are made in static memory when STATIC_ALLOCATION is set
+ *    @li 10-17-2026 Potentiometer mode is converted by axis_pot_command()
+ *    @li 10-17-2026 Puts what each run read in the trace queue while tracing is on
+ *    @li 10-17-2026 Gains and loop rate come from the parameters, and the gains are
+ *                   reread whenever a parameter is changed
+ *    @li 10-17-2026 Commands come from a queue and are applied together at the start
+ *                   of each run; their latency to the motors is measured
+ *    @li 10-17-2026 Both motors are changed together at a TOP of Timer 1
+ *    @li 10-17-2026 Publishes the result of an autotuning experiment and brakes
+ *    @li 10-17-2026 Publishes how a system identification experiment ended and brakes
+ *    @li 10-17-2026 Comments describe the motor task rather than the LED brightness one
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU
@@ -34,12 +54,43 @@
 #include "textqueue.h"                      // Header for text queue class
 #include "task_motor.h"                // Header for this task
 #include "shares.h"                         // Shared inter-task communications
+#include "static_alloc.h"                   // Static memory for objects made once
+
+
+/// The axes, one for each line of @c axis_table. They're kept in one fixed array
+/// rather than made with @c new, so the loop steps through them in order
+static Axis axes[NUM_AXES];
 
 
 //-------------------------------------------------------------------------------------
-/** This constructor creates a task which controls the brightness of an LED using
- *  input from an A/D converter. The main job of this constructor is to call the
- *  constructor of parent class (\c frt_task ); the parent's constructor the work.
+/** This function makes the change which a queued command asks for in an axis's
+ *  command.
+ *  @param command The axis's command, which is changed
+ *  @param cmd The queued command
+ */
+
+static void apply_command (axis_command& command, const motor_cmd& cmd)
+{
+	switch (cmd.type)
+	{
+		case (MOTOR_CMD_MODE):
+			command.mode = (uint8_t)cmd.value;
+			break;
+		case (MOTOR_CMD_POWER):
+			command.power = (int16_t)cmd.value;
+			break;
+		case (MOTOR_CMD_SETPOINT):
+			command.setpoint = cmd.value;
+			break;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This constructor creates the task which runs the control loop of every axis, with
+ *  the commands, autotuning, system identification and trace which go with it. The
+ *  main job of this constructor is to call the constructor of parent class
+ *  (\c frt_task ); the parent's constructor the work.
  *  @param a_name A character string which will be the name of this task
  *  @param a_priority The priority at which this task will initially run (default: 0)
  *  @param a_stack_size The size of this task's stack in bytes
@@ -62,25 +113,70 @@ task_motor::task_motor (const char* a_name,
 //-------------------------------------------------------------------------------------
 /** This method is called once by the RTOS scheduler. Each time around the for (;;)
  *  loop, it reads the A/D converter and uses the result to control the brightness of
- *  an LED and also the speed of multiple motors.
+ *  an LED, then runs each axis in the mode the user has chosen for it, which is one
+ *  of the @c axis_mode values. In @c AXIS_POT mode, every such axis gets the power
+ *  set by the potentiometer, and brakes when the knob is near the middle.
+ *
+ *  The loop runs @c loop_hz times a second, and the PID gains are per run; both are
+ *  parameters (see params.h), which start at @c MOTOR_LOOP_HZ and the gains in
+ *  task_motor.h. With @c MOTOR_USE_CONTROL_TIMER set, each run is started by Timer
+ *  0's interrupt, and this task should have the highest priority so it starts as
+ *  soon as the interrupt returns; otherwise it's run by the RTOS every so many
+ *  milliseconds.
+ *
+ *  Changes to the axes' commands arrive in @c p_motor_cmd_queue. All the commands
+ *  which are waiting are applied at the start of a run, before any axis is stepped,
+ *  so a run never sees part of a change and a command waits at most one period. The
+ *  time from a command being sent to its axis's motor being driven is put in the
+ *  status, along with the longest such time.
+ *
+ *  While @c p_trace_on is set, what each run read, which is the knob, the axes'
+ *  commands and the encoders' readings, is put in @c p_motor_trace for the telemetry
+ *  task to send. That's all @c Axis::step() is given, so host/replay can run the
+ *  same steps again. The queue isn't waited for, so a run which finds it full is
+ *  left out of the trace rather than made late.
+ *
+ *  When an autotuning or system identification experiment ends, the axis is braked
+ *  and how it ended is published. A system identification experiment records in
+ *  this loop, so its samples are one period apart however busy the other tasks are.
+ *
+ *  @c make @c bench times one PID update ("PID::update") and the control step of
+ *  both axes with the commit ("Axis::step x2 and commit"), which is most of a run's
+ *  work, against the 16000 cycles the CPU runs in a millisecond. Those figures
+ *  haven't been recorded here yet; until they are, a run's cost is best read from
+ *  the profiler, which measures how late each run starts and how long it takes
+ *  from the first run on, and whose results the 's' command prints.
  */
 
 void task_motor::run (void)
 {
-	// Make a variable which will hold times to use for precise task scheduling
-	TickType_t previousTicks = xTaskGetTickCount ();
+	// Make a variable which will hold times to use for precise task scheduling, if
+	// the RTOS is scheduling this task's runs
+	#if !MOTOR_USE_CONTROL_TIMER
+		TickType_t previousTicks = xTaskGetTickCount ();
+	#endif
 
 	// Create an analog to digital converter driver object and a variable in which to
 	// store its output. The variable p_my_adc only exists within this run() method,
 	// so the A/D converter cannot be used from any other function or method
-	adc* p_my_adc = new adc (p_serial);
+	adc* p_my_adc = STATIC_NEW (adc, (p_serial));
 	*p_serial << *p_my_adc;
 
-	// Sets up motor 1. Uses PORTC for INA and DIAGA/B, and uses PORTB for PWM.
-	Motor_driver* p_motor_1 = new Motor_driver(p_serial,&PORTC,PC0,&PORTC,PC2,&PORTB,PB6,&OCR1B);
+	// Keep the potentiometer and the second analog input converting in the
+	// background, so reading them in the loop below doesn't wait for the A/D
+	const uint8_t scan_list[] = { 0, 1 };
+	p_my_adc->start_scan (scan_list, sizeof (scan_list));
 
-	// Sets up motor 2, Uses PORTD for INA and DIAGA/B, and uses PORTB for PWM.
-	Motor_driver* p_motor_2 = new Motor_driver(p_serial,&PORTD,PD5,&PORTD,PD7,&PORTB,PB5,&OCR1A);
+	// Give each axis its motor and encoder, which sets up the motor's pins. The
+	// ports and pins are in axis.h and axis.cpp, and the gains are parameters
+	pid_gains position_gains;
+	pid_gains velocity_gains;
+	axis_param_gains (position_gains, velocity_gains);
+	uint8_t param_changes_seen = param_change_count;
+	for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+	{
+		axes[axis].init (&axis_table[axis], position_gains, velocity_gains);
+	}
 
 
 	// Configure counter/timer 3 as a PWM for LED brightness. First set the data
@@ -103,58 +199,154 @@ void task_motor::run (void)
 	// This is the task loop for the brightness control task. This loop runs until the
 	// power is turned off or something equally dramatic occurs
 
-	//set up for the 8-bit fast pwm mode timer/counter
-	//COMnx1 is for setting it to a pin out as non-inverting
-	//WGM sets mode for PWM
-	//CS sets the prescalar to 8
-	TCCR1A = (1 << WGM10) | (1 << COM1A1) | (1 << COM1B1);
-	TCCR1B = (1 << WGM12) | (1 << CS11);
+	// Set up Timer 1 to make the motors' PWM signals in the mode chosen in
+	// task_motor.h; set_power() scales to whatever TOP that mode uses
+	Motor_driver::setup_timer1 (MOTOR_PWM_MODE);
+
+	// The loop's run time is measured by the profiler each time around and published
+	// with the rest of the motors' status, so the telemetry task can stream it
+	// The loop's rate is a parameter which is only read here, so a new rate is used
+	// once it's saved and the AVR is reset
+	motor_status status;
+	status.commands = 0;
+	status.cmd_latency_us = 0;
+	status.max_cmd_latency_us = 0;
+	uint16_t loop_hz = (uint16_t)param_get (PARAM_LOOP_HZ);
+	#if MOTOR_USE_CONTROL_TIMER
+		LoopProfile* p_profile = STATIC_NEW (LoopProfile, ("MotorDrive"));
+		p_profile->set_period_us (1000000UL / loop_hz);
+		Control_timer* p_timer = STATIC_NEW (Control_timer, (loop_hz));
+	#else
+		uint16_t period_ms = 1000 / loop_hz;
+		LoopProfile* p_profile = STATIC_NEW (LoopProfile, ("MotorDrive", period_ms));
+	#endif
+
+	// The commands the axes are following; they start as the ones main() put in the
+	// shares, and are changed only by the queued commands
+	axis_command commands[NUM_AXES];
+	for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+	{
+		commands[axis] = p_axis_command[axis]->get ();
+	}
 
 	for (;;)
 	{
+		p_profile->begin ();
+
+		// Apply every command which has arrived since the last run. The oldest one's
+		// time is kept, as it's the one which has waited longest for the motors
+		uint8_t applied = 0;
+		uint8_t changed_axes = 0;
+		uint32_t oldest_time = 0;
+		motor_cmd cmd;
+		while (!p_motor_cmd_queue->is_empty ())
+		{
+			p_motor_cmd_queue->get (&cmd);
+			if (cmd.axis < NUM_AXES)
+			{
+				apply_command (commands[cmd.axis], cmd);
+				changed_axes |= (1 << cmd.axis);
+			}
+			if (applied++ == 0)
+			{
+				oldest_time = cmd.time;
+			}
+		}
+
+		// If the user has changed a parameter, the gains may have changed; reading
+		// them takes a moment, so it's only done when something has changed
+		if (param_change_count != param_changes_seen)
+		{
+			param_changes_seen = param_change_count;
+			axis_param_gains (position_gains, velocity_gains);
+			for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+			{
+				axes[axis].set_gains (position_gains, velocity_gains);
+			}
+		}
+
 		// Read the A/D converter
 		uint16_t a2d_reading = p_my_adc->read_once (0);
+		status.adc[0] = a2d_reading;
+		status.adc[1] = p_my_adc->read_once (1);
 		//*p_serial << "Reading = " << a2d_reading << endl;
 
+		// The trace of this run is filled in as the axes are stepped
+		bool tracing = p_trace_on->get ();
+		motor_trace trace;
+		trace.run = (uint16_t)runs;
+		trace.time_ms = (uint16_t)(xTaskGetTickCount () * (1000 / configTICK_RATE_HZ));
+		trace.adc = a2d_reading;
+
 		// Convert the A/D reading into a PWM duty cycle. The A/D reading is between 0
 		// and 1023; the duty cycle should be between 0 and 255. Thus, divide by 4
 		uint16_t duty_cycle = a2d_reading / 4;
 
-		if(p_motor_state->get() == 0)//state for potentiometer adc control
+		for (uint8_t axis = 0; axis < NUM_AXES; axis++)
 		{
-			int16_t motor_read = (((int16_t)a2d_reading - 512)/3);
-			int16_t motor_power = ((motor_read-43)*2);
-			//these 2 lines create variables motor_read and motor_power that scale the
-			//a2d reading into a desired power out for the motors
+			// In potentiometer mode the knob sets the power; near the middle, the
+			// motor is braked
+			axis_command command = axis_pot_command (commands[axis], a2d_reading);
 
-			if(motor_read > 43)
-			{
+			// Velocity is in encoder counts per second, timed from the encoder's
+			// edges rather than counted per loop, so it stays smooth at low speed.
+			// This task is the only one which samples the encoders
+			enc_reading reading = axes[axis].sample ();
+			axis_output output = axes[axis].step (command, reading);
+			axes[axis].drive (output);
+			trace.command[axis] = commands[axis];
+			trace.reading[axis] = reading;
 
-			    p_motor_1->set_power (motor_power);		// Defines motor 1 power
-			    p_motor_2->set_power (motor_power);		// Defines motor 2 power
-			}
-			else if(motor_read < -43)
+			// Braking is recorded in the status as zero power
+			status.position[axis] = reading.position;
+			status.power[axis] = output.brake ? 0 : output.power;
+
+			// When an autotuning experiment ends, its result is published for the
+			// user interface and the axis is braked
+			if (commands[axis].mode == AXIS_AUTOTUNE
+				&& !axes[axis].get_tuner ().is_running ())
 			{
-			    p_motor_1->set_power (motor_power);		// Defines motor 1 power
-			    p_motor_2->set_power (motor_power);		// Defines motor 2 power
+				tune_result result = axes[axis].get_tuner ().get_result ();
+				result.axis = axis;
+				p_tune_result->put (result);
+				commands[axis].mode = AXIS_BRAKE;
+				changed_axes |= (1 << axis);
 			}
-			else
+
+			// Likewise when a system identification experiment has filled the
+			// buffer, or couldn't start because another axis was using it
+			if (commands[axis].mode == AXIS_SYSID
+				&& !axes[axis].get_sysid ().is_running ())
 			{
-			    p_motor_1->brake(motor_power); //initiates the brake method on the motor
-			    p_motor_2->brake(motor_power);
+				p_sysid_state->put (axes[axis].get_sysid ().get_state ());
+				commands[axis].mode = AXIS_BRAKE;
+				changed_axes |= (1 << axis);
 			}
 		}
-		
-		else if(p_motor_state->get() == 1) // user power state
+
+		// The axes have only staged their motors' changes; Timer 1's interrupt makes
+		// all of them at the same PWM edge, within two PWM periods
+		Motor_group::commit ();
+
+		// The new commands have reached the motors, so their latency can be measured;
+		// then the changed commands are published for the user interface to show
+		if (applied)
 		{
-			p_motor_1->set_power (p_motor_power->get());	// Defines motor 1 power
-			p_motor_2->set_power (p_motor_power2->get());	// Defines motor 2 power
+			uint32_t ticks = LoopProfile::now () - oldest_time;
+			status.cmd_latency_us = LoopProfile::to_us (ticks > 0xFFFF ? 0xFFFF
+			                                            : (uint16_t)ticks);
+			if (status.cmd_latency_us > status.max_cmd_latency_us)
+			{
+				status.max_cmd_latency_us = status.cmd_latency_us;
+			}
+			status.commands += applied;
 		}
-		
-		else if(p_motor_state->get() == 2)//brake state
+		for (uint8_t axis = 0; axis < NUM_AXES; axis++)
 		{
-			p_motor_1->brake(p_motor_power->get()); //brakes the motors
-			p_motor_2->brake(p_motor_power2->get());
+			if (changed_axes & (1 << axis))
+			{
+				p_axis_command[axis]->put (commands[axis]);
+			}
 		}
 
 		// Set the brightness. Since the PWM has already been set up, we only need to
@@ -162,13 +354,51 @@ void task_motor::run (void)
 		// the output compare register for a given timer/counter
 		OCR3B = duty_cycle;
 
+		// The trace goes in the queue once the motors have their new commands
+		if (tracing)
+		{
+			p_motor_trace->put (trace);
+		}
+
+		// Publish the status, with the time this run took
+		p_profile->end ();
+		status.loop_us = p_profile->get_last_us ();
+		p_motor_status->put (status);
+
 		// Increment the run counter. This counter belongs to the parent class and can
 		// be printed out for debugging purposes
 		runs++;
 
-		// This is a method we use to cause a task to make one run through its task
-		// loop every N milliseconds and let other tasks run at other times
-		delay_from_for_ms (previousTicks, 100);
+		// Wait for the control timer's next tick, or, without the timer, use the
+		// method which makes a task run through its loop every N milliseconds
+		#if MOTOR_USE_CONTROL_TIMER
+			p_timer->wait ();
+		#else
+			delay_from_for_ms (previousTicks, period_ms);
+		#endif
 	}
 }
 
+
+
+//-------------------------------------------------------------------------------------
+/** This operator prints the motors' status on one line, so the status share can be
+ *  shown in the list of shares.
+ *  @param serpt Reference to a serial port to which the printout will be printed
+ *  @param status Reference to the status which is being printed
+ *  @return A reference to the same serial device on which we write information.
+ *          This is used to string together things to write with @c << operators
+ */
+
+emstream& operator << (emstream& serpt, const motor_status& status)
+{
+	for (uint8_t axis = 0; axis < NUM_AXES; axis++)
+	{
+		serpt << status.position[axis] << '/' << status.power[axis] << ' ';
+	}
+	serpt << PMS ("cts/pwr ") << status.adc[0] << ',' << status.adc[1] << PMS (" adc ")
+	      << status.loop_us << PMS (" us ") << status.commands << PMS (" cmds ")
+	      << status.cmd_latency_us << '/' << status.max_cmd_latency_us << PMS (" us");
+
+	return (serpt);
+}
@@ -1,9 +1,8 @@
 //**************************************************************************************
 /** @file task_motor.h
- *    This file contains the header for a task class that controls the brightness of an
- *    LED using a voltage measured from the A/D as input. The fun part: the brightness
- *    that is being controlled can be on another AVR computer, with signals being sent
- *    and received via wireless transceivers.
+ *    This file contains the header for the motor task, which runs the control loop of
+ *    every axis. It applies the commands queued by the user interface, and runs the
+ *    autotuning and system identification experiments and the trace of each run.
  *
  *  Revisions:
  *    @li 09-30-2012 JRR Original file was a one-file demonstration with two tasks
@@ -12,6 +11,13 @@
  *    @li 10-27-2012 JRR Altered from data sending task into LED blinking class
  *    @li 11-04-2012 JRR Altered again into the multi-task monstrosity
  *    @li 12-13-2012 JRR Yet again transmogrified; now it controls LED brightness
+ *    @li 10-17-2026 Added the control loop period and PID gains
+ *    @li 10-17-2026 Added the motor status which is published for telemetry
+ *    @li 10-17-2026 Motors' pins moved to axis.h; the status has one entry per axis
+ *    @li 10-17-2026 Added the trace of each run, from which the run can be replayed
+ *    @li 10-17-2026 The loop rate and gains here are the parameters' initial values
+ *    @li 10-17-2026 Added the queued motor commands and their latency in the status
+ *    @li 10-17-2026 Comments describe the motor task rather than the LED brightness one
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU
@@ -48,14 +54,140 @@
 #include "rs232int.h"                       // ME405/507 library for serial comm.
 #include "adc.h"                            // Header for A/D converter driver class
 #include "motor_dr.h"
+#include "encoder_dr.h"                     // Header for the encoder driver
+#include "axis.h"                           // Header for the motors' axes
+#include "seqshare.h"                       // Header for sequence-locked shares
+#include "pid.h"                            // Header for the PID controller
+#include "profiler.h"                       // Header for the loop timing profiler
+#include "control_timer.h"                  // Header for the control loop's timer
+
+
+/// If this is 1, the motor control loop is woken by Timer 0's interrupt at
+/// @c MOTOR_CONTROL_HZ; if it's 0, the loop is run by the RTOS every
+/// @c MOTOR_PERIOD_MS milliseconds
+#define MOTOR_USE_CONTROL_TIMER  1
+
+/// The rate of the timer-driven control loop in Hz, from 1 to 2 kHz
+#define MOTOR_CONTROL_HZ    1000
+
+/// The period of the RTOS-driven motor control loop in milliseconds; 2 ms is 500 Hz
+#define MOTOR_PERIOD_MS     2
+
+#if MOTOR_USE_CONTROL_TIMER
+	#if (MOTOR_CONTROL_HZ < 1000 || MOTOR_CONTROL_HZ > 2000)
+		#error MOTOR_CONTROL_HZ must be from 1000 to 2000
+	#endif
+
+	/// The rate at which the motor control loop runs, in runs per second, until the
+	/// @c loop_hz parameter is changed
+	#define MOTOR_LOOP_HZ   MOTOR_CONTROL_HZ
+#else
+	/// The rate at which the motor control loop runs, in runs per second, until the
+	/// @c loop_hz parameter is changed
+	#define MOTOR_LOOP_HZ   (1000 / MOTOR_PERIOD_MS)
+#endif
+
+/// Starting PID gains for position control in Q8.8 format, per run of the loop; they
+/// are the initial values of the @c pos_k* parameters. The error is in encoder
+/// counts, so the proportional gain of 2.0 gives full power for an error of about 128
+/// counts. The integral and derivative gains were tuned at 500 Hz and are scaled,
+/// with rounding, so the controller acts the same at any rate
+#define MOTOR_POS_KP        512
+#define MOTOR_POS_KI        ((4L * 500 + MOTOR_LOOP_HZ / 2) / MOTOR_LOOP_HZ)
+#define MOTOR_POS_KD        (2048L * MOTOR_LOOP_HZ / 500)
+
+/// Starting PID gains for velocity control in Q8.8 format, per run of the loop; they
+/// are the initial values of the @c vel_k* parameters. The error is in counts per
+/// second; the derivative isn't used because the velocity is already a difference of
+/// two positions
+#define MOTOR_VEL_KP        26
+#define MOTOR_VEL_KI        ((3L * 500 + MOTOR_LOOP_HZ / 2) / MOTOR_LOOP_HZ)
+#define MOTOR_VEL_KD        0
+
+
+/// The PWM mode for the motors. @c MOTOR_PWM_FAST_8BIT gives the old 7.8 kHz PWM
+#define MOTOR_PWM_MODE      MOTOR_PWM_PHASE_CORRECT
+
+/// The number of runs the trace queue holds. The telemetry task empties it every
+/// @c TELEM_PERIOD_MS, so at 1 kHz it holds more than twice what comes in between
+#define MOTOR_TRACE_QUEUE_SIZE  12
+
+/// The number of commands the motor command queue holds. The motor task empties it
+/// every run, so it only fills if commands come faster than one per axis per run
+#define MOTOR_CMD_QUEUE_SIZE  8
+
+/// How many RTOS ticks a task sending a command waits if the queue is full
+#define MOTOR_CMD_WAIT      10
+
+
+/// The things which a motor command can change in an axis's @c axis_command
+enum motor_cmd_type
+{
+	MOTOR_CMD_MODE,                         ///< The mode, one of the @c axis_mode values
+	MOTOR_CMD_POWER,                        ///< The power, or braking strength
+	MOTOR_CMD_SETPOINT                      ///< The closed-loop setpoint
+};
+
+
+/** @brief   This structure holds one command sent to the motor task through its
+ *           command queue.
+ *  @details The time is taken from the profiler's timer when the command is sent, so
+ *           the motor task can measure how long the command took to reach the motor.
+ */
+
+struct motor_cmd
+{
+	uint8_t axis;                           ///< Which axis, from 0 to NUM_AXES - 1
+	uint8_t type;                           ///< One of the @c motor_cmd_type values
+	int32_t value;                          ///< The new mode, power or setpoint
+	uint32_t time;                          ///< @c LoopProfile::now() when it was sent
+};
+
+
+/** @brief   This structure holds a snapshot of all the axes, published by the motor
+ *           task each time through its loop in a @c SeqShare.
+ */
+
+struct motor_status
+{
+	int32_t position[NUM_AXES];             ///< Encoder position of each axis
+	int16_t power[NUM_AXES];                ///< Power given to each motor, 0 if braking
+	uint16_t adc[2];                        ///< A/D channels 0 and 1
+	uint16_t loop_us;                       ///< How long the last run of the loop took
+	uint16_t commands;                      ///< Commands applied since startup
+	uint16_t cmd_latency_us;                ///< Latest command's time to the motor
+	uint16_t max_cmd_latency_us;            ///< Longest command's time to the motor
+};
+
+/** @brief   This structure holds what one run of the motor task's loop read: the
+ *           knob, each axis's command and each encoder's reading.
+ *  @details While tracing is on, the motor task puts one in @c p_motor_trace each
+ *           run without waiting; when the queue is full the run is left out, and the
+ *           gap in the run numbers shows it. The telemetry task sends them on.
+ */
+
+struct motor_trace
+{
+	uint16_t run;                           ///< Counts runs of the loop
+	uint16_t time_ms;                       ///< When the run began, in ms
+	uint16_t adc;                           ///< A/D channel 0, the potentiometer
+	axis_command command[NUM_AXES];         ///< The command each axis was following
+	enc_reading reading[NUM_AXES];          ///< Each encoder's reading
+};
+
+// This operator prints a motor status on one line
+emstream& operator << (emstream&, const motor_status&);
 
 
 //-------------------------------------------------------------------------------------
-/** @brief   This task controls the brightness of an LED using an analog input from
- *           the A/D converter.
- *  @details The A/D converter is run using a driver in files @c adc.h and @c adc.cpp.
- *           Code in this task sets up a timer/counter in PWM mode and controls the
- *           LED's average brightness.
+/** @brief   This task runs the control loop of every axis.
+ *  @details Each run applies the commands waiting in @c p_motor_cmd_queue, steps each
+ *           axis's controller, and has the staged motor powers take effect together.
+ *           It reads the potentiometer for the axes in potentiometer mode, publishes
+ *           the motor status for telemetry, and puts a trace of the run in
+ *           @c p_motor_trace while tracing is on. Autotuning and system identification
+ *           experiments run in the same loop, and when one finishes the task publishes
+ *           its result and brakes the motor.
  */
 
 class task_motor : public TaskBase
@@ -0,0 +1,92 @@
+//**************************************************************************************
+/** @file task_odometry.cpp
+ *    This file contains a task which works out the vehicle's pose from its wheel
+ *    encoders and publishes it for the other tasks.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Objects are made in static memory when STATIC_ALLOCATION is set
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//**************************************************************************************
+
+#include "textqueue.h"                      // Header for text queue class
+#include "task_odometry.h"                  // Header for this task
+#include "shares.h"                         // Shared inter-task communications
+#include "static_alloc.h"                   // Static memory for objects made once
+
+
+//-------------------------------------------------------------------------------------
+/** This function reads the count of one wheel, in the direction which is positive
+ *  when the vehicle drives forward.
+ *  @param axis The axis which drives the wheel
+ *  @param sign 1 if the wheel's encoder counts up going forward, -1 if down
+ *  @return The wheel's count
+ */
+
+static inline int32_t wheel_count (uint8_t axis, int8_t sign)
+{
+	int32_t count = Encoder_dr::position_of (axis_table[axis].encoder);
+	return (sign < 0) ? -count : count;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This constructor creates the odometry task. The main job of this constructor is to
+ *  call the constructor of parent class (\c frt_task ); the parent's constructor the
+ *  work.
+ *  @param a_name A character string which will be the name of this task
+ *  @param a_priority The priority at which this task will initially run (default: 0)
+ *  @param a_stack_size The size of this task's stack in bytes
+ *                      (default: configMINIMAL_STACK_SIZE)
+ *  @param p_ser_dev Pointer to a serial device (port, radio, SD card, etc.) which can
+ *                   be used by this task to communicate (default: NULL)
+ */
+
+task_odometry::task_odometry (const char* a_name,
+				unsigned portBASE_TYPE a_priority,
+				size_t a_stack_size,
+				emstream* p_ser_dev)
+	: TaskBase (a_name, a_priority, a_stack_size, p_ser_dev)
+{
+	// Nothing is done in the body of this constructor. All the work is done in the
+	// call to the frt_task constructor on the line just above this one
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method is called once by the RTOS scheduler. The vehicle's pose starts at the
+ *  origin, facing along the x axis, wherever the wheels are when the task starts.
+ *  Each time around the for (;;) loop, the pose is moved by the change in the
+ *  wheels' counts and published in @c p_pose.
+ */
+
+void task_odometry::run (void)
+{
+	// Make a variable which will hold times to use for precise task scheduling
+	TickType_t previousTicks = xTaskGetTickCount ();
+
+	Odometry* p_odometry = STATIC_NEW (Odometry,
+		(wheel_count (ODO_LEFT_AXIS, ODO_LEFT_SIGN),
+		 wheel_count (ODO_RIGHT_AXIS, ODO_RIGHT_SIGN)));
+
+	LoopProfile* p_profile = STATIC_NEW (LoopProfile, ("Odometry", ODO_PERIOD_MS));
+
+	for (;;)
+	{
+		p_profile->begin ();
+
+		p_odometry->update (wheel_count (ODO_LEFT_AXIS, ODO_LEFT_SIGN),
+		                    wheel_count (ODO_RIGHT_AXIS, ODO_RIGHT_SIGN));
+		p_pose->put (p_odometry->get_pose ());
+
+		// Increment the run counter. This counter belongs to the parent class and can
+		// be printed out for debugging purposes
+		runs++;
+		p_profile->end ();
+
+		delay_from_for_ms (previousTicks, ODO_PERIOD_MS);
+	}
+}
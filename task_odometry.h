@@ -0,0 +1,75 @@
+//**************************************************************************************
+/** @file task_odometry.h
+ *    This file contains the header for a task class which works out where the vehicle
+ *    is from its wheel encoders and makes the pose available to other tasks.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//**************************************************************************************
+
+// This define prevents this .h file from being included multiple times in a .cpp file
+#ifndef _TASK_ODOMETRY_H_
+#define _TASK_ODOMETRY_H_
+
+#include <stdlib.h>                         // Prototype declarations for I/O functions
+
+#include "FreeRTOS.h"                       // Primary header for FreeRTOS
+#include "task.h"                           // Header for FreeRTOS task functions
+#include "queue.h"                          // FreeRTOS inter-task communication queues
+
+#include "taskbase.h"                       // ME405/507 base task class
+#include "seqshare.h"                       // Header for sequence-locked shares
+
+#include "axis.h"                           // Header for the motors' axes
+#include "odometry.h"                       // Header for the odometry class
+#include "profiler.h"                       // Header for the loop timing profiler
+
+
+/// The period of the odometry task in milliseconds; 1 ms keeps up with the motor
+/// control loop
+#define ODO_PERIOD_MS       1
+
+/// The axes whose encoders are on the left and right wheels
+#define ODO_LEFT_AXIS       0
+#define ODO_RIGHT_AXIS      1
+
+/// The direction of each wheel's count: 1 if it counts up when the vehicle drives
+/// forward, -1 if it counts down, as one of a pair of mirrored motors does
+#define ODO_LEFT_SIGN       1
+#define ODO_RIGHT_SIGN      1
+
+#if (ODO_LEFT_AXIS >= NUM_AXES || ODO_RIGHT_AXIS >= NUM_AXES)
+	#error The odometry wheels must be axes in axis_table
+#endif
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This task keeps track of the vehicle's pose by dead reckoning.
+ *  @details Each run, it reads the positions which the encoder ISR's have published,
+ *           moves the pose by the change in the wheels' counts, and puts the pose in
+ *           a share. The arithmetic is all fixed point, and an update costs a few
+ *           hundred cycles; @c make @c bench gives the exact number, and the 's'
+ *           command shows the task's run time and lateness.
+ */
+
+class task_odometry : public TaskBase
+{
+private:
+	// No private variables or methods for this class
+
+protected:
+	// No protected variables or methods for this class
+
+public:
+	// This constructor creates the odometry task
+	task_odometry (const char*, unsigned portBASE_TYPE, size_t, emstream*);
+
+	// This method is called by the RTOS once to run the task loop for ever and ever.
+	void run (void);
+};
+
+#endif // _TASK_ODOMETRY_H_
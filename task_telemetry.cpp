@@ -0,0 +1,258 @@
+//**************************************************************************************
+/** @file task_telemetry.cpp
+ *    This file contains a task which streams binary telemetry packets through a
+ *    serial port, so that a PC can log the motors' behavior at a high rate.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Sends the tasks' loop profiles, one with each timing packet
+ *    @li 10-17-2026 Profile is made in static memory when STATIC_ALLOCATION is set
+ *    @li 10-17-2026 Sends the motor task's trace, with the commands it was following
+ *    @li 10-17-2026 Sends the log messages which are waiting in the log buffer
+ *    @li 10-17-2026 Each frame is put in the serial port's buffer all at once
+ *    @li 10-17-2026 Loops over the axes rather than sending two
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//**************************************************************************************
+
+#include <string.h>                         // For memcpy()
+
+#include "textqueue.h"                      // Header for text queue class
+#include "task_telemetry.h"                 // Header for this task
+#include "shares.h"                         // Shared inter-task communications
+#include "static_alloc.h"                   // Static memory for objects made once
+#include "log.h"                            // For the log messages being sent
+
+
+//-------------------------------------------------------------------------------------
+/** This constructor creates the telemetry task. The main job of this constructor is
+ *  to call the constructor of parent class (\c frt_task ); the parent's constructor
+ *  the work.
+ *  @param a_name A character string which will be the name of this task
+ *  @param a_priority The priority at which this task will initially run (default: 0)
+ *  @param a_stack_size The size of this task's stack in bytes
+ *                      (default: configMINIMAL_STACK_SIZE)
+ *  @param p_ser_dev Pointer to the serial device through which packets are sent
+ */
+
+task_telemetry::task_telemetry (const char* a_name,
+				unsigned portBASE_TYPE a_priority,
+				size_t a_stack_size,
+				Serial_dr* p_ser_dev)
+	: TaskBase (a_name, a_priority, a_stack_size, p_ser_dev)
+{
+	p_port = p_ser_dev;
+	sequence = 0;
+	for (uint8_t axis = 0; axis < TELEM_AXES; axis++)
+	{
+		traced[axis].mode = 0;
+		traced[axis].power = 0;
+		traced[axis].setpoint = 0;
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method is called once by the RTOS scheduler. Each time around the for (;;)
+ *  loop, if streaming is on, it sends the samples which are due. Then it sends the
+ *  runs which the motor task has traced since the last time, whether streaming is on
+ *  or not; the trace has its own switch.
+ */
+
+void task_telemetry::run (void)
+{
+	// Make a variable which will hold times to use for precise task scheduling
+	TickType_t previousTicks = xTaskGetTickCount ();
+
+	// The longest loop time seen since streaming was turned on
+	uint16_t max_loop_us = 0;
+
+	// The profiles of all the tasks are sent in turn; this is the next one to go
+	LoopProfile* p_profile = STATIC_NEW (LoopProfile, ("Telemetry", TELEM_PERIOD_MS));
+	LoopProfile* p_next_profile = NULL;
+	uint8_t profile_index = 0;
+
+	// Whether the axes' commands are to be sent with the next traced run even if
+	// they haven't changed
+	bool resend_commands = true;
+
+	for (;;)
+	{
+		p_profile->begin ();
+
+		if (p_telemetry_on->get ())
+		{
+			motor_status status = p_motor_status->get ();
+			uint16_t now = (uint16_t)(xTaskGetTickCount () * (1000 / configTICK_RATE_HZ));
+
+			if (status.loop_us > max_loop_us)
+			{
+				max_loop_us = status.loop_us;
+			}
+
+			telem_encoder encoder;
+			for (uint8_t axis = 0; axis < TELEM_AXES; axis++)
+			{
+				encoder.position[axis] = status.position[axis];
+			}
+			send (TELEM_ENCODER, now, &encoder, sizeof (encoder));
+
+			if (runs % TELEM_PWM_EVERY == 0)
+			{
+				telem_pwm pwm;
+				for (uint8_t axis = 0; axis < TELEM_AXES; axis++)
+				{
+					pwm.power[axis] = status.power[axis];
+				}
+				send (TELEM_PWM, now, &pwm, sizeof (pwm));
+			}
+
+			if (runs % TELEM_ADC_EVERY == 0)
+			{
+				telem_adc adc_sample;
+				adc_sample.reading[0] = status.adc[0];
+				adc_sample.reading[1] = status.adc[1];
+				send (TELEM_ADC, now, &adc_sample, sizeof (adc_sample));
+			}
+
+			if (runs % TELEM_TIMING_EVERY == 0)
+			{
+				telem_timing timing;
+				timing.loop_us = status.loop_us;
+				timing.max_loop_us = max_loop_us;
+				send (TELEM_TIMING, now, &timing, sizeof (timing));
+
+				if (p_next_profile == NULL)
+				{
+					p_next_profile = LoopProfile::get_first ();
+					profile_index = 0;
+				}
+				loop_stats stats;
+				p_next_profile->get_stats (stats);
+				telem_profile profile;
+				profile.task = profile_index++;
+				profile.cpu_permille = p_next_profile->get_cpu_permille ();
+				profile.max_exec_us = LoopProfile::to_us (stats.max_exec);
+				profile.max_late_us = LoopProfile::to_us (stats.max_late);
+				profile.misses = stats.misses;
+				send (TELEM_PROFILE, now, &profile, sizeof (profile));
+				p_next_profile = p_next_profile->get_next ();
+			}
+
+			// Send some of the waiting log messages. Each keeps the time at which it
+			// was logged, and its payload is only as long as its arguments
+			log_entry entry;
+			for (uint8_t count = 0; count < TELEM_LOGS_EVERY_RUN && log_take (entry);
+				 count++)
+			{
+				telem_log message;
+				message.id = entry.id;
+				memcpy (message.args, entry.args, entry.size);
+				send (TELEM_LOG, entry.time_ms, &message, sizeof (message.id) + entry.size);
+			}
+		}
+		else
+		{
+			max_loop_us = 0;
+		}
+
+		// Send the traced runs. Every so often the commands are sent again, so a
+		// decoder which started late or lost one catches up
+		if (runs % TELEM_TIMING_EVERY == 0)
+		{
+			resend_commands = true;
+		}
+		motor_trace trace;
+		while (!p_motor_trace->is_empty ())
+		{
+			p_motor_trace->get (&trace);
+			send_trace (trace, resend_commands);
+			resend_commands = false;
+		}
+
+		// Increment the run counter. This counter belongs to the parent class and can
+		// be printed out for debugging purposes
+		runs++;
+		p_profile->end ();
+
+		delay_from_for_ms (previousTicks, TELEM_PERIOD_MS);
+	}
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method builds a packet from a header, a payload and a CRC, frames it with
+ *  COBS, and sends the frame through the serial port with a zero delimiter on each
+ *  side. The leading zero costs a byte, but it means that text printed just before
+ *  the frame can't run into it and spoil it. The frame and its delimiters go into the
+ *  port's buffer in one piece, so text printed while it's sent can't get inside it.
+ *  @param type The type of packet, one of the @c telem_type codes
+ *  @param time_ms The time at which the sample was taken, in milliseconds
+ *  @param p_payload A pointer to the payload structure
+ *  @param length The size of the payload, at most @c TELEM_MAX_PAYLOAD bytes
+ */
+
+void task_telemetry::send (uint8_t type, uint16_t time_ms, const void* p_payload,
+						   uint8_t length)
+{
+	uint8_t packet[TELEM_MAX_PACKET];
+	uint8_t frame[TELEM_MAX_FRAME + 2];
+
+	telem_header header;
+	header.type = type;
+	header.sequence = sequence++;
+	header.time_ms = time_ms;
+
+	memcpy (packet, &header, sizeof (header));
+	memcpy (packet + sizeof (header), p_payload, length);
+	uint8_t size = sizeof (header) + length;
+	uint16_t crc = telem_crc (packet, size);
+	packet[size++] = (uint8_t)crc;
+	packet[size++] = (uint8_t)(crc >> 8);
+
+	uint8_t frame_size = telem_cobs_encode (packet, size, frame + 1);
+	frame[0] = 0;
+	frame[++frame_size] = 0;
+	p_port->write_block (frame, frame_size + 1);
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This method sends one run of the motor task's trace. Before it, a command packet
+ *  is sent for each axis whose command isn't the one last sent, so the decoder always
+ *  knows what the axes were following.
+ *  @param trace The run, as the motor task put it in the trace queue
+ *  @param resend True to send both axes' commands even if they haven't changed
+ */
+
+void task_telemetry::send_trace (const motor_trace& trace, bool resend)
+{
+	for (uint8_t axis = 0; axis < TELEM_AXES; axis++)
+	{
+		const axis_command& command = trace.command[axis];
+		if (resend || command.mode != traced[axis].mode
+			|| command.power != traced[axis].power
+			|| command.setpoint != traced[axis].setpoint)
+		{
+			telem_command packet;
+			packet.axis = axis;
+			packet.mode = command.mode;
+			packet.power = command.power;
+			packet.setpoint = command.setpoint;
+			send (TELEM_COMMAND, trace.time_ms, &packet, sizeof (packet));
+			traced[axis] = command;
+		}
+	}
+
+	telem_trace packet;
+	packet.run = trace.run;
+	packet.adc = trace.adc;
+	for (uint8_t axis = 0; axis < TELEM_AXES; axis++)
+	{
+		packet.position[axis] = trace.reading[axis].position;
+		packet.velocity[axis] = trace.reading[axis].velocity;
+	}
+	send (TELEM_TRACE, trace.time_ms, &packet, sizeof (packet));
+}
@@ -0,0 +1,124 @@
+//**************************************************************************************
+/** @file task_telemetry.h
+ *    This file contains the header for a task class which streams binary telemetry
+ *    packets, described in @c telemetry.h, through a serial port.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Timing packets are followed by a task's loop profile
+ *    @li 10-17-2026 Sends the motor task's trace of each run, for host/replay
+ *    @li 10-17-2026 Port is now 500000 baud and only waits when its buffer is full
+ *    @li 10-17-2026 Log messages are sent along with the samples
+ *    @li 10-17-2026 Waiting for room in the port's buffer no longer holds up other tasks
+ *    @li 10-17-2026 Each frame goes into the port's buffer whole, so text can't split it
+ *    @li 10-17-2026 Sends TELEM_AXES axes, which has to be the number of axes
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//**************************************************************************************
+
+// This define prevents this .h file from being included multiple times in a .cpp file
+#ifndef _TASK_TELEMETRY_H_
+#define _TASK_TELEMETRY_H_
+
+#include <stdlib.h>                         // Prototype declarations for I/O functions
+#include <avr/io.h>                         // Header for special function registers
+
+#include "FreeRTOS.h"                       // Primary header for FreeRTOS
+#include "task.h"                           // Header for FreeRTOS task functions
+#include "queue.h"                          // FreeRTOS inter-task communication queues
+
+#include "taskbase.h"                       // ME405/507 base task class
+#include "taskshare.h"                      // Header for thread-safe shared data
+
+#include "rs232int.h"                       // ME405/507 library for serial comm.
+#include "serial_dr.h"                      // For sending each frame whole
+#include "telemetry.h"                      // Packet formats and framing
+#include "task_motor.h"                     // For the motor status being streamed
+#include "profiler.h"                       // For the loop profiles being streamed
+#include "log.h"                            // For the log messages being streamed
+
+
+// The packets carry one sample for each axis, and each log message has to fit in one
+#if (NUM_AXES != TELEM_AXES)
+	#error The telemetry packets carry TELEM_AXES axes; set it to NUM_AXES in telemetry.h
+#endif
+#if (2 + LOG_MAX_ARGS > TELEM_MAX_PAYLOAD)
+	#error A log message with all its arguments does not fit in a telemetry packet
+#endif
+
+
+/// How often the task runs, in milliseconds; encoder packets go out every run
+#define TELEM_PERIOD_MS     5
+
+/// Motor power packets go out every this many runs
+#define TELEM_PWM_EVERY     4
+
+/// A/D packets go out every this many runs
+#define TELEM_ADC_EVERY     10
+
+/// Timing packets go out every this many runs, each followed by the loop profile of
+/// one task; the tasks take turns
+#define TELEM_TIMING_EVERY  50
+
+/// At most this many log messages are sent in each run; the rest wait for the next
+#define TELEM_LOGS_EVERY_RUN 4
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This task streams telemetry packets while streaming is turned on.
+ *  @details Every @c TELEM_PERIOD_MS milliseconds it takes a copy of the status which
+ *           @c task_motor publishes and sends some of it, each kind of sample at its
+ *           own rate. At the rates set above, the stream is about 4.4 kB/s, under a
+ *           tenth of what the 500000 baud port can carry, which leaves plenty of
+ *           room for the user interface's text. Each frame is put in the serial
+ *           port's buffer with one call to @c Serial_dr::write_block(), so the text
+ *           which the user interface prints goes between frames, where the decoder
+ *           skips it, and never inside one. Messages logged with the @c LOG_ macros
+ *           in log.h are sent too, up to @c TELEM_LOGS_EVERY_RUN in each run; while
+ *           streaming is off they wait in the log buffer, and any which don't fit
+ *           are counted as dropped.
+ *
+ *           While the trace is on, every run of the control loop which the motor
+ *           task has put in its trace queue is sent as a @c TELEM_TRACE packet, with
+ *           a @c TELEM_COMMAND packet before it for each axis whose command has
+ *           changed. With two axes each run takes a 29 byte frame, so at 1 kHz the
+ *           trace is 29 kB/s, which fits with the rest; at 2 kHz it doesn't, the
+ *           queue fills, and some runs are left out of the trace.
+ *
+ *           The task runs at low priority, because the serial port driver makes it
+ *           wait when the transmit buffer is full; it sleeps while it waits, so the
+ *           other tasks aren't held up.
+ */
+
+class task_telemetry : public TaskBase
+{
+private:
+	// No private variables or methods for this class
+
+protected:
+	/// The serial port through which frames are sent, the same one as @c p_serial
+	Serial_dr* p_port;
+
+	/// Counts packets, so the receiver can tell when some have been lost
+	uint8_t sequence;
+
+	/// The command last sent for each axis in the trace
+	axis_command traced[TELEM_AXES];
+
+	// Frame a packet and send it through the serial port
+	void send (uint8_t type, uint16_t time_ms, const void* p_payload, uint8_t length);
+
+	// Send one traced run, and the commands which have changed before it
+	void send_trace (const motor_trace& trace, bool resend);
+
+public:
+	// This constructor creates the telemetry task
+	task_telemetry (const char*, unsigned portBASE_TYPE, size_t, Serial_dr*);
+
+	// This method is called by the RTOS once to run the task loop for ever and ever.
+	void run (void);
+};
+
+#endif // _TASK_TELEMETRY_H_
@@ -10,6 +10,19 @@
  *    @li 10-25-2012 JRR Changed to a more fully C++ version with class task_user
  *    @li 11-04-2012 JRR Modified from the data acquisition example to the test suite
  *    @li 01-04-2014 JRR Changed base class names to TaskBase, TaskShare, etc.
+ *    @li 10-17-2026 Added setpoint entry and closed-loop position/velocity modes
+ *    @li 10-17-2026 Added the 'l' command to start and stop telemetry
+ *    @li 10-17-2026 Task sleeps until a character arrives instead of polling
+ *    @li 10-17-2026 Status display includes the tasks' loop profiles
+ *    @li 10-17-2026 Motor commands go to the selected axis's share; any axis can be
+ *                   selected by letter
+ *    @li 10-17-2026 Objects are made in static memory when STATIC_ALLOCATION is set
+ *    @li 10-17-2026 Added the 'r' command, which turns the replay trace on and off
+ *    @li 10-17-2026 Added the 'k' command to look at, change and save parameters
+ *    @li 10-17-2026 Status display includes the number of log messages dropped
+ *    @li 10-17-2026 Changes to the axes are sent to the motor task's command queue
+ *    @li 10-17-2026 Added autotuning, which saves the position gains it finds
+ *    @li 10-17-2026 Added system identification, which prints what it recorded
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU
@@ -29,8 +42,12 @@
 
 #include <avr/io.h>                         // Port I/O for SFR's
 #include <avr/wdt.h>                        // Watchdog timer header
+#include <string.h>                         // For splitting parameter commands
 
 #include "task_user.h"                      // Header for this file
+#include "params.h"                         // Changeable parameters
+#include "static_alloc.h"                   // Static memory for objects made once
+#include "log.h"                            // Count of dropped log messages
 
 
 /** This constant sets how many RTOS ticks the task delays if the user's not talking.
@@ -70,10 +87,17 @@ void task_user::run (void)
 {
 	char char_in;                           // Character read from serial device
 	time_stamp a_time;                      // Holds the time so it can be displayed
-	int8_t number_entered = 0;            // Holds a number being entered by user
+	int32_t number_entered = 0;           // Holds a number being entered by user
 	bool num_sign = 0;
+	bool entering_setpoint = false;       // Number is a setpoint, not a power
 	uint8_t motor_sel = 0;
+	char param_line[USER_PARAM_LINE];     // A line typed in parameter mode
+	uint8_t param_length = 0;             // Number of characters in the line
+	uint16_t sysid_line = 0;              // Next system identification sample to print
 	
+	// This task only runs when it's woken up, so its profile has no period
+	LoopProfile* p_profile = STATIC_NEW (LoopProfile, ("UserInt"));
+
 	// Tell the user how to get into command mode (state 1), where the user interface
 	// task does interesting things such as diagnostic printouts
 	*p_serial << PMS ("Press 'h' or '?' for help") << endl;
@@ -82,6 +106,8 @@ void task_user::run (void)
 	// such loop inside the code for each task
 	for (;;)
 	{
+		p_profile->begin ();
+
 		// Run the finite state machine. The variable 'state' is kept by parent class
 		switch (state)
 		{
@@ -107,6 +133,35 @@ void task_user::run (void)
 							show_status ();
 							break;
 
+						// The 'l' command turns the binary telemetry stream on or off
+						case ('l'):
+							if (p_telemetry_on->get ())
+							{
+								p_telemetry_on->put (false);
+								*p_serial << PMS ("Telemetry off") << endl;
+							}
+							else
+							{
+								*p_serial << PMS ("Telemetry on") << endl;
+								p_telemetry_on->put (true);
+							}
+							break;
+
+						// The 'r' command turns the trace of the motor task's runs on
+						// or off; it goes out in the telemetry stream
+						case ('r'):
+							if (p_trace_on->get ())
+							{
+								p_trace_on->put (false);
+								*p_serial << PMS ("Trace off") << endl;
+							}
+							else
+							{
+								*p_serial << PMS ("Trace on") << endl;
+								p_trace_on->put (true);
+							}
+							break;
+
 						// The 'd' command has all the tasks dump their stacks
 						case ('d'):
 							print_task_stacks (p_serial);
@@ -120,6 +175,14 @@ void task_user::run (void)
 							transition_to(2);
 							break;
 
+						// The 'k' command looks at and changes the parameters
+						case ('k'):
+							*p_serial << PMS ("Parameters: name, name value, list, ")
+							          << PMS ("save, load, defaults or exit") << endl;
+							param_length = 0;
+							transition_to (6);
+							break;
+
 						// The 'h' command is a plea for help; '?' works also
 						case ('h'):
 						case ('?'):
@@ -155,6 +218,7 @@ void task_user::run (void)
 					if (char_in == 'r')//return function
 					{
 						*p_serial << PMS ("Moved to motor control home") << endl;
+						entering_setpoint = false;
 						transition_to(2);//returns to motor control home state
 					}
 					
@@ -240,7 +304,8 @@ void task_user::run (void)
 							motor_control_home_message();
 							break;
 						case('t'): //will enter state for motor select
-							*p_serial << PMS ("enter motor number (a or b):  ") << endl;
+							*p_serial << PMS ("enter motor letter (a to ")
+							          << (char)('a' + NUM_AXES - 1) << PMS ("):  ") << endl;
 							transition_to(5);//case 5 is for motor select
 							break;
 						case('s'): // transitions to motor control state
@@ -251,6 +316,14 @@ void task_user::run (void)
 						case('p'): //will shift into power set state
 							*p_serial << PMS ("enter value for motor power: ") << endl;
 							number_entered = 0;//reseting num_entered 
+							entering_setpoint = false;
+							transition_to(1);
+							break;
+						case('g'): //enter a setpoint for closed-loop control
+							*p_serial << PMS ("enter setpoint (counts or counts/s): ")
+									  << endl;
+							number_entered = 0;
+							entering_setpoint = true;
 							transition_to(1);
 							break;
 						case('r'): //goes back to original menu
@@ -272,18 +345,55 @@ void task_user::run (void)
 							break;
 						case('p')://sets motor to potentiometer mode
 							*p_serial << PMS ("Moved to initial command mode") << endl;
-							set_control(motor_sel, 0);//sets proper state for shared var
+							set_control(motor_sel, AXIS_POT);//sets proper state for shared var
 							break;
 						case('u')://sets motor to user input mode
 							*p_serial << PMS ("User input mode") << endl;
 							*p_serial << PMS ("Moved to motor control home") << endl;
-							set_control(motor_sel, 1);//sets proper state for shared var
+							set_control(motor_sel, AXIS_POWER);//sets proper state for shared var
 							transition_to(2);//move back to motor control menu
 							break;
 						case('b')://sets motor into brake 
 							*p_serial << PMS ("Brake on") << endl;
-							set_control(motor_sel, 2);//sets proper state for shared var
+							set_control(motor_sel, AXIS_BRAKE);//sets proper state for shared var
+							break;
+						case('c')://closed-loop position control to the setpoint
+							*p_serial << PMS ("Position control") << endl;
+							set_control(motor_sel, AXIS_POSITION);
+							break;
+						case('v')://closed-loop velocity control to the setpoint
+							*p_serial << PMS ("Velocity control") << endl;
+							set_control(motor_sel, AXIS_VELOCITY);
 							break;
+						case('a')://relay experiment to find position gains
+						{
+							*p_serial << PMS ("Autotuning; any key stops it") << endl;
+							tune_result running = p_tune_result->get ();
+							running.state = TUNE_RUNNING;
+							p_tune_result->put (running);
+							set_control(motor_sel, AXIS_AUTOTUNE);
+							transition_to(7);
+							break;
+						}
+						case('i')://record a PRBS or chirp for a model of the motor
+						{
+							uint32_t capture = (uint32_t)SYSID_SAMPLES
+							                * param_get (PARAM_SYSID_EVERY);
+							uint32_t period = 511UL * param_get (PARAM_SYSID_HOLD);
+							*p_serial << PMS ("System identification for ") << capture
+							          << PMS (" runs; any key stops it") << endl;
+							if (param_get (PARAM_SYSID_SIGNAL) == SYSID_PRBS
+								&& capture < period)
+							{
+								*p_serial << PMS ("Shorter than the PRBS period of ")
+								          << period << PMS (" runs; raise sysid_every")
+								          << endl;
+							}
+							p_sysid_state->put (SYSID_RUNNING);
+							set_control(motor_sel, AXIS_SYSID);
+							transition_to(8);
+							break;
+						}
 						case('r'):
 							*p_serial << PMS ("Moved to motor control home") << endl;
 							transition_to(2);
@@ -295,8 +405,18 @@ void task_user::run (void)
 				break; //end of case 3
 			case(4):    //motor power state
 				{       
+					//a setpoint can be any number; it's entered once, then back home
+					if(entering_setpoint)
+					{
+						set_setpoint(motor_sel, number_entered);
+						*p_serial << PMS ("Setpoint set") << endl;
+						number_entered = 0;
+						num_sign = 0;
+						entering_setpoint = false;
+						transition_to(2);
+					}
 					//catch for input into the power of the motor
-					if(number_entered >= -127 && number_entered <=  127)
+					else if(number_entered >= -127 && number_entered <=  127)
 					{
 						set_power(motor_sel, number_entered);//sets the user input to motor power
 						number_entered = 0;//clears input variable
@@ -318,17 +438,12 @@ void task_user::run (void)
 					char_in = p_serial->getchar ();     // the character
 					
 					//accept character to change  motor select to allow individual operation of
-					//the motors
-					if(char_in == 'a')
-					{
-						motor_sel = 0;
-						*p_serial << PMS ("First motor selected") << endl;
-						transition_to(2);
-					}
-					else if(char_in == 'b')
+					//the motors; axis 0 is 'a', axis 1 is 'b' and so on
+					if(char_in >= 'a' && char_in < 'a' + NUM_AXES)
 					{
-						motor_sel = 1;
-						*p_serial << PMS ("Second motor selected") << endl;
+						motor_sel = char_in - 'a';
+						*p_serial << PMS ("Motor ") << char_in << PMS (" selected")
+						          << endl;
 						transition_to(2);
 					}
 					else
@@ -338,6 +453,137 @@ void task_user::run (void)
 				}
 				break;
 
+			// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+			// In state 6, the user types lines which look at or change parameters;
+			// each line is acted on when Enter is pressed
+			case (6):
+				if (p_serial->check_for_char ())
+				{
+					char_in = p_serial->getchar ();
+					if (char_in == 13)
+					{
+						*p_serial << endl;
+						param_line[param_length] = '\0';
+						param_length = 0;
+						if (!param_command (param_line))
+						{
+							*p_serial << PMS ("Moved to initial command mode") << endl;
+							transition_to (0);
+						}
+					}
+					// Backspace or delete takes back a character
+					else if ((char_in == 8 || char_in == 127) && param_length > 0)
+					{
+						*p_serial << PMS ("\b \b");
+						param_length--;
+					}
+					// Escape leaves parameter mode at once
+					else if (char_in == 27)
+					{
+						*p_serial << endl << PMS ("Moved to initial command mode") << endl;
+						transition_to (0);
+					}
+					else if (char_in >= ' ' && param_length < USER_PARAM_LINE - 1)
+					{
+						*p_serial << char_in;
+						param_line[param_length++] = char_in;
+					}
+				}
+				break;
+
+			// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+			// In state 7, an axis is autotuning. The motor task publishes the result
+			// when the experiment ends; if it worked, the gains become the position
+			// control parameters and are saved. A key typed stops the experiment
+			case (7):
+				if (p_serial->check_for_char ())
+				{
+					p_serial->getchar ();
+					set_control(motor_sel, AXIS_BRAKE);
+					*p_serial << PMS ("Autotune stopped; brake on") << endl;
+					transition_to(3);
+				}
+				else
+				{
+					tune_result result = p_tune_result->get ();
+					if (result.state == TUNE_DONE)
+					{
+						*p_serial << result << endl;
+						if (param_set (PARAM_POS_KP, result.gains.k_p)
+							&& param_set (PARAM_POS_KI, result.gains.k_i)
+							&& param_set (PARAM_POS_KD, result.gains.k_d))
+						{
+							param_save ();
+							*p_serial << PMS ("Position gains saved; brake on") << endl;
+						}
+						else
+						{
+							*p_serial << PMS ("Gains out of range; not saved") << endl;
+						}
+						transition_to(3);
+					}
+					else if (result.state == TUNE_NO_OSCILLATION)
+					{
+						*p_serial << PMS ("Autotune failed: no oscillation") << endl;
+						transition_to(3);
+					}
+					else if (result.state == TUNE_RUNAWAY)
+					{
+						*p_serial << PMS ("Autotune failed: axis ran away") << endl;
+						transition_to(3);
+					}
+				}
+				break;
+
+			// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+			// In state 8, an axis is running a system identification experiment.
+			// Nothing is printed until the motor task says it has ended, so the
+			// serial port's interrupts take as little time from the loop as they can
+			case (8):
+				if (p_serial->check_for_char ())
+				{
+					p_serial->getchar ();
+					set_control(motor_sel, AXIS_BRAKE);
+					*p_serial << PMS ("System identification stopped; brake on") << endl;
+					transition_to(3);
+				}
+				else if (p_sysid_state->get () == SYSID_DONE)
+				{
+					*p_serial << PMS ("run,power,moved") << endl;
+					sysid_line = 0;
+					transition_to(9);
+				}
+				else if (p_sysid_state->get () == SYSID_BUSY)
+				{
+					*p_serial << PMS ("Another axis is using the capture buffer") << endl;
+					transition_to(3);
+				}
+				break;
+
+			// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+			// In state 9, the recorded samples are printed as CSV lines, a few at a
+			// time so the other tasks can use the serial port; each line starts with
+			// the run at which its sample began. A key typed stops it
+			case (9):
+				if (p_serial->check_for_char ())
+				{
+					p_serial->getchar ();
+					sysid_line = Sysid::get_count ();
+				}
+				for (uint8_t line = 0; line < USER_SYSID_LINES
+				     && sysid_line < Sysid::get_count (); line++, sysid_line++)
+				{
+					const sysid_sample& sample = Sysid::get_sample (sysid_line);
+					*p_serial << (uint32_t)sysid_line * Sysid::get_every () << ','
+					          << sample.power << ',' << sample.moved << endl;
+				}
+				if (sysid_line >= Sysid::get_count ())
+				{
+					*p_serial << PMS ("System identification done; brake on") << endl;
+					transition_to(3);
+				}
+				break;
+
 			// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 			// We should never get to the default state. If we do, complain and restart
 			default:
@@ -351,10 +597,28 @@ void task_user::run (void)
 		} // End switch state
 
 		runs++;                             // Increment counter for debugging
-
-		// No matter the state, wait for approximately a millisecond before we
-		// run the loop again. This gives lower priority tasks a chance to run
-		delay_ms (1);
+		p_profile->end ();
+
+		// If there's nothing to do in this state, sleep until the serial port's
+		// receive ISR or the print queue wakes us up. State 4 acts on a number that
+		// has already been entered, so it runs right away. Characters which are
+		// already waiting are handled first, so no wakeup is ever missed. While an
+		// axis is autotuning or recording, the task also wakes now and then to look
+		// for the result, and while a recording is printed it pauses between lines
+		if (state != 4 && !p_serial->check_for_char ()
+			&& !(state == 1 && p_print_ser_queue->check_for_char ()))
+		{
+			TickType_t timeout = portMAX_DELAY;
+			if (state == 7 || state == 8)
+			{
+				timeout = USER_TUNE_POLL;
+			}
+			else if (state == 9)
+			{
+				timeout = USER_SYSID_PAUSE;
+			}
+			xSemaphoreTake (user_wakeup, timeout);
+		}
 	}
 }
 
@@ -370,6 +634,9 @@ void task_user::print_help_message (void)
 	*p_serial << PMS ("  t:     Show the time right now") << endl;
 	*p_serial << PMS ("  s:     Version and setup information") << endl;
 	*p_serial << PMS ("  d:     Stack dump for tasks") << endl;
+	*p_serial << PMS ("  l:     Start or stop streaming telemetry") << endl;
+	*p_serial << PMS ("  r:     Start or stop streaming a trace for replay") << endl;
+	*p_serial << PMS ("  k:     Look at, change and save parameters") << endl;
 	*p_serial << PMS ("  n:     Enter a number (demo)") << endl;
 	*p_serial << PMS ("  Ctl-C: Reset the AVR") << endl;
 	*p_serial << PMS ("  h:     HALP!") << endl;
@@ -382,6 +649,7 @@ void task_user::motor_control_home_message (void)
 		  << PMS ("  s: state entry mode") << endl
 		  << PMS ("  t: toggle motor select") << endl
 		  << PMS ("  p: power entry") << endl
+		  << PMS ("  g: setpoint entry for closed-loop control") << endl
 		  << PMS ("  r: return to initial command mode") << endl;
 
 }
@@ -393,55 +661,132 @@ void task_user::motor_control_message (void)
 		  << PMS ("  p: potentiometer mode") << endl
 		  << PMS ("  u: user set mode") << endl
 		  << PMS ("  b: brake") << endl
+		  << PMS ("  c: closed-loop position control") << endl
+		  << PMS ("  v: closed-loop velocity control") << endl
+		  << PMS ("  a: autotune position control gains") << endl
+		  << PMS ("  i: record a PRBS or chirp to identify the motor") << endl
 		  << PMS ("  r: return") << endl
 		  << PMS ("  h: help") << endl;
 }
 
-//method to get power from shared var depending on motor select
+//method to get power from the selected axis's command
 int8_t task_user::get_power (uint8_t mtr_cntl)
 {
-	if(mtr_cntl == 0)
-	{
-		return p_motor_power->get();
-	}
-	else if (mtr_cntl == 1)
+	return p_axis_command[mtr_cntl]->get ().power;
+}
+
+//sends a command which changes one thing in the selected axis's command; the
+//motor task applies it at the start of its next run
+void task_user::send_command (uint8_t mtr_cntl, uint8_t type, int32_t val)
+{
+	motor_cmd command;
+	command.axis = mtr_cntl;
+	command.type = type;
+	command.value = val;
+	command.time = LoopProfile::now ();
+	if (!p_motor_cmd_queue->put (command))
 	{
-		return p_motor_power2->get();
+		*p_serial << PMS ("Motor command queue full") << endl;
 	}
 }
 
-//sets power of shared based on motor select
+//sets power in the selected axis's command
 void task_user::set_power (uint8_t mtr_cntl, int8_t val)
 {
-	if(mtr_cntl == 0)
-	{
-		p_motor_power->put(val);
-	}
-	else if (mtr_cntl == 1)
-	{
-		p_motor_power2->put(val);
-	}  
+	send_command (mtr_cntl, MOTOR_CMD_POWER, val);
 }
 
-//sets control value of shared vars based on motor control
+//sets the mode in the selected axis's command
 void task_user::set_control (uint8_t mtr_cntl, uint8_t val)
 {
-	if(mtr_cntl == 0)
+	send_command (mtr_cntl, MOTOR_CMD_MODE, val);
+}
+
+//sets the closed-loop setpoint in the selected axis's command
+void task_user::set_setpoint (uint8_t mtr_cntl, int32_t val)
+{
+	send_command (mtr_cntl, MOTOR_CMD_SETPOINT, val);
+}
+
+//-------------------------------------------------------------------------------------
+/** @brief   This method acts on a line typed in parameter mode.
+ *  @details The line can be one of these:
+ *           \li A parameter's name, which prints its value and range
+ *           \li A name, a space and a number, which sets the parameter
+ *           \li @c list, or nothing, which prints every parameter
+ *           \li @c save, which saves the parameters in the EEPROM
+ *           \li @c load, which loads them back from the EEPROM
+ *           \li @c defaults, which sets them all to their initial values
+ *           \li @c exit, which goes back to command mode
+ *  @param   p_line The line, which is changed as it's split into words
+ *  @return  False if the user asked to leave parameter mode, true otherwise
+ */
+
+bool task_user::param_command (char* p_line)
+{
+	// Split the line into a name and, if there's a space, a value
+	char* p_value = strchr (p_line, ' ');
+	if (p_value != NULL)
 	{
-		p_motor_state->put(val);
+		*p_value++ = '\0';
 	}
-	else if (mtr_cntl == 1)
+
+	if (*p_line == '\0' || strcmp_P (p_line, PSTR ("list")) == 0)
 	{
-		p_motor_state2->put(val);
-	}  
+		param_print_all (p_serial);
+	}
+	else if (strcmp_P (p_line, PSTR ("exit")) == 0)
+	{
+		return false;
+	}
+	else if (strcmp_P (p_line, PSTR ("save")) == 0)
+	{
+		param_save ();
+		*p_serial << PMS ("Parameters saved") << endl;
+	}
+	else if (strcmp_P (p_line, PSTR ("load")) == 0)
+	{
+		if (param_load ())
+		{
+			*p_serial << PMS ("Parameters loaded") << endl;
+		}
+		else
+		{
+			*p_serial << PMS ("No parameters saved; initial values used") << endl;
+		}
+	}
+	else if (strcmp_P (p_line, PSTR ("defaults")) == 0)
+	{
+		param_defaults ();
+		*p_serial << PMS ("Initial values set") << endl;
+	}
+	else
+	{
+		int8_t id = param_find (p_line);
+		if (id < 0)
+		{
+			*p_serial << '"' << p_line << PMS ("\": no such parameter") << endl;
+		}
+		else if (p_value != NULL && !param_set ((param_id)id, atol (p_value)))
+		{
+			*p_serial << PMS ("Out of range") << endl;
+		}
+		else
+		{
+			param_print (p_serial, (param_id)id);
+		}
+	}
+	return true;
 }
 
+
 //-------------------------------------------------------------------------------------
 /** This method displays information about the status of the system, including the
  *  following:
  *    \li The name and version of the program
  *    \li The name, status, priority, and free stack space of each task
  *    \li Processor cycles used by each task
+ *    \li Run time, lateness and missed deadlines of each task's loop
  *    \li Amount of heap space free and setting of RTOS tick timer
  */
 
@@ -464,6 +809,8 @@ void task_user::show_status (void)
 	// Have the tasks print their status; then the same for the shared data items
 	print_task_list (p_serial);
 	*p_serial << endl;
+	LoopProfile::print_all (p_serial);
+	*p_serial << PMS ("Log messages dropped: ") << log_get_dropped () << endl << endl;
 	print_all_shares (p_serial);
 }
 
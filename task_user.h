@@ -10,6 +10,12 @@
  *    @li 11-04-2012 JRR Modified from the data acquisition example to the test suite
  *    @li 01-04-2014 JRR Changed base class names to TaskBase, TaskShare, etc.
  *    @li 01/26/2016 added methods to increase users functionability with motors
+ *    @li 10-17-2026 Added setpoint entry and closed-loop position/velocity modes
+ *    @li 10-17-2026 Motor methods work on any axis's command share
+ *    @li 10-17-2026 Added parameter mode, in which lines typed change parameters
+ *    @li 10-17-2026 Motor methods send commands to the motor task's queue
+ *    @li 10-17-2026 Added the autotuning state
+ *    @li 10-17-2026 Added the system identification states
  *
  *  License:
  *    This file is copyright 2012 by JR Ridgely and released under the Lesser GNU
@@ -45,6 +51,7 @@
 #include "taskqueue.h"                      // Header of wrapper for FreeRTOS queues
 #include "textqueue.h"                      // Header for a "<<" queue class
 #include "taskshare.h"                      // Header for thread-safe shared data
+#include "profiler.h"                       // Header for the loop timing profiler
 
 #include "shares.h"                         // Global ('extern') queue declarations
 
@@ -52,6 +59,18 @@
 /// This macro defines a string that identifies the name and version of this program.
 #define PROGRAM_VERSION		PMS ("ME405 Lab 1 Unmodified Program V0.01 ")
 
+/// The longest line, including its terminating null, which can be typed to look at or
+/// change a parameter
+#define USER_PARAM_LINE     24
+
+/// How often, in RTOS ticks, the task looks for the result while an axis autotunes
+#define USER_TUNE_POLL      (configTICK_RATE_HZ / 10)
+
+/// The number of lines of a system identification capture printed each time the task
+/// runs, and the ticks it then sleeps so the serial port's buffer can drain
+#define USER_SYSID_LINES    8
+#define USER_SYSID_PAUSE    1
+
 
 //-------------------------------------------------------------------------------------
 /** This task interacts with the user for force him/her to do what he/she is told. What
@@ -76,10 +95,16 @@ protected:
 	void motor_control_message (void);
 	void motor_control_home_message (void);
 	
-	//methods for setting power and control for different motors
+	//methods for setting power and control for different motors; the motor is an
+	//axis number, from 0 to NUM_AXES - 1. The changes go to the motor task's queue
+	void send_command (uint8_t motr_cntl, uint8_t type, int32_t val);
 	int8_t get_power (uint8_t motr_cntl);
 	void set_power (uint8_t motr_cntl, int8_t val);
 	void set_control (uint8_t motr_cntl, uint8_t val);
+	void set_setpoint (uint8_t motr_cntl, int32_t val);
+
+	// This method acts on a line typed in parameter mode
+	bool param_command (char* p_line);
 
 public:
 	// This constructor creates a user interface task object
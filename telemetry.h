@@ -0,0 +1,234 @@
+//======================================================================================
+/** @file telemetry.h
+ *    This file describes the binary telemetry protocol which the AVR uses to stream
+ *    samples to a PC, and contains the framing and checking functions which both ends
+ *    use. It has no AVR dependencies other than @c util/crc16.h, for which the host
+ *    build has a stand-in, so the host decoder includes this same file.
+ *
+ *    Each packet is a header, a payload whose layout depends on the packet's type, and
+ *    a CRC-16 of the header and payload, sent low byte first. The packet is framed with
+ *    Consistent Overhead Byte Stuffing (COBS), which removes every zero byte from it at
+ *    a cost of one byte, and a zero is sent before and after it to mark where the frame
+ *    starts and ends. A receiver which starts listening in the middle of a frame, or
+ *    which gets a damaged frame, just waits for the next zero and carries on; empty
+ *    frames between two zeros are ignored. All numbers are little-endian, as they are
+ *    in the memory of both the AVR and a PC.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *    @li 10-17-2026 Added packets carrying the tasks' loop profiles
+ *    @li 10-17-2026 Added trace and command packets, from which a run can be replayed
+ *    @li 10-17-2026 Added packets carrying binary log messages
+ *    @li 10-17-2026 Packets carry TELEM_AXES axes rather than a fixed two
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//======================================================================================
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _TELEMETRY_H_
+#define _TELEMETRY_H_
+
+#include <stdint.h>                         // Fixed-size integer types
+#include <util/crc16.h>                     // CRC-CCITT update function
+
+
+/// The number of axes whose samples the encoder, power and trace packets carry. It
+/// has to match @c NUM_AXES in axis.h, which task_telemetry.h checks; it's set here
+/// because the PC's decoder is built from this file alone
+#define TELEM_AXES          2
+
+/// The largest payload any packet type carries, which is a trace packet's
+#define TELEM_MAX_PAYLOAD   (4 + 8 * TELEM_AXES)
+
+/// The size of the CRC at the end of each packet
+#define TELEM_CRC_SIZE      2
+
+/// The largest packet, before framing
+#define TELEM_MAX_PACKET    (sizeof (telem_header) + TELEM_MAX_PAYLOAD + TELEM_CRC_SIZE)
+
+/// The largest frame, not counting its delimiters: COBS adds one byte to packets
+/// shorter than 254 bytes
+#define TELEM_MAX_FRAME     (TELEM_MAX_PACKET + 1)
+
+
+/// The types of packet. Each has a payload structure below
+enum telem_type
+{
+	TELEM_ENCODER = 1,                      ///< Positions of the axes' encoders
+	TELEM_ADC = 2,                          ///< Readings of the scanned A/D channels
+	TELEM_PWM = 3,                          ///< Power commanded to the axes' motors
+	TELEM_TIMING = 4,                       ///< Run time of the motor control loop
+	TELEM_PROFILE = 5,                      ///< One task's loop profile
+	TELEM_TRACE = 6,                        ///< What one run of the control loop read
+	TELEM_COMMAND = 7,                      ///< The command one axis is following
+	TELEM_LOG = 8                           ///< A log message, from log.h
+};
+
+
+/// The header at the start of every packet
+struct telem_header
+{
+	uint8_t type;                           ///< One of the @c telem_type codes
+	uint8_t sequence;                       ///< Counts packets, so losses can be seen
+	uint16_t time_ms;                       ///< When the sample was taken, in ms
+} __attribute__ ((packed));
+
+/// The payload of a @c TELEM_ENCODER packet
+struct telem_encoder
+{
+	int32_t position[TELEM_AXES];           ///< Encoder counts
+} __attribute__ ((packed));
+
+/// The payload of a @c TELEM_ADC packet
+struct telem_adc
+{
+	uint16_t reading[2];                    ///< Raw readings of channels 0 and 1
+} __attribute__ ((packed));
+
+/// The payload of a @c TELEM_PWM packet
+struct telem_pwm
+{
+	int16_t power[TELEM_AXES];              ///< Signed power, -255 to 255
+} __attribute__ ((packed));
+
+/// The payload of a @c TELEM_TIMING packet
+struct telem_timing
+{
+	uint16_t loop_us;                       ///< Time taken by the latest control loop
+	uint16_t max_loop_us;                   ///< Longest time since streaming began
+} __attribute__ ((packed));
+
+/// The payload of a @c TELEM_PROFILE packet. The tasks' profiles are sent in turn;
+/// @c task is a profile's place in the list which the 's' command prints
+struct telem_profile
+{
+	uint8_t task;                           ///< Which profile, counting from zero
+	uint16_t cpu_permille;                  ///< Processor use, in tenths of a percent
+	uint16_t max_exec_us;                   ///< Longest run time of the task's loop
+	uint16_t max_late_us;                   ///< Latest that a run has started
+	uint16_t misses;                        ///< Runs which missed their deadlines
+} __attribute__ ((packed));
+
+/// The payload of a @c TELEM_TRACE packet, which is sent for every run of the control
+/// loop while tracing is on. With the commands from the @c TELEM_COMMAND packets it
+/// holds everything the control step was given, so host/replay can run it again. The
+/// run number shows which runs are missing; the header's time is when the run began
+struct telem_trace
+{
+	uint16_t run;                           ///< Counts runs of the control loop
+	uint16_t adc;                           ///< The potentiometer's A/D reading
+	int32_t position[TELEM_AXES];           ///< Encoder counts
+	int32_t velocity[TELEM_AXES];           ///< Encoder counts per second
+} __attribute__ ((packed));
+
+/// The payload of a @c TELEM_COMMAND packet. One is sent for an axis before the trace
+/// of a run in which its command changed, and every so often in case one was lost
+struct telem_command
+{
+	uint8_t axis;                           ///< Which axis, from 0 to TELEM_AXES - 1
+	uint8_t mode;                           ///< One of the @c axis_mode values
+	int16_t power;                          ///< Power, or braking strength when braking
+	int32_t setpoint;                       ///< Counts, or counts per second
+} __attribute__ ((packed));
+
+/// The payload of a @c TELEM_LOG packet. It's the only packet whose size varies: the
+/// arguments take as many bytes as the message's format string says they do, and
+/// the header's time is when the message was logged, not when it was sent
+struct telem_log
+{
+	uint16_t id;                            ///< The format string's address in .logstr
+	uint8_t args[TELEM_MAX_PAYLOAD - 2];    ///< The arguments, least significant first
+} __attribute__ ((packed));
+
+
+//-------------------------------------------------------------------------------------
+/** This function computes the CRC-CCITT of a block of bytes, starting from 0xFFFF.
+ *  @param p_data A pointer to the bytes
+ *  @param length The number of bytes
+ *  @return The CRC
+ */
+
+inline uint16_t telem_crc (const uint8_t* p_data, uint8_t length)
+{
+	uint16_t crc = 0xFFFF;
+	while (length--)
+	{
+		crc = _crc_ccitt_update (crc, *p_data++);
+	}
+	return crc;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function encodes a packet with COBS. Each zero byte is replaced by the
+ *  distance to the next zero, and a byte holding the distance to the first zero is put
+ *  at the front, so the result contains no zeros. The delimiter isn't added.
+ *  @param p_in The packet to be encoded
+ *  @param length The number of bytes in the packet, which must be less than 254
+ *  @param p_out Where the encoded bytes go; there must be room for length + 1 bytes
+ *  @return The number of encoded bytes
+ */
+
+inline uint8_t telem_cobs_encode (const uint8_t* p_in, uint8_t length, uint8_t* p_out)
+{
+	uint8_t code_index = 0;                 // Where the current distance byte goes
+	uint8_t out_index = 1;
+	uint8_t code = 1;                       // Distance from that byte to the next zero
+
+	for (uint8_t in_index = 0; in_index < length; in_index++)
+	{
+		if (p_in[in_index] == 0)
+		{
+			p_out[code_index] = code;
+			code_index = out_index++;
+			code = 1;
+		}
+		else
+		{
+			p_out[out_index++] = p_in[in_index];
+			code++;
+		}
+	}
+	p_out[code_index] = code;
+
+	return out_index;
+}
+
+
+//-------------------------------------------------------------------------------------
+/** This function decodes a COBS frame, without its delimiter, back into a packet.
+ *  @param p_in The encoded bytes
+ *  @param length The number of encoded bytes
+ *  @param p_out Where the decoded packet goes; there must be room for length bytes
+ *  @return The number of bytes in the packet, or zero if the frame isn't valid COBS
+ */
+
+inline uint8_t telem_cobs_decode (const uint8_t* p_in, uint8_t length, uint8_t* p_out)
+{
+	uint8_t in_index = 0;
+	uint8_t out_index = 0;
+
+	while (in_index < length)
+	{
+		uint8_t code = p_in[in_index];
+		if (code == 0 || in_index + code > length)
+		{
+			return 0;
+		}
+		in_index++;
+		for (uint8_t count = 1; count < code; count++)
+		{
+			p_out[out_index++] = p_in[in_index++];
+		}
+		if (code != 0xFF && in_index < length)
+		{
+			p_out[out_index++] = 0;
+		}
+	}
+
+	return out_index;
+}
+
+#endif // _TELEMETRY_H_
@@ -0,0 +1,65 @@
+//======================================================================================
+/** @file wakequeue.h
+ *    This file contains a text queue which gives a semaphore whenever a character is
+ *    put into it, so that the task which empties the queue can sleep until there's
+ *    something in it.
+ *
+ *  Revisions:
+ *    @li 10-17-2026 Original file
+ *
+ *  License:
+ *    This file is released under the Lesser GNU Public License, version 2. It is
+ *    intended for educational use only, but its use is not limited thereto. */
+//======================================================================================
+
+// This define prevents this .H file from being included multiple times in a .CPP file
+#ifndef _WAKEQUEUE_H_
+#define _WAKEQUEUE_H_
+
+#include "FreeRTOS.h"                       // Header for the FreeRTOS RTOS
+#include "semphr.h"                         // Header for FreeRTOS semaphores
+#include "textqueue.h"                      // Header for the text queue class
+
+
+//-------------------------------------------------------------------------------------
+/** @brief   This class is a @c TextQueue which wakes up the task that reads it.
+ *  @details Each character written into the queue is followed by a give of the
+ *           semaphore. The reading task takes the semaphore when it has nothing to
+ *           do, and the semaphore can be the same one that a serial port's receive
+ *           ISR gives, so that one task can wait for both at once.
+ */
+
+class WakeTextQueue : public TextQueue
+{
+protected:
+	/// The semaphore which is given whenever a character is put into the queue
+	SemaphoreHandle_t wake_signal;
+
+public:
+	/** This constructor creates a text queue which gives a semaphore when written.
+	 *  @param queue_size The number of characters the queue can hold
+	 *  @param p_name A name for the queue, shown in the list of shares
+	 *  @param p_ser_dev A serial device for debugging printouts
+	 *  @param wait_time How long a writer waits for room in the queue, in ticks
+	 *  @param a_signal The semaphore to give when a character is written
+	 */
+	WakeTextQueue (uint16_t queue_size, const char* p_name, emstream* p_ser_dev,
+	               TickType_t wait_time, SemaphoreHandle_t a_signal)
+		: TextQueue (queue_size, p_name, p_ser_dev, wait_time)
+	{
+		wake_signal = a_signal;
+	}
+
+	/** This method puts a character into the queue, then wakes the reading task.
+	 *  @param a_char The character to be put into the queue
+	 *  @return True if the character went into the queue, false if it was full
+	 */
+	bool putchar (char a_char)
+	{
+		bool result = TextQueue::putchar (a_char);
+		xSemaphoreGive (wake_signal);
+		return result;
+	}
+};
+
+#endif // _WAKEQUEUE_H_